@@ -0,0 +1,467 @@
+/*
+  Storage Benchmark
+
+  This example runs the storage workloads of a camera against an SD card
+  and prints one JSON line per workload, so runs on different cards,
+  clocks or library versions can be collected and compared:
+
+   save     BENCH_PHOTOS photos of JPEG sizes (10-30 KB), preallocated
+   list     enumerate the photo directory
+   open     open photos by name in random order
+   read     read every photo from start to end
+   gallery  random next / previous / jump navigation, reading each photo
+   delete   remove all photos with one SD.removeFiles() call
+   avi      append BENCH_AVI_FRAMES frames to one file, flushing each,
+            the way a time-lapse records
+   pack_save  the save photos again, back to back in one reserved
+            container file: each in 512 byte aligned regions behind a
+            32 byte header, flushed after the data and after the header
+   pack_list  walk the container's headers, one per photo
+
+  Each line holds the number of operations, bytes moved, total time,
+  throughput in KB/s, the p50, p99 and worst latency of one operation in
+  microseconds, and the card commands, blocks read and blocks written.
+  Lines starting with '#' are progress messages, so
+    grep '^{' log.txt
+  leaves only the results.
+
+  Built with SD_CARD_IMAGE (a host build), the sketch mounts the image
+  file SD_BENCH_IMAGE instead of a card. Times are then the image's
+  modeled card time, so a run gives the same numbers every time.
+
+  The circuit:
+   SD card attached to SPI bus as follows:
+ ** SDO - pin 11
+ ** SDI - pin 12
+ ** CLK - pin 13
+ ** CS - depends on your SD card shield or module.
+    Pin 10 used here for consistency with other Arduino examples
+
+  The 4 KB I/O buffer needs a board with more RAM than an Uno, e.g. an
+  ESP32.
+
+  This example code is in the public domain.
+*/
+#include <SD.h>
+#include <stdlib.h>
+
+#ifndef BENCH_PHOTOS
+#define BENCH_PHOTOS 100
+#endif
+#ifndef BENCH_GALLERY_STEPS
+#define BENCH_GALLERY_STEPS 100
+#endif
+#ifndef BENCH_AVI_FRAMES
+#define BENCH_AVI_FRAMES 100
+#endif
+// highest SPI clock SD.rampClock() may pick, zero to stay at the mount clock
+#ifndef BENCH_CLOCK_LIMIT
+#define BENCH_CLOCK_LIMIT 40000000
+#endif
+#ifndef SD_BENCH_IMAGE
+#define SD_BENCH_IMAGE "card.img"
+#endif
+
+const int chipSelect = 10;
+
+const char benchDir[] = "/bench";
+const char aviPath[] = "/bench.avi";
+const char packPath[] = "/bench.pak";
+
+// container region: header, photo, padding to the next packBlock boundary
+const uint32_t packBlock = 512;
+struct PackHeader {
+  uint32_t magic;
+  uint32_t number;  // zero for free space
+  uint32_t length;
+  uint32_t span;    // bytes to the next header
+  uint8_t reserved[16];
+};
+
+// longest workload, in operations
+const uint16_t maxOps = BENCH_PHOTOS > BENCH_GALLERY_STEPS ?
+                        (BENCH_PHOTOS > BENCH_AVI_FRAMES ? BENCH_PHOTOS : BENCH_AVI_FRAMES) :
+                        (BENCH_GALLERY_STEPS > BENCH_AVI_FRAMES ? BENCH_GALLERY_STEPS : BENCH_AVI_FRAMES);
+
+uint8_t buf[4096];
+uint32_t latency[maxOps];
+uint32_t photoSize[BENCH_PHOTOS + 1];
+
+// one workload's measurements
+struct Run {
+  const char *name;
+  uint16_t ops;
+  uint32_t bytes;
+  uint64_t startUs;
+  uint64_t opStartUs;
+  uint32_t commands;
+  uint32_t blocksRead;
+  uint32_t blocksWritten;
+};
+
+// card time: modeled on an image, the real clock on a card
+uint64_t benchMicros() {
+#ifdef SD_CARD_IMAGE
+  return SD.imageCard().imageStats().elapsedUs;
+#else
+  return micros();
+#endif
+}
+
+// repeatable pseudo random numbers, the same on every board
+uint32_t randState = 12345;
+uint32_t nextRandom(uint32_t range) {
+  randState = randState * 1103515245UL + 12345;
+  return (randState >> 8) % range;
+}
+
+void photoPath(char *path, uint16_t number) {
+  snprintf(path, 20, "%s/p%u.jpg", benchDir, number);
+}
+
+void begin(Run &run, const char *name) {
+  run.name = name;
+  run.ops = 0;
+  run.bytes = 0;
+  run.commands = SD.cardCommands();
+  run.blocksRead = SD.cardBlocksRead();
+  run.blocksWritten = SD.cardBlocksWritten();
+  run.startUs = benchMicros();
+}
+
+void opStart(Run &run) {
+  run.opStartUs = benchMicros();
+}
+
+void opEnd(Run &run, uint32_t bytes) {
+  if (run.ops < maxOps) {
+    latency[run.ops++] = benchMicros() - run.opStartUs;
+  }
+  run.bytes += bytes;
+}
+
+int compareLatency(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+void report(Run &run, bool ok) {
+  uint32_t us = benchMicros() - run.startUs;
+  qsort(latency, run.ops, sizeof(latency[0]), compareLatency);
+  uint32_t p50 = run.ops ? latency[(run.ops - 1) * 50 / 100] : 0;
+  uint32_t p99 = run.ops ? latency[(run.ops - 1) * 99 / 100] : 0;
+  uint32_t worst = run.ops ? latency[run.ops - 1] : 0;
+  uint32_t kbps = us ? (uint32_t)((uint64_t)run.bytes * 1000000 / 1024 / us) : 0;
+
+  char line[256];
+  snprintf(line, sizeof(line),
+           "{\"bench\":\"%s\",\"ok\":%s,\"ops\":%u,\"bytes\":%lu,\"us\":%lu,"
+           "\"kbps\":%lu,\"p50_us\":%lu,\"p99_us\":%lu,\"max_us\":%lu,"
+           "\"cmds\":%lu,\"blocks_read\":%lu,\"blocks_written\":%lu}",
+           run.name, ok ? "true" : "false", run.ops, (unsigned long)run.bytes,
+           (unsigned long)us, (unsigned long)kbps, (unsigned long)p50,
+           (unsigned long)p99, (unsigned long)worst,
+           (unsigned long)(SD.cardCommands() - run.commands),
+           (unsigned long)(SD.cardBlocksRead() - run.blocksRead),
+           (unsigned long)(SD.cardBlocksWritten() - run.blocksWritten));
+  Serial.println(line);
+}
+
+// read a whole file; returns the bytes read
+uint32_t readAll(const char *path) {
+  File file = SD.open(path);
+  if (!file) {
+    return 0;
+  }
+  uint32_t total = 0;
+  int n;
+  while ((n = file.read(buf, sizeof(buf))) > 0) {
+    total += n;
+  }
+  file.close();
+  return total;
+}
+
+bool benchSave() {
+  Run run;
+  bool ok = true;
+  char path[20];
+  begin(run, "save");
+  for (uint16_t i = 1; i <= BENCH_PHOTOS && ok; i++) {
+    uint32_t size = 10240 + nextRandom(20480);
+    photoPath(path, i);
+    opStart(run);
+    File file = SD.open(path, FILE_WRITE);
+    ok = file && file.preAllocate(size);
+    for (uint32_t done = 0; ok && done < size; ) {
+      uint32_t n = size - done < sizeof(buf) ? size - done : sizeof(buf);
+      ok = file.write(buf, n) == n;
+      done += n;
+    }
+    file.close();
+    opEnd(run, size);
+    photoSize[i] = size;
+  }
+  report(run, ok);
+  return ok;
+}
+
+bool benchList() {
+  Run run;
+  uint16_t count = 0;
+  begin(run, "list");
+  File dir = SD.open(benchDir);
+  if (dir) {
+    for (;;) {
+      opStart(run);
+      File entry = dir.openNextFile();
+      if (!entry) {
+        break;
+      }
+      entry.close();
+      opEnd(run, 0);
+      count++;
+    }
+    dir.close();
+  }
+  report(run, count == BENCH_PHOTOS);
+  return count == BENCH_PHOTOS;
+}
+
+bool benchOpen() {
+  Run run;
+  bool ok = true;
+  char path[20];
+  begin(run, "open");
+  for (uint16_t i = 0; i < BENCH_PHOTOS; i++) {
+    photoPath(path, 1 + nextRandom(BENCH_PHOTOS));
+    opStart(run);
+    File file = SD.open(path);
+    ok = ok && file;
+    file.close();
+    opEnd(run, 0);
+  }
+  report(run, ok);
+  return ok;
+}
+
+bool benchRead() {
+  Run run;
+  bool ok = true;
+  char path[20];
+  begin(run, "read");
+  for (uint16_t i = 1; i <= BENCH_PHOTOS; i++) {
+    photoPath(path, i);
+    opStart(run);
+    uint32_t n = readAll(path);
+    ok = ok && n == photoSize[i];
+    opEnd(run, n);
+  }
+  report(run, ok);
+  return ok;
+}
+
+bool benchGallery() {
+  Run run;
+  bool ok = true;
+  char path[20];
+  uint16_t current = 1;
+  begin(run, "gallery");
+  for (uint16_t i = 0; i < BENCH_GALLERY_STEPS; i++) {
+    // mostly next, sometimes back, now and then a jump
+    uint32_t r = nextRandom(10);
+    if (r < 6) {
+      current = current < BENCH_PHOTOS ? current + 1 : 1;
+    } else if (r < 9) {
+      current = current > 1 ? current - 1 : BENCH_PHOTOS;
+    } else {
+      current = 1 + nextRandom(BENCH_PHOTOS);
+    }
+    photoPath(path, current);
+    opStart(run);
+    uint32_t n = readAll(path);
+    ok = ok && n == photoSize[current];
+    opEnd(run, n);
+  }
+  report(run, ok);
+  return ok;
+}
+
+bool benchDelete() {
+  Run run;
+  begin(run, "delete");
+  opStart(run);
+  int32_t n = SD.removeFiles(benchDir);
+  opEnd(run, 0);
+  report(run, n == BENCH_PHOTOS);
+  return n == BENCH_PHOTOS;
+}
+
+bool benchAvi() {
+  Run run;
+  bool ok;
+  begin(run, "avi");
+  File file = SD.open(aviPath, FILE_WRITE);
+  ok = file;
+  for (uint16_t i = 0; i < BENCH_AVI_FRAMES && ok; i++) {
+    uint32_t size = (10240 + nextRandom(20480)) & ~1UL;
+    // RIFF chunk header of an MJPEG frame
+    uint8_t chunk[8] = {'0', '0', 'd', 'c'};
+    for (uint8_t k = 0; k < 4; k++) {
+      chunk[4 + k] = size >> (8 * k);
+    }
+    opStart(run);
+    ok = file.write(chunk, sizeof(chunk)) == sizeof(chunk);
+    for (uint32_t done = 0; ok && done < size; ) {
+      uint32_t n = size - done < sizeof(buf) ? size - done : sizeof(buf);
+      ok = file.write(buf, n) == n;
+      done += n;
+    }
+    file.flush();
+    opEnd(run, size + sizeof(chunk));
+  }
+  file.close();
+  report(run, ok);
+  SD.remove(aviPath);
+  return ok;
+}
+
+uint32_t packSpan(uint32_t length) {
+  return (sizeof(PackHeader) + length + packBlock - 1) & ~(packBlock - 1);
+}
+
+bool writePackHeader(File &file, uint32_t offset, uint32_t number,
+                     uint32_t length, uint32_t span) {
+  PackHeader h = {0X4B415050, number, length, span, {0}};
+  if (!file.seek(offset) || file.write((uint8_t *)&h, sizeof(h)) != sizeof(h)) {
+    return false;
+  }
+  file.flush();
+  return true;
+}
+
+bool benchPackSave(File &pack) {
+  Run run;
+  uint32_t reserve = 0;
+  for (uint16_t i = 1; i <= BENCH_PHOTOS; i++) {
+    reserve += packSpan(photoSize[i]);
+  }
+  // created once on a camera, so not timed: reserve, fill, one free region
+  bool ok = pack && pack.preAllocate(reserve);
+  for (uint32_t done = 0; ok && done < reserve; ) {
+    uint32_t n = reserve - done < sizeof(buf) ? reserve - done : sizeof(buf);
+    ok = pack.write(buf, n) == n;
+    done += n;
+  }
+  ok = ok && writePackHeader(pack, 0, 0, 0, reserve);
+
+  begin(run, "pack_save");
+  uint32_t offset = 0;
+  for (uint16_t i = 1; i <= BENCH_PHOTOS && ok; i++) {
+    uint32_t size = photoSize[i];
+    uint32_t span = packSpan(size);
+    opStart(run);
+    // free header of the rest, data, then the photo's header
+    if (reserve - offset > span) {
+      ok = writePackHeader(pack, offset + span, 0, 0, reserve - offset - span);
+    }
+    ok = ok && pack.seek(offset + sizeof(PackHeader));
+    for (uint32_t done = 0; ok && done < size; ) {
+      uint32_t n = size - done < sizeof(buf) ? size - done : sizeof(buf);
+      ok = pack.write(buf, n) == n;
+      done += n;
+    }
+    pack.flush();
+    ok = ok && writePackHeader(pack, offset, i, size, span);
+    opEnd(run, size);
+    offset += span;
+  }
+  report(run, ok);
+  return ok;
+}
+
+bool benchPackList(File &pack) {
+  Run run;
+  uint16_t count = 0;
+  bool ok = true;
+  begin(run, "pack_list");
+  for (uint32_t offset = 0; ok && offset < pack.size(); ) {
+    PackHeader h;
+    opStart(run);
+    ok = pack.seek(offset) &&
+         pack.read((uint8_t *)&h, sizeof(h)) == sizeof(h) && h.span != 0;
+    opEnd(run, 0);
+    if (ok && h.number != 0) {
+      count++;
+    }
+    offset += h.span;
+  }
+  ok = ok && count == BENCH_PHOTOS;
+  report(run, ok);
+  return ok;
+}
+
+bool benchPack() {
+  File pack = SD.open(packPath, O_READ | O_WRITE | O_CREAT);
+  bool ok = benchPackSave(pack) && benchPackList(pack);
+  pack.close();
+  SD.remove(packPath);
+  return ok;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+
+  for (uint16_t i = 0; i < sizeof(buf); i++) {
+    buf[i] = i * 7;
+  }
+
+#ifdef SD_CARD_IMAGE
+  if (!SD.beginImage(SD_BENCH_IMAGE)) {
+    Serial.println("# cannot mount " SD_BENCH_IMAGE);
+    return;
+  }
+#else
+  if (!SD.begin(chipSelect)) {
+    Serial.println("# SD card initialization failed");
+    return;
+  }
+#endif
+  if (BENCH_CLOCK_LIMIT) {
+    SD.rampClock(BENCH_CLOCK_LIMIT);
+  }
+
+  // leftovers of an interrupted run
+  if (SD.exists(benchDir)) {
+    SD.removeFiles(benchDir);
+  } else {
+    SD.mkdir(benchDir);
+  }
+  SD.remove(aviPath);
+  SD.remove(packPath);
+
+  char line[160];
+  snprintf(line, sizeof(line),
+           "{\"bench\":\"card\",\"backend\":\"%s\",\"clock_hz\":%lu,"
+           "\"high_speed\":%s,\"au_kb\":%lu,\"photos\":%u}",
+#ifdef SD_CARD_IMAGE
+           "image",
+#else
+           "spi",
+#endif
+           (unsigned long)SD.clock(), SD.highSpeed() ? "true" : "false",
+           (unsigned long)(SD.allocationUnit() / 2), BENCH_PHOTOS);
+  Serial.println(line);
+
+  bool ok = benchSave() && benchList() && benchOpen() && benchRead() &&
+            benchGallery() && benchDelete();
+  ok = benchAvi() && ok;
+  ok = benchPack() && ok;
+  SD.sync();
+  Serial.println(ok ? "# done" : "# done, with failures");
+}
+
+void loop() {
+}
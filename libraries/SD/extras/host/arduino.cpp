@@ -0,0 +1,32 @@
+// Host implementation of the stub Arduino core: wall clock timing, no pins.
+#include <Arduino.h>
+#include <SPI.h>
+#include <time.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+static uint64_t nowMicros() {
+  timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+}
+unsigned long millis(void) {
+  return nowMicros() / 1000;
+}
+unsigned long micros(void) {
+  return nowMicros();
+}
+void delay(unsigned long ms) {
+  usleep(ms * 1000);
+}
+void delayMicroseconds(unsigned int us) {
+  usleep(us);
+}
+void yield(void) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) {
+  return LOW;
+}
+void pinMode(uint8_t, uint8_t) {}
@@ -0,0 +1,7 @@
+// Runs the StorageBenchmark example once against build/card.img.
+#include "../../examples/StorageBenchmark/StorageBenchmark.ino"
+
+int main() {
+  setup();
+  return 0;
+}
@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""FAT16/FAT32 image tool for the host build of the SD library.
+
+  fat.py mkfs IMAGE MB SECTORS_PER_CLUSTER 16|32   format a partitioned image
+  fat.py check IMAGE [content]                   walk it like fsck
+  fat.py replay IMAGE LOG                        check each crash point
+
+check exits nonzero on a FAT mirror mismatch, a chain that is cross-linked
+or runs into a free cluster, a file size that disagrees with its chain,
+lost clusters or a wrong FSINFO free count.  With "content" it also
+checks that every file holds the test pattern: byte i is
+(crc32(file name) + 7 * i) & 0xFF.
+
+replay applies a write log from Sd2Card::imageWriteLog() to IMAGE one block
+at a time and checks the image after each write.  Lost clusters, a stale
+second FAT or FSINFO and a chain longer than the file are what a crash may
+leave; a chain that reaches a free, bad or shared cluster, or a file larger
+than its chain, loses data and fails.
+"""
+import struct, sys, zlib
+
+def mkfs(path, mb, spc, fat32=True, part_start=8192, serial=0x12345678):
+    total = mb * 2048
+    vol = total - part_start
+    with open(path, 'wb') as f:
+        f.truncate(total * 512)
+    img = open(path, 'r+b')
+    # MBR
+    mbr = bytearray(512)
+    mbr[446:446+16] = struct.pack('<B3sB3sII', 0, b'\0\0\0', 0x0C if fat32 else 0x06, b'\0\0\0', part_start, vol)
+    mbr[510:512] = b'\x55\xaa'
+    img.seek(0); img.write(mbr)
+    bs = bytearray(512)
+    bs[0:3] = b'\xEB\x58\x90'; bs[3:11] = b'MSWIN4.1'
+    if fat32:
+        rsv = 32
+        # compute fat size
+        fatsz = 1
+        while True:
+            clusters = (vol - rsv - 2*fatsz) // spc
+            need = (clusters + 2) * 4
+            nf = (need + 511) // 512
+            if nf <= fatsz: break
+            fatsz = nf
+        struct.pack_into('<HBHBHHBHHHII', bs, 11, 512, spc, rsv, 2, 0, 0, 0xF8, 0, 63, 255, part_start, vol)
+        struct.pack_into('<IHHIHH', bs, 36, fatsz, 0, 0, 2, 1, 6)
+        bs[64] = 0x80; bs[66] = 0x29; struct.pack_into('<I', bs, 67, serial)
+        bs[71:82] = b'NO NAME    '; bs[82:90] = b'FAT32   '
+        root_ents = 0
+    else:
+        rsv = 4; root_ents = 512
+        fatsz = 1
+        while True:
+            clusters = (vol - rsv - 2*fatsz - 32) // spc
+            need = (clusters + 2) * 2
+            nf = (need + 511)//512
+            if nf <= fatsz: break
+            fatsz = nf
+        t16 = vol if vol < 65536 else 0; t32 = 0 if vol < 65536 else vol
+        struct.pack_into('<HBHBHHBHHHII', bs, 11, 512, spc, rsv, 2, root_ents, t16, 0xF8, fatsz, 63, 255, part_start, t32)
+        bs[36] = 0x80; bs[38] = 0x29; struct.pack_into('<I', bs, 39, serial)
+        bs[43:54] = b'NO NAME    '; bs[54:62] = b'FAT16   '
+    bs[510:512] = b'\x55\xaa'
+    img.seek(part_start*512); img.write(bs)
+    data_start = rsv + 2*fatsz + (root_ents*32 + 511)//512
+    clusters = (vol - data_start) // spc
+    if fat32:
+        fsi = bytearray(512)
+        struct.pack_into('<I', fsi, 0, 0x41615252)
+        struct.pack_into('<III', fsi, 484, 0x61417272, clusters - 1, 3)
+        struct.pack_into('<I', fsi, 508, 0xAA550000)
+        img.seek((part_start+1)*512); img.write(fsi)
+        img.seek((part_start+6)*512); img.write(bs)
+    for i in range(2):
+        img.seek((part_start + rsv + i*fatsz)*512)
+        if fat32:
+            img.write(struct.pack('<III', 0x0FFFFFF8, 0x0FFFFFFF, 0x0FFFFFFF))
+        else:
+            img.write(struct.pack('<HH', 0xFFF8, 0xFFFF))
+    img.close()
+    print(f"fat{'32' if fat32 else '16'} clusters={clusters} fatsz={fatsz}")
+
+class Vol:
+    def __init__(self, path):
+        self.f = open(path, 'rb')
+        mbr = self.blk(0)
+        self.start = struct.unpack_from('<I', mbr, 454)[0]
+        bs = self.blk(self.start)
+        (bps, self.spc, self.rsv, self.nfat, self.rootents, t16, _, f16) = struct.unpack_from('<HBHBHHBH', bs, 11)
+        t32 = struct.unpack_from('<I', bs, 32)[0]
+        f32 = struct.unpack_from('<I', bs, 36)[0]
+        self.fatsz = f16 or f32
+        tot = t16 or t32
+        self.fatstart = self.start + self.rsv
+        self.rootstart = self.fatstart + self.nfat*self.fatsz
+        self.datastart = self.rootstart + (self.rootents*32+511)//512
+        self.clusters = (tot - (self.datastart - self.start)) // self.spc
+        self.fat32 = self.clusters >= 65525
+        self.rootclus = struct.unpack_from('<I', bs, 44)[0] if self.fat32 else 0
+        self.fsinfo = self.start + struct.unpack_from('<H', bs, 48)[0] if self.fat32 else 0
+    def blk(self, n):
+        self.f.seek(n*512); return self.f.read(512)
+    def fats(self):
+        out = []
+        for i in range(self.nfat):
+            self.f.seek((self.fatstart + i*self.fatsz)*512)
+            out.append(self.f.read(self.fatsz*512))
+        return out
+    def entries(self, fat):
+        if self.fat32:
+            return [x & 0x0FFFFFFF for x in struct.unpack_from('<%dI' % (self.clusters+2), fat)]
+        return list(struct.unpack_from('<%dH' % (self.clusters+2), fat))
+    def eoc(self, v):
+        return v >= (0x0FFFFFF8 if self.fat32 else 0xFFF8)
+    def cdata(self, c):
+        self.f.seek((self.datastart + (c-2)*self.spc)*512); return self.f.read(self.spc*512)
+
+def check(path, content=None):
+    """Return (errors, {path: (size, chain)}, free clusters)."""
+    v = Vol(path)
+    errs = []
+    fats = v.fats()
+    fe = v.entries(fats[0])
+    if v.nfat > 1:
+        n = (v.clusters+2)*(4 if v.fat32 else 2)
+        if fats[0][:n] != fats[1][:n]:
+            diff = sum(1 for a, b in zip(v.entries(fats[0]), v.entries(fats[1])) if a != b)
+            errs.append(f"FAT mirror differs in {diff} entries")
+    owner = {}
+    files = {}
+    def chain(c, name):
+        out = []
+        while True:
+            if c < 2 or c > v.clusters+1:
+                errs.append(f"{name}: bad cluster {c}"); break
+            if c in owner:
+                errs.append(f"{name}: cross-linked cluster {c} with {owner[c]}"); break
+            if fe[c] == 0:
+                errs.append(f"{name}: chain hits free cluster {c}"); break
+            owner[c] = name; out.append(c)
+            if v.eoc(fe[c]): break
+            c = fe[c]
+        return out
+    def walk(dirclusters, rootblocks, prefix):
+        blocks = []
+        if rootblocks is not None:
+            blocks = rootblocks
+        else:
+            for c in dirclusters:
+                blocks += [v.datastart + (c-2)*v.spc + i for i in range(v.spc)]
+        for b in blocks:
+            d = v.blk(b)
+            for i in range(16):
+                e = d[i*32:(i+1)*32]
+                if e[0] == 0: return
+                if e[0] == 0xE5 or e[11] == 0x0F or (e[11] & 0x08): continue
+                nm = e[0:8].decode('latin1').rstrip() + ('.' + e[8:11].decode('latin1').rstrip() if e[8:11].strip() else '')
+                if nm in ('.', '..'): continue
+                fc = struct.unpack_from('<H', e, 26)[0] | (struct.unpack_from('<H', e, 20)[0] << 16)
+                size = struct.unpack_from('<I', e, 28)[0]
+                full = prefix + nm
+                if e[11] & 0x10:
+                    ch = chain(fc, full)
+                    walk(ch, None, full + '/')
+                else:
+                    ch = chain(fc, full) if fc else []
+                    cb = v.spc*512
+                    need = (size + cb - 1)//cb
+                    if len(ch) != need:
+                        errs.append(f"{full}: size {size} needs {need} clusters, chain has {len(ch)}")
+                    files[full] = (size, ch)
+    if v.fat32:
+        rc = chain(v.rootclus, '/')
+        walk(rc, None, '/')
+    else:
+        walk(None, [v.rootstart + i for i in range((v.rootents*32+511)//512)], '/')
+    used = sum(1 for c in range(2, v.clusters+2) if fe[c] != 0)
+    lost = [c for c in range(2, v.clusters+2) if fe[c] != 0 and c not in owner]
+    if lost:
+        errs.append(f"{len(lost)} lost clusters (e.g. {lost[:5]})")
+    free = v.clusters - used
+    if v.fat32 and v.fsinfo:
+        fc = struct.unpack_from('<I', v.blk(v.fsinfo), 488)[0]
+        if fc != 0xFFFFFFFF and fc != free:
+            errs.append(f"FSINFO free {fc} != actual {free}")
+    if content:
+        for name, (size, ch) in files.items():
+            data = b''.join(v.cdata(c) for c in ch)[:size]
+            r = content(name, data)
+            if r: errs.append(f"{name}: {r}")
+    return errs, files, free
+
+def pattern(name, data):
+    """Check a file against the test pattern, return an error or None."""
+    seed = zlib.crc32(name.rsplit('/', 1)[-1].encode()) & 0xff
+    expect = bytes((seed + 7 * i) & 0xff for i in range(len(data)))
+    if data != expect:
+        bad = next(i for i in range(len(data)) if data[i] != expect[i])
+        return f"content mismatch at {bad}"
+    return None
+
+def replay(path, log):
+    """Return the first unsafe crash point as (write index, block, errors)."""
+    img = open(path, 'r+b')
+    raw = open(log, 'rb').read()
+    for i in range(0, len(raw), 516):
+        block = struct.unpack_from('<I', raw, i)[0]
+        img.seek(block * 512)
+        img.write(raw[i + 4:i + 516])
+        img.flush()
+        errs = [e for e in check(path)[0] if 'hits free' in e or 'cross' in e
+                or 'bad cluster' in e or 'needs' in e and
+                int(e.split('needs ')[1].split()[0]) > int(e.split('chain has ')[1])]
+        if errs:
+            return i // 516, block, errs
+    return None
+
+if __name__ == '__main__':
+    if len(sys.argv) == 6 and sys.argv[1] == 'mkfs':
+        mkfs(sys.argv[2], int(sys.argv[3]), int(sys.argv[4]), sys.argv[5] == '32')
+    elif len(sys.argv) in (3, 4) and sys.argv[1] == 'check' and \
+            sys.argv[3:] in ([], ['content']):
+        errs, files, free = check(sys.argv[2], pattern if len(sys.argv) == 4 else None)
+        print(f"files={len(files)} free={free}")
+        for e in errs[:30]:
+            print("ERR", e)
+        sys.exit(1 if errs else 0)
+    elif len(sys.argv) == 4 and sys.argv[1] == 'replay':
+        bad = replay(sys.argv[2], sys.argv[3])
+        if bad:
+            print(f"crash after write {bad[0]} (block {bad[1]}):", *bad[2][:3])
+            sys.exit(1)
+        print("every crash point is safe")
+    else:
+        sys.exit(__doc__)
@@ -0,0 +1,85 @@
+/*
+  Minimal Arduino core for host builds of the SD library against an image
+  card (SD_CARD_IMAGE).  Only what the library and its examples use.
+*/
+#ifndef Arduino_h
+#define Arduino_h
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define SS 5
+#define MOSI 23
+#define MISO 19
+#define SCK 18
+#define MSBFIRST 1
+#define SPI_MODE0 0
+#define PROGMEM
+#define F(x) x
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t mode);
+
+template<class T> T min(T a, T b) {
+  return a < b ? a : b;
+}
+template<class T> T max(T a, T b) {
+  return a > b ? a : b;
+}
+
+class String {
+  public:
+    String(const char* s = "") : s_(s ? s : "") {}
+    const char* c_str() const {
+      return s_.c_str();
+    }
+    unsigned int length() const {
+      return s_.size();
+    }
+  private:
+    std::string s_;
+};
+
+#include "Print.h"
+#include "Stream.h"
+
+/** Serial writes to stdout. */
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long) {}
+    operator bool() {
+      return true;
+    }
+    size_t write(uint8_t c) {
+      return fwrite(&c, 1, 1, stdout);
+    }
+    size_t write(const uint8_t* buf, size_t size) {
+      return fwrite(buf, 1, size, stdout);
+    }
+    int available() {
+      return 0;
+    }
+    int read() {
+      return -1;
+    }
+    int peek() {
+      return -1;
+    }
+};
+extern HardwareSerial Serial;
+#endif  // Arduino_h
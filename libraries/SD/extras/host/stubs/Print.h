@@ -0,0 +1,76 @@
+#ifndef Print_h
+#define Print_h
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size) {
+      size_t n = 0;
+      while (size--) {
+        n += write(*buf++);
+      }
+      return n;
+    }
+    size_t write(const char* str) {
+      return write(reinterpret_cast<const uint8_t*>(str), strlen(str));
+    }
+    virtual void flush() {}
+    int getWriteError() {
+      return writeError_;
+    }
+    void clearWriteError() {
+      setWriteError(0);
+    }
+    size_t print(const char* s) {
+      return write(s);
+    }
+    size_t print(char c) {
+      return write(static_cast<uint8_t>(c));
+    }
+    size_t print(long v, int = 10) {
+      return printf("%ld", v);
+    }
+    size_t print(unsigned long v, int = 10) {
+      return printf("%lu", v);
+    }
+    size_t print(int v, int base = 10) {
+      return print(static_cast<long>(v), base);
+    }
+    size_t print(unsigned int v, int base = 10) {
+      return print(static_cast<unsigned long>(v), base);
+    }
+    size_t print(double v, int digits = 2) {
+      return printf("%.*f", digits, v);
+    }
+    size_t println() {
+      return write("\r\n");
+    }
+    template<class T> size_t println(T v) {
+      size_t n = print(v);
+      return n + println();
+    }
+    size_t printf(const char* format, ...) {
+      char buf[256];
+      va_list ap;
+      va_start(ap, format);
+      int n = vsnprintf(buf, sizeof(buf), format, ap);
+      va_end(ap);
+      if (n < 0) {
+        return 0;
+      }
+      return write(reinterpret_cast<const uint8_t*>(buf),
+                   n < (int)sizeof(buf) ? n : sizeof(buf) - 1);
+    }
+  protected:
+    void setWriteError(int err = 1) {
+      writeError_ = err;
+    }
+  private:
+    int writeError_ = 0;
+};
+#endif  // Print_h
@@ -0,0 +1,23 @@
+#ifndef SPI_h
+#define SPI_h
+// The image card never touches the bus; SD.h only needs the declarations.
+#include <stdint.h>
+
+class SPISettings {
+  public:
+    SPISettings() {}
+    SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass {
+  public:
+    void begin() {}
+    void end() {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction() {}
+    uint8_t transfer(uint8_t) {
+      return 0XFF;
+    }
+};
+extern SPIClass SPI;
+#endif  // SPI_h
@@ -0,0 +1,68 @@
+// Write preallocated files into an image, read one back and print the
+// modeled card cost.  With AU_IMAGE (a volume under 64 MB with 512 byte
+// clusters), also mount that with an AU larger than the volume.
+// Usage: test_basic IMAGE [AU_IMAGE]
+#include <SD.h>
+
+static uint8_t data[40000];
+static uint8_t back[40000];
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3 || !SD.beginImage(argv[1])) {
+    printf("mount failed\n");
+    return 1;
+  }
+  for (unsigned i = 0; i < sizeof(data); i++) {
+    data[i] = i * 7;
+  }
+  SD.mkdir("/photos");
+  for (int n = 1; n <= 5; n++) {
+    char path[32];
+    snprintf(path, sizeof(path), "/photos/P%d.JPG", n);
+    File file = SD.open(path, FILE_WRITE);
+    if (!file || !file.preAllocate(sizeof(data))
+        || file.write(data, sizeof(data)) != sizeof(data)) {
+      printf("write failed: %s\n", path);
+      return 1;
+    }
+    file.close();
+  }
+  File file = SD.open("/photos/P3.JPG");
+  int n = file.read(back, 30000);
+  n += file.read(back + 30000, 10000);
+  file.close();
+  if (n != (int)sizeof(back) || memcmp(back, data, sizeof(data))) {
+    printf("read back failed: %d bytes\n", n);
+    return 1;
+  }
+  SD.end();
+  const SdImageStats& s = SD.imageCard().imageStats();
+  printf("commands %lu read %lu written %lu single %lu multiple %lu "
+         "busy %llu us elapsed %llu us\n",
+         (unsigned long)s.commands, (unsigned long)s.blocksRead,
+         (unsigned long)s.blocksWritten, (unsigned long)s.singleWrites,
+         (unsigned long)s.multipleWrites,
+         (unsigned long long)s.busyWaitUs, (unsigned long long)s.elapsedUs);
+  if (argc == 2) {
+    return 0;
+  }
+
+  // An AU larger than the volume must not be used for alignment (a large
+  // preallocation used to search for an aligned group forever)
+  SdImageTiming timing = SD_IMAGE_DEFAULT_TIMING;
+  timing.auBlocks = 131072;
+  SD.imageCard().imageTiming(timing);
+  if (!SD.beginImage(argv[2]) || SD.auAligned()) {
+    printf("64 MB AU accepted on a smaller volume\n");
+    return 1;
+  }
+  file = SD.open("/P6.JPG", FILE_WRITE);
+  if (!file || !file.preAllocate(1024L * 1024)
+      || file.write(data, sizeof(data)) != sizeof(data)) {
+    printf("write failed: /P6.JPG\n");
+    return 1;
+  }
+  file.close();
+  SD.end();
+  return 0;
+}
@@ -0,0 +1,57 @@
+// Batched second FAT writes for FAT blocks far apart: a small file near the
+// start of the volume and photos near its end are appended in turn, as the
+// catalog and photos are.  Each sync must write the mirror of each FAT
+// block it changed once, without reading the blocks in between.
+// Usage: test_fat_mirror IMAGE
+#include <SD.h>
+
+static uint8_t data[60000];
+
+static bool append(const char* path, uint32_t size) {
+  File file = SD.open(path, FILE_WRITE);
+  if (!file || file.write(data, size) != size) {
+    printf("write failed: %s\n", path);
+    return false;
+  }
+  file.close();
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2 || !SD.beginImage(argv[1])) {
+    printf("mount failed\n");
+    return 1;
+  }
+  memset(data, 0X5A, sizeof(data));
+  if (!append("/CATALOG.BIN", 512) || !SD.mkdir("/photos")) {
+    return 1;
+  }
+  char path[32];
+  for (int n = 1; n <= 400; n++) {
+    snprintf(path, sizeof(path), "/photos/P%d.JPG", n);
+    if (!append(path, sizeof(data))) {
+      return 1;
+    }
+  }
+  SD.setSyncPolicy(SD_SYNC_DEFERRED);
+  uint32_t fat = SD.fatWrites();
+  uint32_t mirror = SD.fatMirrorWrites();
+  uint32_t read = SD.cardBlocksRead();
+  for (int n = 401; n <= 405; n++) {
+    snprintf(path, sizeof(path), "/photos/P%d.JPG", n);
+    if (!append(path, 30000) || !append("/CATALOG.BIN", 4096) || !SD.sync()) {
+      return 1;
+    }
+  }
+  fat = SD.fatWrites() - fat;
+  mirror = SD.fatMirrorWrites() - mirror;
+  read = SD.cardBlocksRead() - read;
+  SD.end();
+  printf("fat writes %lu, mirror writes %lu, blocks read %lu\n",
+         (unsigned long)fat, (unsigned long)mirror, (unsigned long)read);
+  if (mirror > fat) {
+    printf("more mirror writes than FAT writes\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,112 @@
+// Allocation with the free-cluster bitmap (SD_FREE_CLUSTER_BITMAP=1, the
+// ESP32 default).  Files are created and deleted while the bitmap scan is
+// part way through the FAT, then with the bitmap complete, ending with an
+// AU aligned preallocation.  Every file holds the pattern fat.py check
+// IMAGE content expects, so a cluster handed out twice by a stale bitmap
+// bit shows up as a content mismatch or a cross-link.
+// Usage: test_free_bitmap IMAGE
+#include <SD.h>
+
+static uint8_t data[700000];
+
+// byte i of a file is (crc32(name) + 7 * i) & 0XFF, see fat.py
+static uint8_t seed(const char* name) {
+  uint32_t crc = 0XFFFFFFFF;
+  for (; *name; name++) {
+    crc ^= (uint8_t)*name;
+    for (uint8_t k = 0; k < 8; k++) {
+      crc = crc & 1 ? (crc >> 1) ^ 0XEDB88320 : crc >> 1;
+    }
+  }
+  return ~crc & 0XFF;
+}
+
+static bool writePhoto(int n, uint32_t size, uint32_t reserve = 0) {
+  char path[32];
+  snprintf(path, sizeof(path), "/photos/P%d.JPG", n);
+  uint8_t s = seed(path + 8);
+  for (uint32_t i = 0; i < size; i++) {
+    data[i] = s + 7 * i;
+  }
+  File file = SD.open(path, FILE_WRITE);
+  if (!file || (reserve && !file.preAllocate(reserve))) {
+    printf("create failed: %s\n", path);
+    return false;
+  }
+  // SdFile::write() takes at most 65535 bytes
+  for (uint32_t done = 0; done < size; done += 32768) {
+    uint32_t n = size - done < 32768 ? size - done : 32768;
+    if (file.write(data + done, n) != n) {
+      printf("write failed: %s\n", path);
+      return false;
+    }
+  }
+  file.close();
+  return true;
+}
+
+static bool removePhoto(int n) {
+  char path[32];
+  snprintf(path, sizeof(path), "/photos/P%d.JPG", n);
+  if (!SD.remove(path)) {
+    printf("remove failed: %s\n", path);
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2 || !SD.beginImage(argv[1]) || !SD.mkdir("/photos")) {
+    printf("mount failed\n");
+    return 1;
+  }
+  for (int n = 1; n <= 40; n++) {
+    if (!writePhoto(n, 20000 + n * 1000)) {
+      return 1;
+    }
+  }
+  // scan two FAT blocks, then free and allocate on both sides of the scan
+  if (SD.buildFreeBitmap(2) != 0) {
+    printf("bitmap scan finished early\n");
+    return 1;
+  }
+  if (!removePhoto(2) || !removePhoto(5) || !removePhoto(30)) {
+    return 1;
+  }
+  for (int n = 41; n <= 60; n++) {
+    if (!writePhoto(n, 9000 + n * 500)) {
+      return 1;
+    }
+  }
+  int8_t done;
+  while ((done = SD.buildFreeBitmap(4)) == 0) {
+  }
+  if (done < 0) {
+    printf("bitmap scan failed\n");
+    return 1;
+  }
+  // the bitmap now serves allocation: refill holes, then an aligned extent
+  for (int n = 20; n <= 25; n++) {
+    if (!removePhoto(n)) {
+      return 1;
+    }
+  }
+  for (int n = 61; n <= 80; n++) {
+    if (!writePhoto(n, 15000 + n * 300)) {
+      return 1;
+    }
+  }
+  uint32_t aligned = SD.alignedExtents();
+  if (!writePhoto(81, sizeof(data), 1024L * 1024)) {
+    return 1;
+  }
+  if (SD.auAligned() && SD.alignedExtents() == aligned) {
+    printf("preallocation not AU aligned\n");
+    return 1;
+  }
+  int64_t freeBytes = SD.freeBytes();
+  SD.end();
+  printf("free %lld bytes, %lu aligned extents\n", (long long)freeBytes,
+         (unsigned long)SD.alignedExtents());
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Opens through the path cache: hits, stale entries after remove, rmdir
+// and recreate, and that a write-mode open of a cached path neither syncs
+// nor writes to the card.  Usage: test_path_cache IMAGE
+#include <SD.h>
+
+static int failures = 0;
+
+#define CHECK(c) do { \
+    if (!(c)) { \
+      printf("FAIL line %d: %s\n", __LINE__, #c); \
+      failures++; \
+    } \
+  } while (0)
+
+static bool readText(const char* path, char* text, size_t size) {
+  File file = SD.open(path);
+  if (!file) {
+    return false;
+  }
+  memset(text, 0, size);
+  file.read(text, size - 1);
+  file.close();
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2 || !SD.beginImage(argv[1])) {
+    printf("mount failed\n");
+    return 1;
+  }
+  char path[40];
+  char text[8];
+  CHECK(SD.mkdir("/photos"));
+  CHECK(SD.mkdir("/a/b/c"));
+  for (int n = 1; n <= 40; n++) {
+    snprintf(path, sizeof(path), "/photos/P%d.JPG", n);
+    File file = SD.open(path, FILE_WRITE);
+    CHECK(file);
+    file.print(n);
+    file.close();
+  }
+  File file = SD.open("/a/b/c/deep.txt", FILE_WRITE);
+  CHECK(file);
+  file.print("deep");
+  file.close();
+
+  // hot paths, in any case and with or without the leading '/'
+  for (int rep = 0; rep < 50; rep++) {
+    for (int n = 35; n <= 40; n++) {
+      snprintf(path, sizeof(path), "/photos/p%d.jpg", n);
+      CHECK(SD.exists(path));
+      CHECK(readText(path, text, sizeof(text)) && atoi(text) == n);
+    }
+    CHECK(readText("a/b/c/DEEP.TXT", text, sizeof(text)) &&
+          !strcmp(text, "deep"));
+  }
+  printf("hits %lu misses %lu\n", (unsigned long)SD.pathCacheHits(),
+         (unsigned long)SD.pathCacheMisses());
+
+  // a removed file is gone even if a new file takes its entry
+  CHECK(SD.remove("/photos/P38.JPG"));
+  CHECK(!SD.exists("/photos/P38.JPG"));
+  CHECK(!SD.open("/photos/P38.JPG"));
+  file = SD.open("/photos/P99.JPG", FILE_WRITE);
+  CHECK(file);
+  file.print("99");
+  file.close();
+  CHECK(!SD.exists("/photos/P38.JPG"));
+  file = SD.open("/photos/P38.JPG", FILE_WRITE);
+  CHECK(file);
+  file.print("380");
+  file.close();
+  CHECK(readText("/photos/P38.JPG", text, sizeof(text)) &&
+        !strcmp(text, "380"));
+
+  // rmdir drops the subtree
+  CHECK(SD.remove("/a/b/c/deep.txt"));
+  CHECK(SD.rmdir("/a/b/c"));
+  CHECK(!SD.exists("/a/b/c/deep.txt"));
+  CHECK(!SD.exists("/a/b/c"));
+  CHECK(!SD.open("/a/b/c/deep.txt", FILE_WRITE));
+
+  // opening a cached path for append costs no sync and no card write
+  CHECK(SD.exists("/photos/P40.JPG"));
+  uint32_t syncs = SD.syncCount() + SD.deferredSyncCount();
+  uint32_t written = SD.cardBlocksWritten();
+  file = SD.open("/photos/P40.JPG", FILE_WRITE);
+  CHECK(file);
+  CHECK(SD.syncCount() + SD.deferredSyncCount() == syncs);
+  CHECK(SD.cardBlocksWritten() == written);
+  file.print("x");
+  file.close();
+  CHECK(readText("/photos/P40.JPG", text, sizeof(text)) &&
+        !strcmp(text, "40x"));
+
+  // O_TRUNC through a cached entry
+  file = SD.open("/photos/P40.JPG", O_WRITE | O_TRUNC);
+  CHECK(file && file.size() == 0);
+  file.close();
+  SD.end();
+  return failures != 0;
+}
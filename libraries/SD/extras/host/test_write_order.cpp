@@ -0,0 +1,73 @@
+// Crash ordering of a create in a directory that was listed right after
+// mount.  "setup IMAGE" fills /photos and deletes one file; "run IMAGE LOG"
+// remounts, lists /photos, creates a file and logs every block written.
+// fat.py replay then checks each prefix of the log for a crash that leaves
+// a chain through a free cluster.
+#include <SD.h>
+
+static uint8_t data[8000];
+
+static bool writePhoto(int n, uint32_t size) {
+  char path[32];
+  snprintf(path, sizeof(path), "/photos/P%d.JPG", n);
+  File file = SD.open(path, FILE_WRITE);
+  if (!file || file.write(data, size) != size) {
+    printf("write failed: %s\n", path);
+    return false;
+  }
+  file.close();
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3 || !SD.beginImage(argv[2])) {
+    printf("mount failed\n");
+    return 1;
+  }
+  for (unsigned i = 0; i < sizeof(data); i++) {
+    data[i] = i * 7;
+  }
+  if (!strcmp(argv[1], "setup")) {
+    SD.mkdir("/photos");
+    for (int n = 1; n <= 48; n++) {
+      if (!writePhoto(n, 3000 + n * 100)) {
+        return 1;
+      }
+    }
+    SD.remove("/photos/P20.JPG");
+    SD.end();
+    return 0;
+  }
+  FILE* log = argc == 4 ? fopen(argv[3], "wb") : NULL;
+  if (!log) {
+    printf("no log\n");
+    return 1;
+  }
+  SD.imageCard().imageWriteLog(log);
+  uint32_t written = SD.imageCard().imageStats().blocksWritten;
+  uint32_t metadata = SD.fatWrites() + SD.fatMirrorWrites() + SD.dirWrites();
+  // the directory is read with a cold cache, as the gallery does at boot
+  File dir = SD.open("/photos");
+  int count = 0;
+  for (File entry = dir.openNextFile(); entry; entry = dir.openNextFile()) {
+    entry.close();
+    count++;
+  }
+  dir.close();
+  if (count != 47 || !writePhoto(49, 3000)) {
+    printf("listed %d\n", count);
+    return 1;
+  }
+  SD.end();
+  fclose(log);
+  written = SD.imageCard().imageStats().blocksWritten - written;
+  metadata = SD.fatWrites() + SD.fatMirrorWrites() + SD.dirWrites() - metadata;
+  printf("listed %d, %lu blocks written, %lu metadata\n", count,
+         (unsigned long)written, (unsigned long)metadata);
+  // the 3000 byte file is six data blocks; everything else is metadata
+  if (written - metadata != 6) {
+    printf("data blocks %lu, expected 6\n", (unsigned long)(written - metadata));
+    return 1;
+  }
+  return 0;
+}
@@ -138,6 +138,46 @@ uint32_t File::position() {
   return _file->curPosition();
 }
 
+// location of the directory entry, for SD.openEntry()
+uint32_t File::dirBlock() {
+  if (! _file) {
+    return 0;
+  }
+  return _file->dirBlock();
+}
+
+uint8_t File::dirIndex() {
+  if (! _file) {
+    return 0;
+  }
+  return _file->dirIndex();
+}
+
+uint32_t File::firstCluster() {
+  if (! _file) {
+    return 0;
+  }
+  return _file->firstCluster();
+}
+
+// cut the file to size bytes, freeing clusters past the new end
+bool File::truncate(uint32_t size) {
+  if (! _file) {
+    return false;
+  }
+  return _file->truncate(size);
+}
+
+// reserve a contiguous extent for a new file; the unused tail is
+// released on close()
+bool File::preAllocate(uint32_t size) {
+  if (! _file) {
+    return false;
+  }
+
+  return _file->preAllocate(size);
+}
+
 uint32_t File::size() {
   if (! _file) {
     return 0;
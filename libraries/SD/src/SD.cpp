@@ -350,9 +350,10 @@ namespace SDLib {
       Return true if initialization succeeds, false otherwise.
 
     */
+    pathReset();
+    highSpeedMode = false;
     return card.init(SPI_HALF_SPEED, csPin) &&
-           volume.init(card) &&
-           root.openRoot(volume);
+           mountVolume(NULL);
   }
 
   bool SDClass::begin(uint32_t clock, uint8_t csPin) {
@@ -360,19 +361,217 @@ namespace SDLib {
       root.close();
     }
 
+    pathReset();
+    highSpeedMode = false;
+
     return card.init(SPI_HALF_SPEED, csPin) &&
            card.setSpiClock(clock) &&
-           volume.init(card) &&
-           root.openRoot(volume);
+           mountVolume(NULL);
+  }
+
+  bool SDClass::beginFast(const SDMountState &state, uint8_t csPin) {
+    if (root.isOpen()) {
+      root.close();
+    }
+
+    pathReset();
+    highSpeedMode = false;
+    return card.init(SPI_HALF_SPEED, csPin) &&
+           mountVolume(&state);
+  }
+
+  #ifdef SD_CARD_IMAGE
+  bool SDClass::beginImage(const char *imagePath, const SDMountState *state) {
+    if (root.isOpen()) {
+      root.close();
+    }
+
+    pathReset();
+    highSpeedMode = false;
+    return card.openImage(imagePath) &&
+           card.init(SPI_HALF_SPEED, SD_CHIP_SELECT_PIN) &&
+           mountVolume(state);
+  }
+  #endif
+
+  // Mount the volume on an initialised card, from state if it matches the
+  // card and volume, else by reading the MBR, boot sector and FSINFO.
+  bool SDClass::mountVolume(const SDMountState *state) {
+    uint32_t hash;
+    fastMount = state && cardHash(hash) && hash == state->cardHash &&
+                volume.init(&card, state->volume);
+    if (fastMount) {
+      return root.openRoot(volume) &&
+             alignToCard(state->volume.auBlocks);
+    }
+    return volume.init(card) &&
+           root.openRoot(volume) &&
+           alignToCard(card.allocationUnit());
+  }
+
+  // Align large allocations to the card's allocation unit. Only a speedup,
+  // so a card whose SD status can't be read still mounts.
+  bool SDClass::alignToCard(uint32_t blocks) {
+    volume.setAllocationUnit(blocks);
+    card.clearBusyStats();
+    return true;
+  }
+
+  bool SDClass::mountState(SDMountState &state) {
+    if (!root.isOpen() || !cardHash(state.cardHash)) {
+      return false;
+    }
+    volume.getState(&state.volume);
+    return true;
+  }
+
+  bool SDClass::cardHash(uint32_t &hash) {
+    cid_t cid;
+    if (!card.readCID(&cid)) {
+      return false;
+    }
+    const uint8_t *raw = (const uint8_t *)&cid;
+    hash = 2166136261UL;
+    // the register is 16 bytes, the last one its CRC
+    for (uint8_t i = 0; i < 15; i++) {
+      hash = (hash ^ raw[i]) * 16777619UL;
+    }
+    return true;
   }
 
   //call this when a card is removed. It will allow you to insert and initialise a new card.
   void SDClass::end() {
+    volume.sync();
     root.close();
+    pathReset();
+  }
+
+  // Skip the leading '/'s of a path, giving the form the path cache keys on.
+  static const char *pathKey(const char *path) {
+    while (*path == '/') {
+      path++;
+    }
+    return path;
+  }
+
+  // Open the remembered entry for the first len characters of path (as
+  // returned by pathKey), after checking that the entry still holds the
+  // path's last component. Returns false to fall back to the path walk.
+  bool SDClass::pathOpen(const char *path, uint8_t len, uint8_t mode,
+                         SdFile &file) {
+  #if SD_PATH_CACHE_SIZE
+    if (len == 0 || len >= SD_PATH_CACHE_LEN || path[len - 1] == '/') {
+      return false;
+    }
+
+    PathEntry *e = NULL;
+    for (uint8_t i = 0; i < SD_PATH_CACHE_SIZE; i++) {
+      PathEntry &c = pathCache[i];
+      if (c.path[0] && c.path[len] == 0 && !strncasecmp(c.path, path, len)) {
+        e = &c;
+        break;
+      }
+    }
+    if (e == NULL) {
+      pathMisses++;
+      return false;
+    }
+
+    // check the name in the cached directory block before opening, so a
+    // stale entry is never written or truncated; no open and close pair
+    // that would sync the cache on every create or append
+    char name[13];
+    const char *base = path + len;
+    while (base > path && base[-1] != '/') {
+      base--;
+    }
+    uint8_t baseLen = path + len - base;
+    if (!SdFile::entryName(e->dirBlock, e->dirIndex, name) ||
+        strlen(name) != baseLen || strncasecmp(name, base, baseLen)) {
+      e->path[0] = 0;
+      pathMisses++;
+      return false;
+    }
+    if (!file.open(&volume, e->dirBlock, e->dirIndex, mode)) {
+      return false;
+    }
+    e->use = ++pathUseCount;
+    pathHits++;
+    return true;
+  #else
+    return false;
+  #endif
+  }
+
+  // Remember where the entry of an open file or subdirectory is, for the
+  // first len characters of path.
+  void SDClass::pathRemember(const char *path, uint8_t len, SdFile &file) {
+  #if SD_PATH_CACHE_SIZE
+    if (len == 0 || len >= SD_PATH_CACHE_LEN || path[len - 1] == '/' ||
+        !(file.isFile() || file.isSubDir())) {
+      return;
+    }
+
+    // replace the same path if present, else the least recently used
+    PathEntry *e = &pathCache[0];
+    for (uint8_t i = 0; i < SD_PATH_CACHE_SIZE; i++) {
+      PathEntry &c = pathCache[i];
+      if (c.path[0] && c.path[len] == 0 && !strncasecmp(c.path, path, len)) {
+        e = &c;
+        break;
+      }
+      if (c.path[0] == 0 || (e->path[0] && c.use < e->use)) {
+        e = &c;
+      }
+    }
+    memcpy(e->path, path, len);
+    e->path[len] = 0;
+    e->dirBlock = file.dirBlock();
+    e->dirIndex = file.dirIndex();
+    e->use = ++pathUseCount;
+  #endif
+  }
+
+  // Drop the entry for path, and with subtree set every entry below it.
+  void SDClass::pathForget(const char *path, bool subtree) {
+  #if SD_PATH_CACHE_SIZE
+    path = pathKey(path);
+    size_t len = strlen(path);
+    while (len && path[len - 1] == '/') {
+      len--;
+    }
+    for (uint8_t i = 0; i < SD_PATH_CACHE_SIZE; i++) {
+      PathEntry &c = pathCache[i];
+      if (c.path[0] && !strncasecmp(c.path, path, len) &&
+          (c.path[len] == 0 || (subtree && c.path[len] == '/'))) {
+        c.path[0] = 0;
+      }
+    }
+  #endif
+  }
+
+  void SDClass::pathReset() {
+  #if SD_PATH_CACHE_SIZE
+    for (uint8_t i = 0; i < SD_PATH_CACHE_SIZE; i++) {
+      pathCache[i].path[0] = 0;
+    }
+    pathUseCount = 0;
+  #endif
   }
 
   // this little helper is used to traverse paths
   SdFile SDClass::getParentDir(const char *filepath, int *index) {
+    // a remembered parent directory skips the walk
+    const char *key = pathKey(filepath);
+    const char *last = strrchr(key, '/');
+    if (last != NULL && last - key < SD_PATH_CACHE_LEN) {
+      SdFile dir;
+      if (pathOpen(key, last - key, O_READ, dir)) {
+        *index = (int)(last + 1 - filepath);
+        return dir;
+      }
+    }
+
     // get parent directory
     SdFile d1;
     SdFile d2;
@@ -426,6 +625,9 @@ namespace SDLib {
     }
 
     *index = (int)(filepath - origpath);
+    if (last != NULL && last - key < SD_PATH_CACHE_LEN) {
+      pathRemember(key, last - key, *parent);
+    }
     // parent is now the parent directory of the file!
     return *parent;
   }
@@ -457,6 +659,20 @@ namespace SDLib {
 
     int pathidx = 0;
 
+    // a remembered entry for the whole path skips the search
+    const char *key = pathKey(filepath);
+    size_t keyLen = strlen(key);
+    if (keyLen < SD_PATH_CACHE_LEN) {
+      SdFile cached;
+      if (pathOpen(key, keyLen, mode, cached)) {
+        const char *base = strrchr(key, '/');
+        if ((mode & (O_APPEND | O_WRITE)) == (O_APPEND | O_WRITE)) {
+          cached.seekSet(cached.fileSize());
+        }
+        return File(cached, base ? base + 1 : key);
+      }
+    }
+
     // do the interactive search
     SdFile parentdir = getParentDir(filepath, &pathidx);
     // no more subdirs!
@@ -482,12 +698,35 @@ namespace SDLib {
     // close the parent
     parentdir.close();
 
+    if (keyLen < SD_PATH_CACHE_LEN) {
+      pathRemember(key, keyLen, file);
+    }
     if ((mode & (O_APPEND | O_WRITE)) == (O_APPEND | O_WRITE)) {
       file.seekSet(file.fileSize());
     }
     return File(file, filepath);
   }
 
+  File SDClass::openEntry(uint32_t dirBlock, uint8_t dirIndex, uint8_t mode) {
+    SdFile file;
+    dir_t p;
+    char name[13];
+
+    if (!file.open(&volume, dirBlock, dirIndex, mode)) {
+      return File();
+    }
+    if (!file.dirEntry(&p)) {
+      file.close();
+      return File();
+    }
+    SdFile::dirName(p, name);
+
+    if ((mode & (O_APPEND | O_WRITE)) == (O_APPEND | O_WRITE)) {
+      file.seekSet(file.fileSize());
+    }
+    return File(file, name);
+  }
+
 
   /*
     File SDClass::open(char *filepath, uint8_t mode) {
@@ -541,6 +780,15 @@ namespace SDLib {
        Returns true if the supplied file path exists.
 
     */
+    const char *key = pathKey(filepath);
+    size_t keyLen = strlen(key);
+    if (keyLen < SD_PATH_CACHE_LEN) {
+      SdFile cached;
+      if (pathOpen(key, keyLen, O_READ, cached)) {
+        cached.close();
+        return true;
+      }
+    }
     return walkPath(filepath, root, callback_pathExists);
   }
 
@@ -564,6 +812,7 @@ namespace SDLib {
       A rough equivalent to `mkdir -p`.
 
     */
+    pathForget(filepath, true);
     return walkPath(filepath, root, callback_makeDirPath);
   }
 
@@ -575,13 +824,174 @@ namespace SDLib {
       A rough equivalent to `rm -rf`.
 
     */
+    pathForget(filepath, true);
     return walkPath(filepath, root, callback_rmdir);
   }
 
   bool SDClass::remove(const char *filepath) {
+    pathForget(filepath, false);
     return walkPath(filepath, root, callback_remove);
   }
 
+  int32_t SDClass::removeFiles(const char *dirPath,
+                               uint8_t (*match)(const char *name, void *context),
+                               void *context) {
+    int pathidx = 0;
+    SdFile parentdir = getParentDir(dirPath, &pathidx);
+    if (!parentdir.isOpen()) {
+      return -1;
+    }
+
+    // remembered entries in the directory may be deleted
+    pathForget(dirPath, true);
+
+    uint16_t count = 0;
+    bool ok;
+    if (!dirPath[pathidx]) {
+      ok = parentdir.removeFiles(match, context, &count);
+    } else {
+      SdFile dir;
+      ok = dir.open(parentdir, dirPath + pathidx, O_READ) &&
+           dir.removeFiles(match, context, &count);
+      dir.close();
+    }
+    parentdir.close();
+    return ok ? count : -1;
+  }
+
+  int64_t SDClass::freeBytes() {
+    uint32_t freeClusters = volume.freeClusterCount();
+    if (freeClusters == FSINFO_UNKNOWN) {
+      return -1;
+    }
+    return (int64_t)freeClusters << (volume.clusterSizeShift() + 9);
+  }
+
+  int8_t SDClass::buildFreeBitmap(uint16_t maxBlocks) {
+    return volume.buildFreeBitmap(maxBlocks);
+  }
+
+  // Clocks rampClock() steps through. On the ESP32 the SPI clock is 80 MHz
+  // divided by a whole number, so these are the dividers 10 down to 2.
+  static const uint32_t rampClocks[] = {
+    8000000, 10000000, 13333333, 16000000, 20000000, 26666666, 40000000
+  };
+
+  uint32_t SDClass::rampClock(uint32_t limit, uint32_t hint) {
+    uint32_t start = card.spiClock();
+    uint32_t good = start;
+    uint32_t hash;
+    bool failed = false;
+
+    // reference fingerprint of the test blocks at the mount clock
+    if (!card.setCrcCheck(1) || !clockReads(hash)) {
+      card.setCrcCheck(0);
+      return good;
+    }
+
+    if (limit > 25000000 && !highSpeedMode) {
+      highSpeedMode = card.switchHighSpeed();
+    }
+    uint32_t max = card.maxClock();
+    if (max && max < limit) {
+      limit = max;
+    }
+
+    if (hint > good && hint <= limit && tryClock(hint, hash)) {
+      good = hint;
+    } else {
+      failed = hint > good && hint <= limit;
+      for (uint8_t i = 0; i < sizeof(rampClocks) / sizeof(rampClocks[0]); i++) {
+        uint32_t c = rampClocks[i];
+        if (c <= good) {
+          continue;
+        }
+        if (c > limit) {
+          break;
+        }
+        if (!tryClock(c, hash)) {
+          failed = true;
+          break;
+        }
+        good = c;
+      }
+    }
+
+    // back at the last good clock, make sure a failed step left the card
+    // able to read; otherwise stay at the mount clock
+    card.setSpiClock(good);
+    if (failed && good != start && !tryClock(good, hash)) {
+      good = start;
+      card.setSpiClock(good);
+    }
+    card.setCrcCheck(0);
+    return good;
+  }
+
+  uint32_t SDClass::resumeClock(uint32_t clock) {
+    uint32_t start = card.spiClock();
+    uint32_t hash;
+
+    if (clock > 25000000 && !highSpeedMode) {
+      highSpeedMode = card.switchHighSpeed();
+      if (!highSpeedMode) {
+        return 0;
+      }
+    }
+    card.setSpiClock(clock);
+    bool ok = card.setCrcCheck(1) && clockReads(hash, 1);
+    card.setCrcCheck(0);
+    if (!ok) {
+      clockErrorCount++;
+      card.setSpiClock(start);
+      return 0;
+    }
+    return clock;
+  }
+
+  // Set clock and repeat the test reads; true if they all pass their CRC
+  // check and return the data read at the mount clock.
+  bool SDClass::tryClock(uint32_t clock, uint32_t hash) {
+    uint32_t h;
+    card.setSpiClock(clock);
+    if (clockReads(h) && h == hash) {
+      return true;
+    }
+    clockErrorCount++;
+    return false;
+  }
+
+  // Test reads for rampClock() and resumeClock(), single block and
+  // multiple block, with a fingerprint (FNV-1a) of the data read.
+  bool SDClass::clockReads(uint32_t &hash, uint8_t passes) {
+    uint8_t buf[512];
+    hash = 2166136261UL;
+    for (uint8_t pass = 0; pass < passes; pass++) {
+      for (uint8_t i = 0; i <= SD_CLOCK_TEST_BLOCKS; i++) {
+        if (i == 0) {
+          if (!card.readBlock(0, buf)) {
+            return false;
+          }
+        } else {
+          if (i == 1 && !card.readStart(volume.fatStartBlock())) {
+            return false;
+          }
+          if (!card.readData(buf)) {
+            card.readStop();
+            return false;
+          }
+        }
+        for (uint16_t j = 0; j < 512; j++) {
+          hash = (hash ^ buf[j]) * 16777619UL;
+        }
+      }
+      if (!card.readStop()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
 
   // allows you to recurse into a directory
   File File::openNextFile(uint8_t mode) {
@@ -615,7 +1025,9 @@ namespace SDLib {
       //Serial.print("try to open file ");
       //Serial.println(name);
 
-      if (f.open(_file, name, mode)) {
+      // open by index - the entry just read, no name search
+      uint16_t index = _file->curPosition() / sizeof(dir_t) - 1;
+      if (f.open(_file, index, mode)) {
         //Serial.println("OK!");
         return File(f, name);
       } else {
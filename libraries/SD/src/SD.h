@@ -23,8 +23,36 @@
 #define FILE_READ O_READ
 #define FILE_WRITE (O_READ | O_WRITE | O_CREAT | O_APPEND)
 
+// Number of paths whose directory entry location SD remembers, so that
+// opening the same file again, or another file in the same directory,
+// skips the walk down the path. Zero disables the path cache.
+#ifndef SD_PATH_CACHE_SIZE
+#define SD_PATH_CACHE_SIZE 8
+#endif
+
+// Longest path, not counting the leading '/', that the path cache holds.
+#ifndef SD_PATH_CACHE_LEN
+#define SD_PATH_CACHE_LEN 32
+#endif
+
+// Test reads SD.rampClock() makes at each clock: this many blocks from
+// the start of the FAT plus block zero, repeated SD_CLOCK_TEST_PASSES times.
+#ifndef SD_CLOCK_TEST_BLOCKS
+#define SD_CLOCK_TEST_BLOCKS 8
+#endif
+#ifndef SD_CLOCK_TEST_PASSES
+#define SD_CLOCK_TEST_PASSES 4
+#endif
+
 namespace SDLib {
 
+  // What begin() reads from a card and its volume, saved by mountState()
+  // so that beginFast() can skip reading it again.
+  struct SDMountState {
+    uint32_t cardHash;     // see SDClass::cardHash()
+    SdVolumeState volume;  // layout, free space hint and allocation unit
+  };
+
   class File : public Stream {
     private:
       char _name[13]; // our name
@@ -42,7 +70,12 @@ namespace SDLib {
       virtual void flush();
       int read(void *buf, uint16_t nbyte);
       bool seek(uint32_t pos);
+      bool preAllocate(uint32_t size);
       uint32_t position();
+      uint32_t dirBlock();
+      uint8_t dirIndex();
+      uint32_t firstCluster();
+      bool truncate(uint32_t size);
       uint32_t size();
       void close();
       operator bool();
@@ -65,15 +98,77 @@ namespace SDLib {
 
       // my quick&dirty iterator, should be replaced
       SdFile getParentDir(const char *filepath, int *indx);
+
+      // Directory entry locations of recently opened paths, stored without
+      // the leading '/' and compared ignoring case like FAT names. Dropped
+      // on remove and rmdir; an entry whose name no longer matches is
+      // dropped when it is next looked up.
+      struct PathEntry {
+        char path[SD_PATH_CACHE_LEN];  // empty when unused
+        uint32_t dirBlock;
+        uint8_t dirIndex;
+        uint32_t use;                  // LRU stamp
+      };
+      #if SD_PATH_CACHE_SIZE
+      PathEntry pathCache[SD_PATH_CACHE_SIZE];
+      uint32_t pathUseCount;
+      #endif
+      uint32_t pathHits;
+      uint32_t pathMisses;
+
+      bool pathOpen(const char *path, uint8_t len, uint8_t mode, SdFile &file);
+      void pathRemember(const char *path, uint8_t len, SdFile &file);
+      void pathForget(const char *path, bool subtree);
+      void pathReset();
+
+      // Clock negotiation state, see rampClock().
+      bool highSpeedMode;
+      uint32_t clockErrorCount;
+
+      // True if the last mount used a saved SDMountState.
+      bool fastMount;
+
+      bool clockReads(uint32_t &hash, uint8_t passes = SD_CLOCK_TEST_PASSES);
+      bool tryClock(uint32_t clock, uint32_t hash);
+      bool mountVolume(const SDMountState *state);
+      bool alignToCard(uint32_t blocks);
     public:
       // This needs to be called to set up the connection to the SD card
       // before other methods are used.
       bool begin(uint8_t csPin = SD_CHIP_SELECT_PIN);
       bool begin(uint32_t clock, uint8_t csPin);
 
+      // Mount like begin(), but take the volume layout, free space hint and
+      // allocation unit from state, saved by mountState() at an earlier
+      // mount. Only the CID and the boot sector are read, to check that
+      // state belongs to this card and volume; if it does not, the card is
+      // mounted in full as by begin(). mountedFast() tells which happened.
+      bool beginFast(const SDMountState &state, uint8_t csPin = SD_CHIP_SELECT_PIN);
+
+      // Fill state for a later beginFast(). False if nothing is mounted or
+      // the CID can't be read.
+      bool mountState(SDMountState &state);
+
+      // True if the last begin call mounted from a saved state.
+      bool mountedFast() {
+        return fastMount;
+      }
+
       //call this when a card is removed. It will allow you to insert and initialise a new card.
       void end();
 
+      #ifdef SD_CARD_IMAGE
+      // Mount a raw FAT16/FAT32 image file in place of the SPI card, for
+      // host tests and benchmarks. See Sd2CardImage.cpp. With a state,
+      // mounts like beginFast().
+      bool beginImage(const char *imagePath, const SDMountState *state = NULL);
+
+      // The image card, for its timing model and statistics.
+      Sd2Card &imageCard() {
+        return card;
+      }
+      #endif
+
       // Open the specified file/directory with the supplied mode (e.g. read or
       // write, etc). Returns a File object for interacting with the file.
       // Note that currently only one file can be open at a time.
@@ -82,6 +177,12 @@ namespace SDLib {
         return open(filename.c_str(), mode);
       }
 
+      // Open a file by the location of its directory entry, as returned by
+      // File::dirBlock() and File::dirIndex() for an earlier open. Skips the
+      // path walk and directory search, so the caller must know the entry
+      // still holds the file it expects.
+      File openEntry(uint32_t dirBlock, uint8_t dirIndex, uint8_t mode = FILE_READ);
+
       // Methods to determine if the requested file path exists.
       bool exists(const char *filepath);
       bool exists(const String &filepath) {
@@ -106,6 +207,198 @@ namespace SDLib {
         return rmdir(filepath.c_str());
       }
 
+      // Delete the files in a directory whose 8.3 name (e.g. "PHOTO_12.JPG")
+      // match accepts, or all of them if match is NULL. Much faster than
+      // remove() per file: each directory and FAT block is written about
+      // once. Subdirectories are left alone. Returns the number of files
+      // deleted, or -1 if the directory could not be opened or an error
+      // stopped the delete part way.
+      int32_t removeFiles(const char *dirPath,
+                          uint8_t (*match)(const char *name, void *context) = NULL,
+                          void *context = NULL);
+
+      // Free space in bytes, or -1 if it is not known yet. Known at once on
+      // FAT32 cards with a valid FSINFO sector, otherwise after the free
+      // cluster bitmap has been built.
+      int64_t freeBytes();
+
+      // Scan up to maxBlocks FAT blocks into the free cluster bitmap.
+      // Returns 1 when the bitmap is complete, 0 if more blocks remain
+      // and -1 on error.
+      int8_t buildFreeBitmap(uint16_t maxBlocks);
+
+      // Block cache lookups served from RAM and lookups that read the card,
+      // counted since boot across FAT, directory and file data blocks.
+      uint32_t cacheHits() {
+        return SdVolume::cacheHitCount();
+      }
+      uint32_t cacheMisses() {
+        return SdVolume::cacheMissCount();
+      }
+
+      // Primary and second FAT block writes since boot. The second FAT is
+      // written once per sync or close when SD_FAT_MIRROR_BATCH is set.
+      uint32_t fatWrites() {
+        return SdVolume::fatWriteCount();
+      }
+      uint32_t fatMirrorWrites() {
+        return SdVolume::fatMirrorWriteCount();
+      }
+
+      // Blocks prefetched by sequential file reads, and how many of them a
+      // later read used. See SD_READ_AHEAD_BLOCKS.
+      uint32_t readAheadBlocks() {
+        return SdVolume::readAheadCount();
+      }
+      uint32_t readAheadHits() {
+        return SdVolume::readAheadHitCount();
+      }
+
+      // Path cache lookups that opened a remembered entry, and lookups that
+      // had to walk the path (not cached, or the entry no longer matched).
+      uint32_t pathCacheHits() {
+        return pathHits;
+      }
+      uint32_t pathCacheMisses() {
+        return pathMisses;
+      }
+
+      // Durability level: SD_SYNC_WRITE, SD_SYNC_CLOSE (default) or
+      // SD_SYNC_DEFERRED. With SD_SYNC_DEFERRED, flush() and close() leave
+      // directory entries and FAT blocks in the block cache until sync().
+      bool setSyncPolicy(uint8_t policy) {
+        return SdVolume::setSyncPolicy(policy);
+      }
+      uint8_t syncPolicy() {
+        return SdVolume::syncPolicy();
+      }
+
+      // Write everything held in the block cache. Call periodically under
+      // SD_SYNC_DEFERRED; end() calls it too.
+      bool sync() {
+        return volume.sync();
+      }
+
+      // True if the block cache holds blocks not yet on the card.
+      bool syncPending() {
+        return SdVolume::cacheDirty();
+      }
+
+      // True if the FAT32 FSINFO free count hint is out of date. File
+      // flush() and close() don't write it; sync() and end() do.
+      bool fsInfoPending() {
+        return volume.fsInfoPending();
+      }
+
+      // Metadata accounting since boot: directory and FSINFO block writes,
+      // directory entry updates, and flush() / close() calls that wrote
+      // through or were deferred. See also fatWrites().
+      uint32_t dirWrites() {
+        return SdVolume::dirWriteCount();
+      }
+      uint32_t entryUpdates() {
+        return SdVolume::entryUpdateCount();
+      }
+      uint32_t syncCount() {
+        return SdVolume::syncCount();
+      }
+      uint32_t deferredSyncCount() {
+        return SdVolume::deferredSyncCount();
+      }
+
+      // Raise the SPI clock to the fastest one that reads reliably. Switches
+      // the card to high speed mode when limit is above 25 MHz and the card
+      // has it, then steps the clock up towards limit, or the card's rated
+      // maximum if lower, until a step's CRC-checked test reads fail or
+      // return other data than at the mount clock. A nonzero hint, e.g.
+      // the clock found for this card before, is tried first. Returns the
+      // clock in use, which is the mount clock if no step passed. Call
+      // after begin().
+      uint32_t rampClock(uint32_t limit, uint32_t hint = 0);
+
+      // Go straight to a clock rampClock() found for this card before,
+      // switching to high speed mode if it needs it. Tested with one pass
+      // of CRC-checked reads instead of a ramp. Returns the clock, or zero
+      // if the card failed it and is back at the mount clock; call
+      // rampClock() then.
+      uint32_t resumeClock(uint32_t clock);
+
+      // SPI clock in use and the card's rated maximum (25 MHz, or 50 MHz in
+      // high speed mode), in Hz.
+      uint32_t clock() {
+        return card.spiClock();
+      }
+      uint32_t cardMaxClock() {
+        return card.maxClock();
+      }
+
+      // True if rampClock() switched the card to high speed mode.
+      bool highSpeed() {
+        return highSpeedMode;
+      }
+
+      // Clock steps rejected by rampClock() since boot.
+      uint32_t clockErrors() {
+        return clockErrorCount;
+      }
+
+      // The card's identification register, e.g. to remember settings per
+      // card.
+      bool cardId(cid_t *cid) {
+        return card.readCID(cid);
+      }
+
+      // A fingerprint of the card: FNV-1a of its CID without the CRC byte.
+      bool cardHash(uint32_t &hash);
+
+      // The card's allocation unit in 512 byte blocks, read from its SD
+      // status at begin(), or zero if unknown. Preallocated extents of at
+      // least SD_AU_ALIGN_MIN_BLOCKS start on an AU boundary when the
+      // volume's clusters line up with AUs (auAligned()).
+      uint32_t allocationUnit() {
+        return volume.allocationUnit();
+      }
+      bool auAligned() {
+        return volume.auAligned();
+      }
+      uint32_t alignedExtents() {
+        return volume.alignedExtentCount();
+      }
+
+      // Worst-case write latency: the longest time in microseconds the card
+      // stayed busy after a write, which is where its garbage collection
+      // shows, and the number of busy times of SD_WRITE_STALL_MICROS or
+      // more, since begin() or resetWriteLatency().
+      uint32_t writeLatencyMax() {
+        return card.busyMax();
+      }
+      uint32_t writeStalls() {
+        return card.busyStalls();
+      }
+      void resetWriteLatency() {
+        card.clearBusyStats();
+      }
+
+      // Card commands sent, and data blocks read and written, since boot
+      // (since beginImage() on an image card). For benchmarks: the
+      // difference across an operation is its card traffic.
+      uint32_t cardCommands() {
+        return card.commandCount();
+      }
+      uint32_t cardBlocksRead() {
+        return card.blockReadCount();
+      }
+      uint32_t cardBlocksWritten() {
+        return card.blockWriteCount();
+      }
+
+      // True while the card is still programming an earlier non-blocking
+      // write (see File::availableForWrite()). The next card access would
+      // wait for it.
+      bool isBusy() {
+        return card.isBusy();
+      }
+
     private:
 
       // This is used to determine the mode used to open a file
@@ -273,6 +273,39 @@ struct fat32BootSector {
   uint8_t  bootSectorSig1;
 } __attribute__((packed));
 //------------------------------------------------------------------------------
+/** Value for leadSignature of a FAT32 FSINFO sector */
+uint32_t const FSINFO_LEAD_SIG = 0X41615252;
+/** Value for structSignature of a FAT32 FSINFO sector */
+uint32_t const FSINFO_STRUCT_SIG = 0X61417272;
+/** FSINFO freeCount and nextFree value meaning not known */
+uint32_t const FSINFO_UNKNOWN = 0XFFFFFFFF;
+/**
+   \struct fat32FsInfo
+
+   \brief FSINFO sector for a FAT32 volume.
+
+   Both counts are hints only.  They may be stale and must be range
+   checked before use.
+*/
+struct fat32FsInfo {
+  /** must be 0X41615252 */
+  uint32_t leadSignature;
+  /** must be zero */
+  uint8_t  reserved1[480];
+  /** must be 0X61417272 */
+  uint32_t structSignature;
+  /** last known free cluster count, 0XFFFFFFFF if unknown */
+  uint32_t freeCount;
+  /** cluster to start looking for free clusters, 0XFFFFFFFF if unknown */
+  uint32_t nextFree;
+  /** must be zero */
+  uint8_t  reserved2[12];
+  /** must be 0X00, 0X00, 0X55, 0XAA */
+  uint8_t  tailSignature[4];
+} __attribute__((packed));
+/** Type name for fat32FsInfo */
+typedef struct fat32FsInfo fsinfo_t;
+//------------------------------------------------------------------------------
 // End Of Chain values for FAT entries
 /** FAT16 end of chain value used by Microsoft. */
 uint16_t const FAT16EOC = 0XFFFF;
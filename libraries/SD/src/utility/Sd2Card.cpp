@@ -17,6 +17,7 @@
    along with the Arduino Sd2Card Library.  If not, see
    <http://www.gnu.org/licenses/>.
 */
+#ifndef SD_CARD_IMAGE  // image file backend is in Sd2CardImage.cpp
 #define USE_SPI_LIB
 #include <Arduino.h>
 #include "Sd2Card.h"
@@ -109,6 +110,35 @@ void spiSend(uint8_t data) {
 }
 #endif  // SOFTWARE_SPI
 //------------------------------------------------------------------------------
+// CRC7 of a command, shifted left with the end bit set
+static uint8_t CRC7(const uint8_t* data, uint8_t n) {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t d = data[i];
+    for (uint8_t j = 0; j < 8; j++) {
+      crc <<= 1;
+      if ((d & 0X80) ^ (crc & 0X80)) {
+        crc ^= 0X09;
+      }
+      d <<= 1;
+    }
+  }
+  return (crc << 1) | 1;
+}
+//------------------------------------------------------------------------------
+// CRC16-CCITT of a data block
+static uint16_t CRC_CCITT(const uint8_t* data, uint16_t n) {
+  uint16_t crc = 0;
+  for (uint16_t i = 0; i < n; i++) {
+    crc = (uint8_t)(crc >> 8) | (crc << 8);
+    crc ^= data[i];
+    crc ^= (uint8_t)(crc & 0XFF) >> 4;
+    crc ^= crc << 12;
+    crc ^= (crc & 0XFF) << 5;
+  }
+  return crc;
+}
+//------------------------------------------------------------------------------
 // send command and return error code.  Return zero for OK
 uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
   // end read if in partialBlockRead mode
@@ -120,23 +150,25 @@ uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
   // wait up to 300 ms if busy
   waitNotBusy(300);
 
-  // send command
-  spiSend(cmd | 0x40);
-
-  // send argument
-  for (int8_t s = 24; s >= 0; s -= 8) {
-    spiSend(arg >> s);
+  // send command and argument
+  commands_++;
+  uint8_t buf[5];
+  buf[0] = cmd | 0x40;
+  for (uint8_t i = 0; i < 4; i++) {
+    buf[1 + i] = arg >> (24 - 8 * i);
   }
-
-  // send CRC
-  uint8_t crc = 0XFF;
-  if (cmd == CMD0) {
-    crc = 0X95;  // correct crc for CMD0 with arg 0
+  for (uint8_t i = 0; i < 5; i++) {
+    spiSend(buf[i]);
   }
-  if (cmd == CMD8) {
-    crc = 0X87;  // correct crc for CMD8 with arg 0X1AA
+
+  // send CRC, needed for CMD0, CMD8 and every command once CMD59 turns
+  // CRC checking on
+  spiSend(CRC7(buf, 5));
+
+  // skip stuff byte sent after STOP_TRANSMISSION
+  if (cmd == CMD12) {
+    spiRec();
   }
-  spiSend(crc);
 
   // wait for response
   for (uint8_t i = 0; ((status_ = spiRec()) & 0X80) && i != 0XFF; i++)
@@ -144,6 +176,35 @@ uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
   return status_;
 }
 //------------------------------------------------------------------------------
+/**
+   Allocation unit (AU) size from the SD status register.  The card
+   erases and garbage collects whole AUs, so writes that fill an AU in
+   order from its start avoid copying inside the card.
+
+   \return The AU size in 512 byte blocks, or zero if it is not known.
+*/
+uint32_t Sd2Card::allocationUnit(void) {
+  // AU_SIZE 1 to 9 is 16 KB to 4 MB, 0XA to 0XF these sizes in MB
+  static const uint8_t mb[6] = {8, 12, 16, 24, 32, 64};
+  uint8_t status[64];
+  if (!readSdStatus(status)) {
+    return 0;
+  }
+  uint8_t au = status[10] >> 4;
+  if (au == 0) {
+    return 0;
+  }
+  return au < 10 ? 16UL << au : (uint32_t)mb[au - 10] << 11;
+}
+//------------------------------------------------------------------------------
+// end of a busy time that started when a write finished sending data
+void Sd2Card::busyTimeEnd(void) {
+  if (busyStart_) {
+    busyEnd(micros() - busyStart_);
+    busyStart_ = 0;
+  }
+}
+//------------------------------------------------------------------------------
 /**
    Determine the size of an SD flash memory card.
 
@@ -255,7 +316,7 @@ uint8_t Sd2Card::eraseSingleBlockEnable(void) {
    can be determined by calling errorCode() and errorData().
 */
 uint8_t Sd2Card::init(uint8_t sckRateID, uint8_t chipSelectPin) {
-  errorCode_ = inBlock_ = partialBlockRead_ = type_ = 0;
+  errorCode_ = inBlock_ = partialBlockRead_ = type_ = crcCheck_ = 0;
   chipSelectPin_ = chipSelectPin;
   // 16-bit init start time allows over a minute
   unsigned int t0 = millis();
@@ -386,7 +447,29 @@ void Sd2Card::partialBlockRead(uint8_t value) {
    the value zero, false, is returned for failure.
 */
 uint8_t Sd2Card::readBlock(uint32_t block, uint8_t* dst) {
-  return readData(block, 0, 512, dst);
+  if (!crcCheck_) {
+    return readData(block, 0, 512, dst);
+  }
+  // whole block with its CRC, so it can be checked
+  readEnd();
+  // use address if not SDHC card
+  if (type() != SD_CARD_TYPE_SDHC) {
+    block <<= 9;
+  }
+  if (cardCommand(CMD17, block)) {
+    error(SD_CARD_ERROR_CMD17);
+    goto fail;
+  }
+  if (!waitStartBlock() || !receiveData(dst, 512)) {
+    goto fail;
+  }
+  blocksRead_++;
+  chipSelectHigh();
+  return true;
+
+fail:
+  chipSelectHigh();
+  return false;
 }
 //------------------------------------------------------------------------------
 /**
@@ -420,6 +503,7 @@ uint8_t Sd2Card::readData(uint32_t block,
     if (!waitStartBlock()) {
       goto fail;
     }
+    blocksRead_++;
     offset_ = 0;
     inBlock_ = 1;
   }
@@ -496,6 +580,109 @@ void Sd2Card::readEnd(void) {
   }
 }
 //------------------------------------------------------------------------------
+/** Read one data block in a multiple block read sequence
+
+   \param[out] dst Pointer to the location for the 512 byte block.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readData(uint8_t* dst) {
+  if (!waitStartBlock() || !receiveData(dst, 512)) {
+    return false;
+  }
+  blocksRead_++;
+  return true;
+}
+//------------------------------------------------------------------------------
+/** Start a read multiple blocks sequence.
+
+   \param[in] blockNumber Address of first block in sequence.
+
+   \note This function is used with readData() and readStop()
+   for optimized multiple block reads.  SPI chip select is low
+   until readStop() is called.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readStart(uint32_t blockNumber) {
+  // use address if not SDHC card
+  if (type() != SD_CARD_TYPE_SDHC) {
+    blockNumber <<= 9;
+  }
+  if (cardCommand(CMD18, blockNumber)) {
+    error(SD_CARD_ERROR_CMD18);
+    chipSelectHigh();
+    return false;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+/** End a read multiple blocks sequence.
+
+  \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readStop(void) {
+  if (cardCommand(CMD12, 0)) {
+    error(SD_CARD_ERROR_CMD12);
+    chipSelectHigh();
+    return false;
+  }
+  chipSelectHigh();
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Maximum SPI clock of the card, from the TRAN_SPEED field of its CSD:
+   25 MHz for most cards in default mode, 50 MHz after switchHighSpeed().
+
+   \return The clock in Hz or zero if the CSD could not be read.
+*/
+uint32_t Sd2Card::maxClock(void) {
+  // TRAN_SPEED time value, times ten
+  static const uint8_t mult[16] = {
+    0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80
+  };
+  csd_t csd;
+  if (!readCSD(&csd)) {
+    return 0;
+  }
+  // rate unit 100 kbit/s, 1, 10 or 100 Mbit/s; divided by ten for mult
+  uint32_t unit = 10000;
+  for (uint8_t i = csd.v1.tran_speed & 7; i > 0 && i < 4; i--) {
+    unit *= 10;
+  }
+  return unit * mult[(csd.v1.tran_speed >> 3) & 0XF];
+}
+//------------------------------------------------------------------------------
+/**
+   Read the 64 byte SD status register (ACMD13), which holds the bus
+   width, speed class and allocation unit size.
+
+   \param[out] status The SD status.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readSdStatus(uint8_t* status) {
+  // R2 response, R1 then a second status byte
+  if (cardAcmd(ACMD13, 0) || spiRec()) {
+    error(SD_CARD_ERROR_ACMD13);
+    goto fail;
+  }
+  if (!waitStartBlock() || !receiveData(status, 64)) {
+    goto fail;
+  }
+  chipSelectHigh();
+  return true;
+
+fail:
+  chipSelectHigh();
+  return false;
+}
+//------------------------------------------------------------------------------
 /** read CID or CSR register */
 uint8_t Sd2Card::readRegister(uint8_t cmd, void* buf) {
   uint8_t* dst = reinterpret_cast<uint8_t*>(buf);
@@ -503,15 +690,9 @@ uint8_t Sd2Card::readRegister(uint8_t cmd, void* buf) {
     error(SD_CARD_ERROR_READ_REG);
     goto fail;
   }
-  if (!waitStartBlock()) {
+  if (!waitStartBlock() || !receiveData(dst, 16)) {
     goto fail;
   }
-  // transfer data
-  for (uint16_t i = 0; i < 16; i++) {
-    dst[i] = spiRec();
-  }
-  spiRec();  // get first crc byte
-  spiRec();  // get second crc byte
   chipSelectHigh();
   return true;
 
@@ -520,6 +701,43 @@ fail:
   return false;
 }
 //------------------------------------------------------------------------------
+// receive count data bytes and their CRC, checking it if CRC is on
+uint8_t Sd2Card::receiveData(uint8_t* dst, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    dst[i] = spiRec();
+  }
+  uint16_t crc = spiRec() << 8;
+  crc |= spiRec();
+  if (crcCheck_ && crc != CRC_CCITT(dst, count)) {
+    error(SD_CARD_ERROR_READ_CRC);
+    return false;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Turn CRC checking on or off, on the card (CMD59) and for data read from
+   it.  With CRC on, a read whose data is damaged on the bus fails with
+   SD_CARD_ERROR_READ_CRC instead of returning the damaged data, and the
+   card rejects damaged commands and writes.  Costs a CRC over each block
+   read or written.
+
+   \param[in] enable The value TRUE (non-zero) or FALSE (zero).
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::setCrcCheck(uint8_t enable) {
+  if (cardCommand(CMD59, enable ? 1 : 0)) {
+    error(SD_CARD_ERROR_CMD59);
+    chipSelectHigh();
+    return false;
+  }
+  chipSelectHigh();
+  crcCheck_ = enable ? 1 : 0;
+  return true;
+}
+//------------------------------------------------------------------------------
 /**
    Set the SPI clock rate.
 
@@ -549,14 +767,15 @@ uint8_t Sd2Card::setSckRate(uint8_t sckRateID) {
           | (sckRateID & 2 ? (1 << SPR0) : 0);
   #else // USE_SPI_LIB
   switch (sckRateID) {
-    case 0:  settings = SPISettings(25000000, MSBFIRST, SPI_MODE0); break;
-    case 1:  settings = SPISettings(4000000, MSBFIRST, SPI_MODE0); break;
-    case 2:  settings = SPISettings(2000000, MSBFIRST, SPI_MODE0); break;
-    case 3:  settings = SPISettings(1000000, MSBFIRST, SPI_MODE0); break;
-    case 4:  settings = SPISettings(500000, MSBFIRST, SPI_MODE0); break;
-    case 5:  settings = SPISettings(250000, MSBFIRST, SPI_MODE0); break;
-    default: settings = SPISettings(125000, MSBFIRST, SPI_MODE0);
+    case 0:  clock_ = 25000000; break;
+    case 1:  clock_ = 4000000; break;
+    case 2:  clock_ = 2000000; break;
+    case 3:  clock_ = 1000000; break;
+    case 4:  clock_ = 500000; break;
+    case 5:  clock_ = 250000; break;
+    default: clock_ = 125000;
   }
+  settings = SPISettings(clock_, MSBFIRST, SPI_MODE0);
   #endif // USE_SPI_LIB
   return true;
 }
@@ -564,19 +783,81 @@ uint8_t Sd2Card::setSckRate(uint8_t sckRateID) {
 //------------------------------------------------------------------------------
 // set the SPI clock frequency
 uint8_t Sd2Card::setSpiClock(uint32_t clock) {
+  clock_ = clock;
   settings = SPISettings(clock, MSBFIRST, SPI_MODE0);
   return true;
 }
 #endif
 //------------------------------------------------------------------------------
+/**
+   Check or switch card functions with CMD6 (SD 1.10 and later).
+
+   \param[in] arg Mode in bit 31 (0 check, 1 switch) and one function
+   number per group in bits 23:0, 0XF to leave a group unchanged.
+   \param[out] status The 64 byte switch function status.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::switchFunction(uint32_t arg, uint8_t* status) {
+  if (cardCommand(CMD6, arg)) {
+    error(SD_CARD_ERROR_CMD6);
+    goto fail;
+  }
+  if (!waitStartBlock() || !receiveData(status, 64)) {
+    goto fail;
+  }
+  chipSelectHigh();
+  return true;
+
+fail:
+  chipSelectHigh();
+  return false;
+}
+//------------------------------------------------------------------------------
+/**
+   Switch the card to high speed mode, which raises its maximum clock from
+   25 MHz to 50 MHz (see maxClock()).  Cards older than SD 1.10, and cards
+   without high speed mode, stay in default mode.  The switch lasts until
+   the card is powered off or initialized again.
+
+   \return The value one, true, is returned if the card is in high speed
+   mode and the value zero, false, if it is not.
+*/
+uint8_t Sd2Card::switchHighSpeed(void) {
+  csd_t csd;
+  uint8_t status[64];
+  // CMD6 is in command class 10
+  if (!readCSD(&csd) || !(csd.v1.ccc_high & 0X40)) {
+    return false;
+  }
+  // check high speed is function 1 of group 1, then select it
+  if (!switchFunction(0X00FFFFF1, status) || !(status[13] & 2)) {
+    return false;
+  }
+  return switchFunction(0X80FFFFF1, status) && (status[16] & 0XF) == 1;
+}
+//------------------------------------------------------------------------------
 // wait for card to go not busy
 uint8_t Sd2Card::waitNotBusy(unsigned int timeoutMillis) {
   unsigned int t0 = millis();
   unsigned int d;
+  #if SD_BUSY_YIELD
+  uint32_t spinStart = micros();
+  #endif  // SD_BUSY_YIELD
   do {
     if (spiRec() == 0XFF) {
+      busyTimeEnd();
       return true;
     }
+    #if SD_BUSY_YIELD
+    if ((uint32_t)(micros() - spinStart) >= SD_BUSY_SPIN_MICROS) {
+      // the card keeps programming while deselected - free the bus
+      chipSelectHigh();
+      yield();
+      chipSelectLow();
+    }
+    #endif  // SD_BUSY_YIELD
     d = millis() - t0;
   } while (d < timeoutMillis);
   return false;
@@ -690,8 +971,10 @@ uint8_t Sd2Card::writeData(uint8_t token, const uint8_t* src) {
     spiSend(src[i]);
   }
   #endif  // OPTIMIZE_HARDWARE_SPI
-  spiSend(0xff);  // dummy crc
-  spiSend(0xff);  // dummy crc
+  // dummy crc unless the card checks it
+  uint16_t crc = crcCheck_ ? CRC_CCITT(src, 512) : 0XFFFF;
+  spiSend(crc >> 8);
+  spiSend(crc & 0XFF);
 
   status_ = spiRec();
   if ((status_ & DATA_RES_MASK) != DATA_RES_ACCEPTED) {
@@ -699,6 +982,9 @@ uint8_t Sd2Card::writeData(uint8_t token, const uint8_t* src) {
     chipSelectHigh();
     return false;
   }
+  blocksWritten_++;
+  // card programs the block now; zero means no busy time is open
+  busyStart_ = micros() | 1;
   return true;
 }
 //------------------------------------------------------------------------------
@@ -743,15 +1029,23 @@ fail:
 //------------------------------------------------------------------------------
 /** End a write multiple blocks sequence.
 
+  \param[in] blocking If the stop should wait for programming to complete.
+  A non-blocking stop returns as soon as the stop token is sent; the next
+  command, or isBusy(), waits for or reports the remaining busy time.
+
+  Also ends a sequence after a failed writeData(), which deselects the card.
+
   \return The value one, true, is returned for success and
    the value zero, false, is returned for failure.
 */
-uint8_t Sd2Card::writeStop(void) {
+uint8_t Sd2Card::writeStop(uint8_t blocking) {
+  chipSelectLow();
   if (!waitNotBusy(SD_WRITE_TIMEOUT)) {
     goto fail;
   }
   spiSend(STOP_TRAN_TOKEN);
-  if (!waitNotBusy(SD_WRITE_TIMEOUT)) {
+  busyStart_ = micros() | 1;
+  if (blocking && !waitNotBusy(SD_WRITE_TIMEOUT)) {
     goto fail;
   }
   chipSelectHigh();
@@ -773,5 +1067,9 @@ uint8_t Sd2Card::isBusy(void) {
   byte b = spiRec();
   chipSelectHigh();
 
+  if (b == 0XFF) {
+    busyTimeEnd();
+  }
   return (b != 0XFF);
 }
+#endif  // SD_CARD_IMAGE
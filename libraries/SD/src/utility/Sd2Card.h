@@ -114,6 +114,89 @@ unsigned int const SD_ERASE_TIMEOUT = 10000;
 unsigned int const SD_READ_TIMEOUT = 300;
 /** write time out ms */
 unsigned int const SD_WRITE_TIMEOUT = 600;
+/**
+   SD_BUSY_YIELD: once the card has been busy programming for longer than
+   SD_BUSY_SPIN_MICROS, waitNotBusy() deselects it and yields between polls.
+   Other devices on the SPI bus and other tasks run during the wait instead
+   of the bus being held while the CPU spins.  Requires the SPI library.
+*/
+#if defined(ESP32) && defined(USE_SPI_LIB) && !defined(SD_CARD_IMAGE)
+#define SD_BUSY_YIELD 1
+#else
+#define SD_BUSY_YIELD 0
+#endif
+/** busy time spun before waitNotBusy() starts to yield */
+unsigned int const SD_BUSY_SPIN_MICROS = 200;
+/** busy time after a write that Sd2Card::busyStalls() counts as a stall */
+uint32_t const SD_WRITE_STALL_MICROS = 20000;
+#ifdef SD_CARD_IMAGE
+//------------------------------------------------------------------------------
+/**
+   SD_CARD_IMAGE: defined in the build flags, replaces the SPI driver with a
+   card that serves a raw FAT16/FAT32 image file (Sd2CardImage.cpp).  Card
+   operations are charged to a modeled clock using SdImageTiming so FAT
+   and file performance can be measured and compared on a host.
+   extras/host/Makefile builds the library this way with a stub core.
+*/
+#include <stdio.h>
+/**
+   \struct SdImageTiming
+   \brief Modeled cost of card operations in microseconds.
+*/
+struct SdImageTiming {
+  /** command, response and access time to the first data byte */
+  uint32_t commandUs;
+  /** one 512 byte block and its CRC on the bus */
+  uint32_t transferUs;
+  /** programming after a single block write (CMD24) */
+  uint32_t busySingleUs;
+  /** programming per block of a multiple block write (CMD25) */
+  uint32_t busyMultipleUs;
+  /** one status poll by isBusy() */
+  uint32_t pollUs;
+  /** if nonzero, also delay the caller by the modeled time */
+  uint8_t realTime;
+  /** reads at SPI clocks above this are corrupted, zero for never */
+  uint32_t errorClock;
+  /** allocation unit in blocks, reported in the SD status; AUs past the
+      first are garbage collected as below, zero for no model */
+  uint32_t auBlocks;
+  /** AUs the card writes at once, up to SD_IMAGE_MAX_OPEN_AUS */
+  uint8_t openAus;
+  /** busy time per block copied when the card merges a part written AU */
+  uint32_t gcBlockUs;
+};
+/** Most AUs the image card model keeps open */
+uint8_t const SD_IMAGE_MAX_OPEN_AUS = 4;
+/** Default timing, roughly a class 10 card on a 20 MHz SPI bus */
+SdImageTiming const SD_IMAGE_DEFAULT_TIMING = {
+  100, 220, 800, 120, 2, 0, 0, 8192, 2, 15
+};
+/**
+   \struct SdImageStats
+   \brief Operation counts and modeled time of an image card.
+*/
+struct SdImageStats {
+  /** commands sent, including the ones inside multiple block transfers */
+  uint32_t commands;
+  /** blocks read */
+  uint32_t blocksRead;
+  /** blocks written */
+  uint32_t blocksWritten;
+  /** CMD24 single block writes */
+  uint32_t singleWrites;
+  /** CMD25 multiple block writes */
+  uint32_t multipleWrites;
+  /** modeled time spent waiting for the card to finish programming */
+  uint64_t busyWaitUs;
+  /** modeled garbage collection, part of the busy time after writes */
+  uint64_t gcUs;
+  /** AU merges, each charged to the write that caused it */
+  uint32_t gcMerges;
+  /** modeled time since openImage() */
+  uint64_t elapsedUs;
+};
+#endif  // SD_CARD_IMAGE
 //------------------------------------------------------------------------------
 // SD card errors
 /** timeout error for command CMD0 */
@@ -160,6 +243,18 @@ uint8_t const SD_CARD_ERROR_WRITE_PROGRAMMING = 0X14;
 uint8_t const SD_CARD_ERROR_WRITE_TIMEOUT = 0X15;
 /** incorrect rate selected */
 uint8_t const SD_CARD_ERROR_SCK_RATE = 0X16;
+/** card returned an error response for CMD18 (read multiple block) */
+uint8_t const SD_CARD_ERROR_CMD18 = 0X17;
+/** card returned an error response for CMD12 (stop transmission) */
+uint8_t const SD_CARD_ERROR_CMD12 = 0X18;
+/** card returned an error response for CMD6 (switch function) */
+uint8_t const SD_CARD_ERROR_CMD6 = 0X19;
+/** card returned an error response for CMD59 (CRC on/off) */
+uint8_t const SD_CARD_ERROR_CMD59 = 0X1A;
+/** CRC of read data did not match */
+uint8_t const SD_CARD_ERROR_READ_CRC = 0X1B;
+/** card returned an error response for ACMD13 (read SD status) */
+uint8_t const SD_CARD_ERROR_ACMD13 = 0X1C;
 //------------------------------------------------------------------------------
 // card types
 /** Standard capacity V1 SD card */
@@ -176,8 +271,90 @@ uint8_t const SD_CARD_TYPE_SDHC = 3;
 class Sd2Card {
   public:
     /** Construct an instance of Sd2Card. */
-    Sd2Card(void) : errorCode_(0), inBlock_(0), partialBlockRead_(0), type_(0) {}
+    #ifndef SD_CARD_IMAGE
+    Sd2Card(void) : busyMax_(0), busyStalls_(0), busyStart_(0), clock_(0),
+      crcCheck_(0), errorCode_(0), inBlock_(0), partialBlockRead_(0),
+      type_(0), commands_(0), blocksRead_(0), blocksWritten_(0) {}
+    #else  // SD_CARD_IMAGE
+    Sd2Card(void) : busyMax_(0), busyStalls_(0), busyStart_(0), clock_(0),
+      crcCheck_(0), errorCode_(0), inBlock_(0), partialBlockRead_(0),
+      type_(0), highSpeed_(0), gcPendingUs_(0), image_(NULL), imageBlocks_(0), timing_(SD_IMAGE_DEFAULT_TIMING),
+      stats_(), busyUntil_(0), writeLog_(NULL) {}
+    ~Sd2Card(void) {
+      closeImage();
+    }
+    uint8_t openImage(const char* path);
+    void closeImage(void);
+    /** Set the modeled cost of card operations. */
+    void imageTiming(const SdImageTiming& timing) {
+      timing_ = timing;
+    }
+    /** \return operation counts and modeled time since openImage(). */
+    const SdImageStats& imageStats(void) const {
+      return stats_;
+    }
+    /**
+       Append every block written or erased to log, in card order, as a
+       four byte block number in host byte order followed by the 512 data
+       bytes.  NULL stops logging.
+    */
+    void imageWriteLog(FILE* log) {
+      writeLog_ = log;
+    }
+    #endif  // SD_CARD_IMAGE
+    uint32_t allocationUnit(void);
+    /**
+       \return Longest time in microseconds the card stayed busy after
+       writing a block or ending a multiple block write, since
+       clearBusyStats().  Long busy times are the card's internal garbage
+       collection.
+    */
+    uint32_t busyMax(void) const {
+      return busyMax_;
+    }
+    /**
+       \return Number of busy times of at least SD_WRITE_STALL_MICROS since
+       clearBusyStats().
+    */
+    uint32_t busyStalls(void) const {
+      return busyStalls_;
+    }
+    /** Restart busyMax() and busyStalls(). */
+    void clearBusyStats(void) {
+      busyMax_ = busyStalls_ = 0;
+    }
+    #ifndef SD_CARD_IMAGE
+    /** \return Number of commands sent to the card. */
+    uint32_t commandCount(void) const {
+      return commands_;
+    }
+    /** \return Number of data blocks read from the card. */
+    uint32_t blockReadCount(void) const {
+      return blocksRead_;
+    }
+    /** \return Number of data blocks the card accepted for writing. */
+    uint32_t blockWriteCount(void) const {
+      return blocksWritten_;
+    }
+    #else  // SD_CARD_IMAGE
+    /** \return Number of commands since openImage(). */
+    uint32_t commandCount(void) const {
+      return stats_.commands;
+    }
+    /** \return Number of blocks read since openImage(). */
+    uint32_t blockReadCount(void) const {
+      return stats_.blocksRead;
+    }
+    /** \return Number of blocks written since openImage(). */
+    uint32_t blockWriteCount(void) const {
+      return stats_.blocksWritten;
+    }
+    #endif  // SD_CARD_IMAGE
     uint32_t cardSize(void);
+    /** Returns the current value, true or false, for CRC checking. */
+    uint8_t crcCheck(void) const {
+      return crcCheck_;
+    }
     uint8_t erase(uint32_t firstBlock, uint32_t lastBlock);
     uint8_t eraseSingleBlockEnable(void);
     /**
@@ -228,10 +405,22 @@ class Sd2Card {
       return readRegister(CMD9, csd);
     }
     void readEnd(void);
+    uint8_t readData(uint8_t* dst);
+    uint8_t readStart(uint32_t blockNumber);
+    uint8_t readStop(void);
+    uint8_t readSdStatus(uint8_t* status);
+    uint32_t maxClock(void);
+    uint8_t setCrcCheck(uint8_t enable);
     uint8_t setSckRate(uint8_t sckRateID);
     #ifdef USE_SPI_LIB
     uint8_t setSpiClock(uint32_t clock);
+    /** Return the SPI clock in Hz set by setSckRate() or setSpiClock(). */
+    uint32_t spiClock(void) const {
+      return clock_;
+    }
     #endif
+    uint8_t switchFunction(uint32_t arg, uint8_t* status);
+    uint8_t switchHighSpeed(void);
     /** Return the card type: SD V1, SD V2 or SDHC */
     uint8_t type(void) const {
       return type_;
@@ -239,27 +428,48 @@ class Sd2Card {
     uint8_t writeBlock(uint32_t blockNumber, const uint8_t* src, uint8_t blocking = 1);
     uint8_t writeData(const uint8_t* src);
     uint8_t writeStart(uint32_t blockNumber, uint32_t eraseCount);
-    uint8_t writeStop(void);
+    uint8_t writeStop(uint8_t blocking = 1);
     uint8_t isBusy(void);
   private:
     uint32_t block_;
+    uint32_t busyMax_;
+    uint32_t busyStalls_;
+    uint32_t busyStart_;
+    uint32_t clock_;
     uint8_t chipSelectPin_;
+    uint8_t crcCheck_;
     uint8_t errorCode_;
     uint8_t inBlock_;
     uint16_t offset_;
     uint8_t partialBlockRead_;
     uint8_t status_;
     uint8_t type_;
+    #ifndef SD_CARD_IMAGE
+    uint32_t commands_;
+    uint32_t blocksRead_;
+    uint32_t blocksWritten_;
+    #endif  // SD_CARD_IMAGE
     // private functions
     uint8_t cardAcmd(uint8_t cmd, uint32_t arg) {
       cardCommand(CMD55, 0);
       return cardCommand(cmd, arg);
     }
+    // record the length of a busy time after a write
+    void busyEnd(uint32_t us) {
+      if (us > busyMax_) {
+        busyMax_ = us;
+      }
+      if (us >= SD_WRITE_STALL_MICROS) {
+        busyStalls_++;
+      }
+    }
+    void busyTimeEnd(void);
     uint8_t cardCommand(uint8_t cmd, uint32_t arg);
     void error(uint8_t code) {
       errorCode_ = code;
     }
     uint8_t readRegister(uint8_t cmd, void* buf);
+    uint8_t receiveData(uint8_t* dst, uint16_t count);
     uint8_t sendWriteCommand(uint32_t blockNumber, uint32_t eraseCount);
     void chipSelectHigh(void);
     void chipSelectLow(void);
@@ -269,5 +479,26 @@ class Sd2Card {
     uint8_t waitNotBusy(unsigned int timeoutMillis);
     uint8_t writeData(uint8_t token, const uint8_t* src);
     uint8_t waitStartBlock(void);
+    #ifdef SD_CARD_IMAGE
+    uint8_t highSpeed_;
+    uint32_t gcPendingUs_;
+    uint32_t auOpen_[SD_IMAGE_MAX_OPEN_AUS];  // AU number + 1, zero if free
+    uint32_t auNext_[SD_IMAGE_MAX_OPEN_AUS];  // next block in write order
+    uint32_t auUse_[SD_IMAGE_MAX_OPEN_AUS];   // LRU stamp
+    uint32_t auUseCount_;
+    FILE* image_;
+    uint32_t imageBlocks_;
+    SdImageTiming timing_;
+    SdImageStats stats_;
+    uint64_t busyUntil_;
+    FILE* writeLog_;
+    uint8_t imageData_[512];
+    uint8_t imageRead(uint32_t block, uint8_t* dst);
+    void imageBusy(uint32_t us);
+    void imageGc(uint32_t block);
+    uint8_t imageLog(uint32_t block, const uint8_t* src);
+    void imageSpend(uint32_t us);
+    uint8_t imageWrite(uint32_t block, const uint8_t* src);
+    #endif  // SD_CARD_IMAGE
 };
 #endif  // Sd2Card_h
@@ -0,0 +1,651 @@
+/* Arduino Sd2Card Library
+   Copyright (C) 2009 by William Greiman
+
+   This file is part of the Arduino Sd2Card Library
+
+   This Library is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the Arduino Sd2Card Library.  If not, see
+   <http://www.gnu.org/licenses/>.
+*/
+/**
+   \file
+   Sd2Card backend that serves a raw FAT16/FAT32 image file.
+
+   Built instead of Sd2Card.cpp when SD_CARD_IMAGE is defined.  Every
+   command, block transfer and programming delay is charged to a modeled
+   clock (SdImageTiming), so a run gives the same time on any host.  Card
+   busy time overlaps whatever the caller does until the next command or
+   isBusy() poll, as it does on the SPI bus.
+*/
+#ifdef SD_CARD_IMAGE
+#include <Arduino.h>
+#include <string.h>
+#include <sys/types.h>
+#include "Sd2Card.h"
+//------------------------------------------------------------------------------
+// model a command and its response; like the card, wait out programming first
+uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
+  (void)cmd;
+  (void)arg;
+  readEnd();
+  waitNotBusy(SD_WRITE_TIMEOUT);
+  stats_.commands++;
+  imageSpend(timing_.commandUs);
+  status_ = R1_READY_STATE;
+  return status_;
+}
+//------------------------------------------------------------------------------
+/**
+   Allocation unit size of the image card, SdImageTiming::auBlocks if it
+   is one the SD status can report.
+
+   \return The AU size in 512 byte blocks, or zero if it is not known.
+*/
+uint32_t Sd2Card::allocationUnit(void) {
+  // AU_SIZE 1 to 9 is 16 KB to 4 MB, 0XA to 0XF these sizes in MB
+  static const uint8_t mb[6] = {8, 12, 16, 24, 32, 64};
+  uint8_t status[64];
+  if (!readSdStatus(status)) {
+    return 0;
+  }
+  uint8_t au = status[10] >> 4;
+  if (au == 0) {
+    return 0;
+  }
+  return au < 10 ? 16UL << au : (uint32_t)mb[au - 10] << 11;
+}
+//------------------------------------------------------------------------------
+/**
+   Determine the size of the card image.
+
+   \return The number of 512 byte data blocks in the image
+           or zero if no image is open.
+*/
+uint32_t Sd2Card::cardSize(void) {
+  return imageBlocks_;
+}
+//------------------------------------------------------------------------------
+/** Close the image file.  The card must be initialized again to be used. */
+void Sd2Card::closeImage(void) {
+  if (image_) {
+    fclose(image_);
+    image_ = NULL;
+  }
+  imageBlocks_ = 0;
+}
+//------------------------------------------------------------------------------
+/** Erase a range of blocks.  Erased blocks read as zero.
+
+   \param[in] firstBlock The address of the first block in the range.
+   \param[in] lastBlock The address of the last block in the range.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::erase(uint32_t firstBlock, uint32_t lastBlock) {
+  if (lastBlock < firstBlock || lastBlock >= imageBlocks_) {
+    error(SD_CARD_ERROR_ERASE);
+    return false;
+  }
+  cardCommand(CMD32, firstBlock);
+  cardCommand(CMD33, lastBlock);
+  cardCommand(CMD38, 0);
+  memset(imageData_, 0, 512);
+  for (uint32_t b = firstBlock; b <= lastBlock; b++) {
+    if (fseeko(image_, (off_t)b << 9, SEEK_SET)
+        || fwrite(imageData_, 1, 512, image_) != 512
+        || !imageLog(b, imageData_)) {
+      error(SD_CARD_ERROR_ERASE);
+      return false;
+    }
+  }
+  busyUntil_ = stats_.elapsedUs + timing_.busySingleUs;
+  return waitNotBusy(SD_ERASE_TIMEOUT);
+}
+//------------------------------------------------------------------------------
+/** Image cards always support single block erase.
+
+   \return The value one, true.
+*/
+uint8_t Sd2Card::eraseSingleBlockEnable(void) {
+  return true;
+}
+//------------------------------------------------------------------------------
+// start a busy time after a write, with any garbage collection it caused
+void Sd2Card::imageBusy(uint32_t us) {
+  us += gcPendingUs_;
+  stats_.gcUs += gcPendingUs_;
+  gcPendingUs_ = 0;
+  busyUntil_ = stats_.elapsedUs + us;
+  busyEnd(us);
+}
+//------------------------------------------------------------------------------
+// Model AU garbage collection for a write to block.  The card writes up
+// to openAus AUs at once.  Opening another one closes the least recently
+// used, copying the part of it past the last block written, and copies
+// the part of the new AU before the block.  Writes inside an open AU are
+// buffered.  The first AU, which holds the FAT, is left out as cards
+// handle it in random write mode.
+void Sd2Card::imageGc(uint32_t block) {
+  uint32_t size = timing_.auBlocks;
+  uint32_t au = size ? block / size : 0;
+  if (au == 0) {
+    return;
+  }
+  uint8_t n = timing_.openAus;
+  if (n == 0 || n > SD_IMAGE_MAX_OPEN_AUS) {
+    n = SD_IMAGE_MAX_OPEN_AUS;
+  }
+  uint32_t start = au * size;
+  uint32_t copy = 0;
+  uint8_t slot = n;
+  for (uint8_t i = 0; i < n; i++) {
+    if (auOpen_[i] == au + 1) {
+      slot = i;
+    }
+  }
+  if (slot == n) {
+    // close the least recently used AU, free slots first
+    slot = 0;
+    for (uint8_t i = 1; i < n; i++) {
+      if (auUse_[i] < auUse_[slot]) {
+        slot = i;
+      }
+    }
+    if (auOpen_[slot]) {
+      copy += auOpen_[slot] * size - auNext_[slot];
+    }
+    auOpen_[slot] = au + 1;
+    auNext_[slot] = block;
+    copy += block - start;
+  }
+  if (block >= auNext_[slot]) {
+    auNext_[slot] = block + 1;
+  }
+  auUse_[slot] = ++auUseCount_;
+  if (auNext_[slot] == start + size) {
+    // full AU, nothing to copy when it closes
+    auOpen_[slot] = auUse_[slot] = 0;
+  }
+  if (copy) {
+    gcPendingUs_ += copy * timing_.gcBlockUs;
+    stats_.gcMerges++;
+  }
+}
+//------------------------------------------------------------------------------
+// record a block write in the write log, if one is set
+uint8_t Sd2Card::imageLog(uint32_t block, const uint8_t* src) {
+  return !writeLog_
+         || (fwrite(&block, 4, 1, writeLog_) == 1
+             && fwrite(src, 1, 512, writeLog_) == 512);
+}
+//------------------------------------------------------------------------------
+// read one block from the image
+uint8_t Sd2Card::imageRead(uint32_t block, uint8_t* dst) {
+  if (block >= imageBlocks_
+      || fseeko(image_, (off_t)block << 9, SEEK_SET)
+      || fread(dst, 1, 512, image_) != 512) {
+    error(SD_CARD_ERROR_READ);
+    return false;
+  }
+  stats_.blocksRead++;
+  imageSpend(timing_.transferUs);
+  // model a bus clocked faster than the card and wiring allow
+  if (timing_.errorClock && clock_ > timing_.errorClock) {
+    dst[block & 0X1FF] ^= 0X10;
+    if (crcCheck_) {
+      error(SD_CARD_ERROR_READ_CRC);
+      return false;
+    }
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+// charge modeled time, and delay for it in real time mode
+void Sd2Card::imageSpend(uint32_t us) {
+  stats_.elapsedUs += us;
+  if (timing_.realTime && us) {
+    delayMicroseconds(us);
+  }
+}
+//------------------------------------------------------------------------------
+// write one block to the image
+uint8_t Sd2Card::imageWrite(uint32_t block, const uint8_t* src) {
+  if (block >= imageBlocks_
+      || fseeko(image_, (off_t)block << 9, SEEK_SET)
+      || fwrite(src, 1, 512, image_) != 512
+      || !imageLog(block, src)) {
+    error(SD_CARD_ERROR_WRITE);
+    return false;
+  }
+  stats_.blocksWritten++;
+  imageSpend(timing_.transferUs);
+  imageGc(block);
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Initialize the image card.  openImage() must have succeeded.
+
+   \param[in] sckRateID SPI clock rate selector, checked but not modeled.
+   Set SdImageTiming::transferUs to model a bus clock.
+   \param[in] chipSelectPin Unused.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::init(uint8_t sckRateID, uint8_t chipSelectPin) {
+  errorCode_ = inBlock_ = partialBlockRead_ = type_ = crcCheck_ = 0;
+  highSpeed_ = 0;
+  chipSelectPin_ = chipSelectPin;
+  if (!image_) {
+    error(SD_CARD_ERROR_CMD0);
+    return false;
+  }
+  // CMD0, CMD8, CMD55 + ACMD41 and CMD58
+  for (uint8_t i = 0; i < 5; i++) {
+    cardCommand(CMD0, 0);
+  }
+  type(SD_CARD_TYPE_SDHC);
+  return setSckRate(sckRateID);
+}
+//------------------------------------------------------------------------------
+/**
+   Maximum SPI clock of the card, from the TRAN_SPEED field of its CSD:
+   25 MHz, or 50 MHz after switchHighSpeed().
+
+   \return The clock in Hz or zero if the CSD could not be read.
+*/
+uint32_t Sd2Card::maxClock(void) {
+  // TRAN_SPEED time value, times ten
+  static const uint8_t mult[16] = {
+    0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80
+  };
+  csd_t csd;
+  if (!readCSD(&csd)) {
+    return 0;
+  }
+  // rate unit 100 kbit/s, 1, 10 or 100 Mbit/s; divided by ten for mult
+  uint32_t unit = 10000;
+  for (uint8_t i = csd.v1.tran_speed & 7; i > 0 && i < 4; i--) {
+    unit *= 10;
+  }
+  return unit * mult[(csd.v1.tran_speed >> 3) & 0XF];
+}
+//------------------------------------------------------------------------------
+/**
+   Open a raw card image, e.g. one made with dd from a FAT formatted card
+   or with mkfs.fat on a plain file.  Resets the statistics and the
+   modeled clock.
+
+   \param[in] path Image file, opened for reading and writing.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::openImage(const char* path) {
+  closeImage();
+  image_ = fopen(path, "r+b");
+  if (!image_ || fseeko(image_, 0, SEEK_END)) {
+    closeImage();
+    return false;
+  }
+  imageBlocks_ = ftello(image_) >> 9;
+  memset(&stats_, 0, sizeof(stats_));
+  busyUntil_ = 0;
+  gcPendingUs_ = 0;
+  memset(auOpen_, 0, sizeof(auOpen_));
+  memset(auUse_, 0, sizeof(auUse_));
+  auUseCount_ = 0;
+  return imageBlocks_ != 0;
+}
+//------------------------------------------------------------------------------
+/** Enable or disable partial block reads.  See the SPI driver. */
+void Sd2Card::partialBlockRead(uint8_t value) {
+  readEnd();
+  partialBlockRead_ = value;
+}
+//------------------------------------------------------------------------------
+/**
+   Read a 512 byte block from the image.
+
+   \param[in] block Logical block to be read.
+   \param[out] dst Pointer to the location that will receive the data.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readBlock(uint32_t block, uint8_t* dst) {
+  return readData(block, 0, 512, dst);
+}
+//------------------------------------------------------------------------------
+/**
+   Read part of a 512 byte block from the image.  A new block is charged
+   one command and one block transfer; further reads of the same block in
+   partial block read mode are free, as they continue the same transfer.
+
+   \param[in] block Logical block to be read.
+   \param[in] offset Number of bytes to skip at start of block
+   \param[out] dst Pointer to the location that will receive the data.
+   \param[in] count Number of bytes to read
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readData(uint32_t block,
+                          uint16_t offset, uint16_t count, uint8_t* dst) {
+  if (count == 0) {
+    return true;
+  }
+  if ((count + offset) > 512) {
+    return false;
+  }
+  if (!inBlock_ || block != block_ || offset < offset_) {
+    cardCommand(CMD17, block);
+    if (!imageRead(block, imageData_)) {
+      return false;
+    }
+    block_ = block;
+    offset_ = 0;
+    inBlock_ = 1;
+  }
+  memcpy(dst, imageData_ + offset, count);
+  offset_ = offset + count;
+  if (!partialBlockRead_ || offset_ >= 512) {
+    readEnd();
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+/** End a partial block read. */
+void Sd2Card::readEnd(void) {
+  inBlock_ = 0;
+}
+//------------------------------------------------------------------------------
+/** Read one data block in a multiple block read sequence
+
+   \param[out] dst Pointer to the location for the 512 byte block.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readData(uint8_t* dst) {
+  return imageRead(block_++, dst);
+}
+//------------------------------------------------------------------------------
+/** Start a read multiple blocks sequence.
+
+   \param[in] blockNumber Address of first block in sequence.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readStart(uint32_t blockNumber) {
+  cardCommand(CMD18, blockNumber);
+  block_ = blockNumber;
+  return true;
+}
+//------------------------------------------------------------------------------
+/** End a read multiple blocks sequence.
+
+  \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readStop(void) {
+  cardCommand(CMD12, 0);
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Synthesize the SD status of the image card.  Only the AU size, from
+   SdImageTiming::auBlocks, is filled in.
+
+   \param[out] status The 64 byte SD status.
+
+   \return The value one, true.
+*/
+uint8_t Sd2Card::readSdStatus(uint8_t* status) {
+  static const uint8_t mb[6] = {8, 12, 16, 24, 32, 64};
+  cardAcmd(ACMD13, 0);
+  imageSpend(timing_.transferUs / 8);
+  memset(status, 0, 64);
+  for (uint8_t au = 1; au < 16; au++) {
+    if (timing_.auBlocks == (au < 10 ? 16UL << au : (uint32_t)mb[au - 10] << 11)) {
+      status[10] = au << 4;
+    }
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+// synthesize the CID or a version 2 CSD for the image
+uint8_t Sd2Card::readRegister(uint8_t cmd, void* buf) {
+  cardCommand(cmd, 0);
+  memset(buf, 0, 16);
+  if (cmd == CMD9) {
+    csd2_t* csd = reinterpret_cast<csd2_t*>(buf);
+    uint32_t c_size = imageBlocks_ >= 1024 ? (imageBlocks_ >> 10) - 1 : 0;
+    csd->csd_ver = 1;
+    csd->tran_speed = highSpeed_ ? 0X5A : 0X32;
+    // command classes 0, 2, 4, 5, 7, 8 and 10
+    csd->ccc_high = 0X5B;
+    csd->ccc_low = 5;
+    csd->read_bl_len = 9;
+    csd->c_size_high = (c_size >> 16) & 0X3F;
+    csd->c_size_mid = c_size >> 8;
+    csd->c_size_low = c_size;
+    csd->erase_blk_en = 1;
+    csd->write_bl_len_high = 9 >> 2;
+    csd->write_bl_len_low = 9 & 3;
+    csd->always1 = 1;
+  } else {
+    cid_t* cid = reinterpret_cast<cid_t*>(buf);
+    memcpy(cid->oid, "IM", 2);
+    memcpy(cid->pnm, "IMAGE", 5);
+    cid->psn = imageBlocks_;
+    cid->always1 = 1;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Turn CRC checking on or off.  Image reads only fail their CRC when
+   SdImageTiming::errorClock is exceeded.
+
+   \param[in] enable The value TRUE (non-zero) or FALSE (zero).
+
+   \return The value one, true.
+*/
+uint8_t Sd2Card::setCrcCheck(uint8_t enable) {
+  cardCommand(CMD59, enable ? 1 : 0);
+  crcCheck_ = enable ? 1 : 0;
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Check the SPI clock rate selector.  The modeled transfer time does not
+   depend on it.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for an invalid value of \a sckRateID.
+*/
+uint8_t Sd2Card::setSckRate(uint8_t sckRateID) {
+  // clocks of the SPI driver
+  static const uint32_t rate[7] = {
+    25000000, 4000000, 2000000, 1000000, 500000, 250000, 125000
+  };
+  if (sckRateID > 6) {
+    error(SD_CARD_ERROR_SCK_RATE);
+    return false;
+  }
+  clock_ = rate[sckRateID];
+  return true;
+}
+#ifdef USE_SPI_LIB
+//------------------------------------------------------------------------------
+// the modeled transfer time does not depend on the clock
+uint8_t Sd2Card::setSpiClock(uint32_t clock) {
+  clock_ = clock;
+  return true;
+}
+#endif
+//------------------------------------------------------------------------------
+/**
+   Check or switch card functions.  The image card has high speed mode
+   (function 1 of group 1) and nothing else.
+
+   \param[in] arg Mode in bit 31 (0 check, 1 switch) and one function
+   number per group in bits 23:0, 0XF to leave a group unchanged.
+   \param[out] status The 64 byte switch function status.
+
+   \return The value one, true.
+*/
+uint8_t Sd2Card::switchFunction(uint32_t arg, uint8_t* status) {
+  cardCommand(CMD6, arg);
+  imageSpend(timing_.transferUs / 8);
+  uint8_t fn = arg & 0XF;
+  if (fn == 0XF) {
+    fn = highSpeed_;
+  } else if (fn > 1) {
+    fn = 0XF;
+  } else if (arg & 0X80000000) {
+    highSpeed_ = fn;
+  }
+  memset(status, 0, 64);
+  status[13] = 0X03;
+  status[16] = fn;
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Switch the card to high speed mode, which raises its maximum clock from
+   25 MHz to 50 MHz (see maxClock()).
+
+   \return The value one, true, is returned if the card is in high speed
+   mode and the value zero, false, if it is not.
+*/
+uint8_t Sd2Card::switchHighSpeed(void) {
+  csd_t csd;
+  uint8_t status[64];
+  // CMD6 is in command class 10
+  if (!readCSD(&csd) || !(csd.v1.ccc_high & 0X40)) {
+    return false;
+  }
+  // check high speed is function 1 of group 1, then select it
+  if (!switchFunction(0X00FFFFF1, status) || !(status[13] & 2)) {
+    return false;
+  }
+  return switchFunction(0X80FFFFF1, status) && (status[16] & 0XF) == 1;
+}
+//------------------------------------------------------------------------------
+// wait out modeled programming time
+uint8_t Sd2Card::waitNotBusy(unsigned int timeoutMillis) {
+  (void)timeoutMillis;
+  if (stats_.elapsedUs < busyUntil_) {
+    uint32_t wait = busyUntil_ - stats_.elapsedUs;
+    stats_.busyWaitUs += wait;
+    imageSpend(wait);
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Writes a 512 byte block to the image.
+
+   \param[in] blockNumber Logical block to be written.
+   \param[in] src Pointer to the location of the data to be written.
+   \param[in] blocking If the write should wait for modeled programming.
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t* src, uint8_t blocking) {
+  #if SD_PROTECT_BLOCK_ZERO
+  // don't allow write to first block
+  if (blockNumber == 0) {
+    error(SD_CARD_ERROR_WRITE_BLOCK_ZERO);
+    return false;
+  }
+  #endif  // SD_PROTECT_BLOCK_ZERO
+  cardCommand(CMD24, blockNumber);
+  if (!imageWrite(blockNumber, src)) {
+    return false;
+  }
+  stats_.singleWrites++;
+  imageBusy(timing_.busySingleUs);
+  if (blocking) {
+    // wait for programming, then the CMD13 status check
+    cardCommand(CMD13, 0);
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+/** Write one data block in a multiple block write sequence */
+uint8_t Sd2Card::writeData(const uint8_t* src) {
+  // wait for previous block to finish
+  waitNotBusy(SD_WRITE_TIMEOUT);
+  if (!imageWrite(block_++, src)) {
+    return false;
+  }
+  imageBusy(timing_.busyMultipleUs);
+  return true;
+}
+//------------------------------------------------------------------------------
+/** Start a write multiple blocks sequence.
+
+   \param[in] blockNumber Address of first block in sequence.
+   \param[in] eraseCount The number of blocks to be pre-erased.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount) {
+  #if SD_PROTECT_BLOCK_ZERO
+  // don't allow write to first block
+  if (blockNumber == 0) {
+    error(SD_CARD_ERROR_WRITE_BLOCK_ZERO);
+    return false;
+  }
+  #endif  // SD_PROTECT_BLOCK_ZERO
+  cardAcmd(ACMD23, eraseCount);
+  cardCommand(CMD25, blockNumber);
+  stats_.multipleWrites++;
+  block_ = blockNumber;
+  return true;
+}
+//------------------------------------------------------------------------------
+/** End a write multiple blocks sequence.
+
+  \param[in] blocking If the stop should wait for modeled programming.
+
+  \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::writeStop(uint8_t blocking) {
+  waitNotBusy(SD_WRITE_TIMEOUT);
+  // stop token, then the card finishes the last block
+  imageSpend(timing_.pollUs);
+  imageBusy(timing_.busyMultipleUs);
+  if (blocking) {
+    waitNotBusy(SD_WRITE_TIMEOUT);
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+/** Check if the card is still programming.  Each poll costs modeled time.
+
+  \return The value one, true, is returned when is busy and
+   the value zero, false, is returned for when is NOT busy.
+*/
+uint8_t Sd2Card::isBusy(void) {
+  imageSpend(timing_.pollUs);
+  return stats_.elapsedUs < busyUntil_;
+}
+#endif  // SD_CARD_IMAGE
@@ -31,6 +31,22 @@
 
 #endif // Sd2PinMap_h
 
+#elif defined(ESP32) || defined(SD_CARD_IMAGE) // ESP32, host image card
+
+#ifndef Sd2PinMap_h
+  #define Sd2PinMap_h
+
+  #include <Arduino.h>
+
+  // default SPI pins of the variant; the sketch may remap them with
+  // SPI.begin(sck, miso, mosi, ss) before SD.begin()
+  uint8_t const SS_PIN = SS;
+  uint8_t const MOSI_PIN = MOSI;
+  uint8_t const MISO_PIN = MISO;
+  uint8_t const SCK_PIN = SCK;
+
+#endif // Sd2PinMap_h
+
 #elif defined(__AVR_ATmega4809__) || defined(__AVR_ATmega4808__) || \
 defined(__AVR_ATmega3209__) || defined(__AVR_ATmega3208__) || \
 defined(__AVR_ATmega1609__) || defined(__AVR_ATmega1608__) || \
@@ -35,6 +35,111 @@
 */
 #define ALLOW_DEPRECATED_FUNCTIONS 1
 //------------------------------------------------------------------------------
+/**
+   Minimum number of whole blocks that SdFile::write() sends with one
+   multiple block write (CMD25).  Shorter runs use single block writes.
+   Set to zero to disable multiple block writes.
+
+   examples/StorageBenchmark on the image card's default timing (make bench
+   in extras/host), 100 photos of 10-30 KB written 4 KB at a time:
+   CMD24 only 348 KB/s, 53.7 ms per photo; CMD25 801 KB/s, 24.1 ms.
+*/
+#ifndef SD_MULTI_BLOCK_WRITE_MIN
+  #define SD_MULTI_BLOCK_WRITE_MIN 2
+#endif  // SD_MULTI_BLOCK_WRITE_MIN
+/**
+   Minimum number of whole blocks that SdFile::read() fetches with one
+   multiple block read (CMD18).  Shorter runs use single block reads.
+   Set to zero to disable multiple block reads.
+*/
+#ifndef SD_MULTI_BLOCK_READ_MIN
+  #define SD_MULTI_BLOCK_READ_MIN 2
+#endif  // SD_MULTI_BLOCK_READ_MIN
+/**
+   Keep a free-cluster bitmap in memory (PSRAM when available) so that
+   allocation searches bitmap words instead of reading the FAT.
+
+   The bitmap costs one bit per cluster, clusterCount() / 8 bytes:
+   2 GB FAT16 with 32 KB clusters needs 8 KB, 8 GB FAT32 with 4 KB
+   clusters 256 KB, 32 GB FAT32 with 32 KB clusters 128 KB.  Volumes
+   needing more than SD_FREE_BITMAP_MAX_BYTES use FAT scans instead.
+*/
+#ifndef SD_FREE_CLUSTER_BITMAP
+  #if defined(ESP32)
+    #define SD_FREE_CLUSTER_BITMAP 1
+  #else
+    #define SD_FREE_CLUSTER_BITMAP 0
+  #endif
+#endif  // SD_FREE_CLUSTER_BITMAP
+/** Largest free-cluster bitmap that will be allocated, in bytes */
+#define SD_FREE_BITMAP_MAX_BYTES 270336UL
+/**
+   Number of 512 byte blocks held by the SdVolume block cache.  FAT,
+   directory and file data blocks share the slots with LRU replacement.
+   Each slot costs about 530 bytes of RAM.  One slot is the original
+   single block cache.
+*/
+#ifndef SD_CACHE_SLOTS
+  #if defined(__AVR__)
+    #define SD_CACHE_SLOTS 1
+  #else
+    #define SD_CACHE_SLOTS 8
+  #endif
+#endif  // SD_CACHE_SLOTS
+/**
+   Set nonzero to write the second FAT copy once per sync or close instead
+   of each time a FAT block is written.  Needs at least two cache slots.
+*/
+#ifndef SD_FAT_MIRROR_BATCH
+  #define SD_FAT_MIRROR_BATCH (SD_CACHE_SLOTS > 1)
+#endif  // SD_FAT_MIRROR_BATCH
+/**
+   FAT blocks with a batched mirror write pending that may leave the cache
+   before the next sync.  An evicted block past this many has its mirror
+   written as it leaves.  Each costs four bytes of RAM.
+*/
+#ifndef SD_FAT_MIRROR_STALE
+  #define SD_FAT_MIRROR_STALE 16
+#endif  // SD_FAT_MIRROR_STALE
+/**
+   Largest number of blocks that a sequential SdFile::read() cache miss in
+   a regular file prefetches past the block it needs, in the same multiple
+   block read.  Directories are not prefetched.
+   The window starts at one block and doubles while reads stay sequential.
+   Limited to half the cache so FAT and directory blocks stay cached.
+   Set to zero to disable readahead.
+*/
+#ifndef SD_READ_AHEAD_BLOCKS
+  #define SD_READ_AHEAD_BLOCKS (SD_CACHE_SLOTS / 2)
+#endif  // SD_READ_AHEAD_BLOCKS
+/**
+   Contiguous allocations of at least this many blocks (SdFile::preAllocate(),
+   createContiguous()) start on an allocation unit boundary when the AU is
+   known (SdVolume::setAllocationUnit()) and a free run of that size starts
+   on one.  Smaller allocations fill the space in between as before.
+   Set to zero to disable AU alignment.
+*/
+#ifndef SD_AU_ALIGN_MIN_BLOCKS
+  #define SD_AU_ALIGN_MIN_BLOCKS 1024
+#endif  // SD_AU_ALIGN_MIN_BLOCKS
+/** sync() after every write(), as if each file were opened with O_SYNC */
+uint8_t const SD_SYNC_WRITE = 0;
+/** sync() and close() write the directory entry and cache to the SD */
+uint8_t const SD_SYNC_CLOSE = 1;
+/**
+   sync() and close() update the directory entry in the cache only.  It
+   reaches the SD when the cache evicts it or at SdVolume::sync(), which the
+   application calls periodically.  Files opened with O_SYNC still write
+   through.
+*/
+uint8_t const SD_SYNC_DEFERRED = 2;
+/**
+   Initial durability level, see SdVolume::setSyncPolicy().
+*/
+#ifndef SD_SYNC_POLICY
+  #define SD_SYNC_POLICY SD_SYNC_CLOSE
+#endif  // SD_SYNC_POLICY
+//------------------------------------------------------------------------------
 // forward declaration since SdVolume is used in SdFile
 class SdVolume;
 //==============================================================================
@@ -151,7 +256,7 @@ uint16_t const FAT_DEFAULT_TIME = (1 << 11);
 class SdFile : public Print {
   public:
     /** Create an instance of SdFile. */
-    SdFile(void) : type_(FAT_FILE_TYPE_CLOSED) {}
+    SdFile(void) : type_(FAT_FILE_TYPE_CLOSED), preAllocClusters_(0) {}
     /**
        writeError is set to true if an error occurs during a write().
        Set writeError to false before calling print() and/or write() and check
@@ -226,6 +331,7 @@ class SdFile : public Print {
       return dirIndex_;
     }
     static void dirName(const dir_t& dir, char* name);
+    static uint8_t entryName(uint32_t dirBlock, uint8_t dirIndex, char* name);
     /** \return The total number of bytes in a file or directory. */
     uint32_t fileSize(void) const {
       return fileSize_;
@@ -258,8 +364,10 @@ class SdFile : public Print {
     uint8_t makeDir(SdFile* dir, const char* dirName);
     uint8_t open(SdFile* dirFile, uint16_t index, uint8_t oflag);
     uint8_t open(SdFile* dirFile, const char* fileName, uint8_t oflag);
+    uint8_t open(SdVolume* vol, uint32_t dirBlock, uint8_t dirIndex, uint8_t oflag);
 
     uint8_t openRoot(SdVolume* vol);
+    uint8_t preAllocate(uint32_t length);
     static void printDirName(const dir_t& dir, uint8_t width);
     static void printFatDate(uint16_t fatDate);
     static void printFatTime(uint16_t fatTime);
@@ -278,6 +386,8 @@ class SdFile : public Print {
     int8_t readDir(dir_t* dir);
     static uint8_t remove(SdFile* dirFile, const char* fileName);
     uint8_t remove(void);
+    uint8_t removeFiles(uint8_t (*match)(const char* name, void* context),
+                        void* context, uint16_t* count);
     /** Set the file's current position to zero. */
     void rewind(void) {
       curPosition_ = curCluster_ = 0;
@@ -444,6 +554,11 @@ class SdFile : public Print {
     uint8_t   dirIndex_;      // index of entry in dirBlock 0 <= dirIndex_ <= 0XF
     uint32_t  fileSize_;      // file size in bytes
     uint32_t  firstCluster_;  // first cluster of file
+    uint32_t  preAllocClusters_;  // clusters reserved by preAllocate()
+    #if SD_READ_AHEAD_BLOCKS
+    uint32_t  readAheadPos_;  // position a sequential read continues from
+    uint8_t   readAheadBlocks_;  // blocks to prefetch on the next miss
+    #endif  // SD_READ_AHEAD_BLOCKS
     SdVolume* vol_;           // volume where file is located
 
     // private functions
@@ -451,9 +566,21 @@ class SdFile : public Print {
     uint8_t addDirCluster(void);
     dir_t* cacheDirEntry(uint8_t action);
     static void (*dateTime_)(uint16_t* date, uint16_t* time);
+    uint8_t freePreAllocation(void);
     static uint8_t make83Name(const char* str, uint8_t* name);
     uint8_t openCachedEntry(uint8_t cacheIndex, uint8_t oflags);
+    uint8_t removeFlush(uint32_t* chains, uint8_t count);
     dir_t* readDirCache(void);
+    #if SD_READ_AHEAD_BLOCKS
+    uint8_t readAheadCount(void);
+    void readAheadReset(void) {
+      readAheadPos_ = 0;
+      readAheadBlocks_ = 1;
+    }
+    #endif  // SD_READ_AHEAD_BLOCKS
+    uint16_t readMultiple(uint32_t block, uint8_t* dst, uint16_t maxBlocks);
+    uint16_t writeMultiple(uint32_t block, const uint8_t* src,
+                           uint16_t maxBlocks);
 };
 //==============================================================================
 // SdVolume class
@@ -473,6 +600,31 @@ union cache_t {
   mbr_t    mbr;
   /** Used to access to a cached FAT boot sector. */
   fbs_t    fbs;
+  /** Used to access a cached FAT32 FSINFO sector. */
+  fsinfo_t fsinfo;
+};
+//------------------------------------------------------------------------------
+/**
+   \struct SdVolumeState
+   \brief What SdVolume::init() reads from a volume, saved by
+   SdVolume::getState() so that a later mount of the same volume can skip
+   reading it again.
+*/
+struct SdVolumeState {
+  /** First block of the volume, zero for a super floppy. */
+  uint32_t startBlock;
+  /** Volume serial number from the boot sector, zero if it has none. */
+  uint32_t serial;
+  /** Number of clusters in the volume. */
+  uint32_t clusterCount;
+  /** Free cluster count, FSINFO_UNKNOWN if not known. */
+  uint32_t freeClusters;
+  /** Cluster to start looking for free clusters. */
+  uint32_t allocStart;
+  /** FAT32 FSINFO block, zero if none. */
+  uint32_t fsInfoBlock;
+  /** Allocation unit in blocks, for setAllocationUnit(), zero if not set. */
+  uint32_t auBlocks;
 };
 //------------------------------------------------------------------------------
 /**
@@ -482,14 +634,113 @@ union cache_t {
 class SdVolume {
   public:
     /** Create an instance of SdVolume */
-    SdVolume(void) : allocSearchStart_(2), fatType_(0) {}
+    SdVolume(void) : allocSearchStart_(2), fatType_(0), freeBitmap_(0),
+      freeBitmapScan_(0), scanFreeCount_(0), freeClusters_(FSINFO_UNKNOWN),
+      fsInfoBlock_(0), fsInfoDirty_(0), volumeStartBlock_(0), volumeSerial_(0),
+      auBlocks_(0), auClusters_(0), auPhase_(0), alignedExtents_(0) {}
     /** Clear the cache and returns a pointer to the cache.  Used by the WaveRP
         recorder to do raw write to the SD card.  Not for normal apps.
     */
     static uint8_t* cacheClear(void) {
       cacheFlush();
-      cacheBlockNumber_ = 0XFFFFFFFF;
-      return cacheBuffer_.data;
+      cacheInvalidate(cacheBlockNumber_, 1);
+      return cacheBuffer_->data;
+    }
+    /** \return Number of block cache lookups served from the cache. */
+    static uint32_t cacheHitCount(void) {
+      return cacheHits_;
+    }
+    /** \return Number of block cache lookups that read the card. */
+    static uint32_t cacheMissCount(void) {
+      return cacheMisses_;
+    }
+    /** \return Number of blocks prefetched by sequential file reads. */
+    static uint32_t readAheadCount(void) {
+      return readAheadBlocks_;
+    }
+    /** \return Number of prefetched blocks later served from the cache. */
+    static uint32_t readAheadHitCount(void) {
+      return readAheadHits_;
+    }
+    /** \return Number of primary FAT block writes. */
+    static uint32_t fatWriteCount(void) {
+      return fatWrites_;
+    }
+    /** \return Number of second FAT (mirror) block writes. */
+    static uint32_t fatMirrorWriteCount(void) {
+      return fatMirrorWrites_;
+    }
+    /** \return Number of directory and FSINFO block writes. */
+    static uint32_t dirWriteCount(void) {
+      return dirWrites_;
+    }
+    /** \return Number of directory entry updates made by SdFile::sync(). */
+    static uint32_t entryUpdateCount(void) {
+      return entryUpdates_;
+    }
+    /** \return Number of SdFile::sync() calls that flushed the cache. */
+    static uint32_t syncCount(void) {
+      return syncs_;
+    }
+    /** \return Number of SdFile::sync() calls left in the cache. */
+    static uint32_t deferredSyncCount(void) {
+      return deferredSyncs_;
+    }
+    /** \return True if the cache holds blocks not yet written to the SD. */
+    static uint8_t cacheDirty(void) {
+      for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+        if (cacheSlotFlags_[i] & (CACHE_FOR_WRITE | CACHE_MIRROR_STALE)) {
+          return true;
+        }
+      }
+      return cacheMirrorEvicted_ != 0;
+    }
+    /** \return True if the FAT32 FSINFO free count is out of date; file
+        syncs leave it to sync(). */
+    uint8_t fsInfoPending(void) const {
+      return fsInfoDirty_ && fsInfoBlock_ != 0;
+    }
+    /** \return The durability level, SD_SYNC_WRITE, SD_SYNC_CLOSE or
+        SD_SYNC_DEFERRED. */
+    static uint8_t syncPolicy(void) {
+      return syncPolicy_;
+    }
+    /**
+       Select when SdFile writes reach the SD.  Leaving SD_SYNC_DEFERRED
+       writes what it held back.
+
+       \param[in] policy SD_SYNC_WRITE, SD_SYNC_CLOSE or SD_SYNC_DEFERRED.
+
+       \return The value one, true, is returned for success and
+       the value zero, false, is returned for failure.
+    */
+    static uint8_t setSyncPolicy(uint8_t policy) {
+      if (policy > SD_SYNC_DEFERRED) {
+        return false;
+      }
+      if (policy != SD_SYNC_DEFERRED && !cacheFlush()) {
+        return false;
+      }
+      syncPolicy_ = policy;
+      return true;
+    }
+    uint8_t sync(void);
+    /**
+       Select when the second FAT is written.
+
+       \param[in] batch If nonzero FAT mirror blocks are written once per
+       sync or close, otherwise each time the primary block is written.
+       Ignored with a single cache slot.
+
+       \return The value one, true, is returned for success and
+       the value zero, false, is returned for failure.
+    */
+    static uint8_t setFatMirrorBatch(uint8_t batch) {
+      if (!batch && !cacheFlush()) {
+        return false;
+      }
+      cacheMirrorBatch_ = batch && SD_CACHE_SLOTS > 1;
+      return true;
     }
     /**
        Initialize a FAT volume.  Try partition one first then try super
@@ -506,6 +757,8 @@ class SdVolume {
       return init(dev, 1) ? true : init(dev, 0);
     }
     uint8_t init(Sd2Card* dev, uint8_t part);
+    uint8_t init(Sd2Card* dev, const SdVolumeState& state);
+    void getState(SdVolumeState* state) const;
 
     // inline functions that return volume info
     /** \return The volume's cluster size in blocks. */
@@ -528,6 +781,37 @@ class SdVolume {
     uint32_t dataStartBlock(void) const {
       return dataStartBlock_;
     }
+    /** \return The volume serial number, zero if the boot sector has none. */
+    uint32_t volumeSerial(void) const {
+      return volumeSerial_;
+    }
+    int8_t buildFreeBitmap(uint32_t maxBlocks = 0XFFFFFFFF);
+    uint8_t setAllocationUnit(uint32_t blocks);
+    /** \return The allocation unit in blocks, zero if not set. */
+    uint32_t allocationUnit(void) const {
+      return auBlocks_;
+    }
+    /** \return True if large allocations are aligned to the AU. */
+    uint8_t auAligned(void) const {
+      return auClusters_ != 0;
+    }
+    /** \return Number of allocations placed on an AU boundary. */
+    uint32_t alignedExtentCount(void) const {
+      return alignedExtents_;
+    }
+    /**
+       \return The number of free clusters if known, else 0XFFFFFFFF.
+
+       The count is exact once buildFreeBitmap() has completed.  Before
+       that it is the FAT32 FSINFO hint read at mount, if it was valid.
+    */
+    uint32_t freeClusterCount(void) const {
+      return freeClusters_;
+    }
+    /** \return True if allocation is using the free-cluster bitmap. */
+    uint8_t freeBitmapReady(void) const {
+      return freeBitmap_ && freeBitmapScan_ > clusterCount_ + 1;
+    }
     /** \return The number of FAT structures on the volume. */
     uint8_t fatCount(void) const {
       return fatCount_;
@@ -575,12 +859,42 @@ class SdVolume {
     static uint8_t const CACHE_FOR_READ = 0;
     // value for action argument in cacheRawBlock to indicate cache dirty
     static uint8_t const CACHE_FOR_WRITE = 1;
+    // action flag for file data, written back before FAT and directory blocks
+    static uint8_t const CACHE_DATA = 2;
+    // slot flag for a prefetched block not yet used; says nothing about
+    // the write-back class, which the first write sets
+    static uint8_t const CACHE_READ_AHEAD = 4;
+    // slot flag for a FAT block written without its batched mirror
+    static uint8_t const CACHE_MIRROR_STALE = 8;
 
-    static cache_t cacheBuffer_;        // 512 byte cache for device blocks
-    static uint32_t cacheBlockNumber_;  // Logical number of block in the cache
+    static cache_t cacheSlots_[SD_CACHE_SLOTS];        // 512 byte block buffers
+    static uint32_t cacheSlotBlock_[SD_CACHE_SLOTS];   // block held by slot
+    static uint32_t cacheSlotMirror_[SD_CACHE_SLOTS];  // mirror FAT block or 0
+    static uint32_t cacheSlotUse_[SD_CACHE_SLOTS];     // LRU stamp
+    static uint8_t cacheSlotFlags_[SD_CACHE_SLOTS];    // dirty and data flags
+    static uint32_t cacheUseCount_;     // last LRU stamp issued
+    static uint8_t cacheCurrent_;       // slot of the most recent lookup
+    static cache_t* cacheBuffer_;       // buffer of the current slot
+    static uint32_t cacheBlockNumber_;  // Logical number of block in current slot
+    static uint32_t cacheFatStart_;     // first FAT block for write-back order
+    static uint32_t cacheFatEnd_;       // block after the last FAT
+    static uint32_t cacheHits_;         // lookups served from the cache
+    static uint32_t cacheMisses_;       // lookups that read the card
+    static uint32_t readAheadBlocks_;   // blocks prefetched
+    static uint32_t readAheadHits_;     // prefetched blocks used
+    static uint8_t cacheMirrorBatch_;   // defer FAT mirror writes to cacheFlush()
+    static uint8_t cacheMirrorEvicted_;  // entries in cacheMirrorStale_
+    // FAT blocks evicted with a stale mirror
+    static uint32_t cacheMirrorStale_[SD_FAT_MIRROR_STALE];
+    static uint32_t cacheMirrorOffset_; // distance from primary to mirror FAT
+    static uint32_t fatWrites_;         // primary FAT block writes
+    static uint32_t fatMirrorWrites_;   // mirror FAT block writes
+    static uint32_t dirWrites_;         // directory and FSINFO block writes
+    static uint32_t entryUpdates_;      // directory entries updated by sync
+    static uint32_t syncs_;             // syncs that flushed the cache
+    static uint32_t deferredSyncs_;     // syncs left in the cache
+    static uint8_t syncPolicy_;         // SD_SYNC_WRITE, _CLOSE or _DEFERRED
     static Sd2Card* sdCard_;            // Sd2Card object for cache
-    static uint8_t cacheDirty_;         // cacheFlush() will write block if true
-    static uint32_t cacheMirrorBlock_;  // block number for mirror FAT
     //
     uint32_t allocSearchStart_;   // start cluster for alloc search
     uint8_t blocksPerCluster_;    // cluster size in blocks
@@ -593,8 +907,28 @@ class SdVolume {
     uint8_t fatType_;             // volume type (12, 16, OR 32)
     uint16_t rootDirEntryCount_;  // number of entries in FAT16 root dir
     uint32_t rootDirStart_;       // root start block for FAT16, cluster for FAT32
+    uint32_t* freeBitmap_;        // one bit per cluster, set if in use
+    uint32_t freeBitmapScan_;     // clusters below this have been scanned
+    uint32_t scanFreeCount_;      // free clusters below freeBitmapScan_
+    uint32_t freeClusters_;       // free cluster count or FSINFO_UNKNOWN
+    uint32_t fsInfoBlock_;        // FAT32 FSINFO block, zero if none
+    uint8_t fsInfoDirty_;         // FSINFO needs to be written
+    uint32_t volumeStartBlock_;   // first block of the volume
+    uint32_t volumeSerial_;       // boot sector serial number or zero
+    uint32_t auBlocks_;           // card allocation unit in blocks or zero
+    uint32_t auClusters_;         // clusters per AU, zero if not aligning
+    uint32_t auPhase_;            // cluster % auClusters_ of AU boundaries
+    uint32_t alignedExtents_;     // allocations started on an AU boundary
     //----------------------------------------------------------------------------
     uint8_t allocContiguous(uint32_t count, uint32_t* curCluster);
+    uint8_t bitmapFindFree(uint32_t bgnCluster, uint32_t count,
+                           uint32_t* found) const;
+    uint32_t auAlignUp(uint32_t cluster) const {
+      return cluster + (auPhase_ + auClusters_ - cluster % auClusters_) % auClusters_;
+    }
+    uint8_t findAligned(uint32_t count, uint32_t* found) const;
+    void forgetVolume(void);
+    uint8_t mount(uint32_t volumeStartBlock, const SdVolumeState* state);
     uint8_t blockOfCluster(uint32_t position) const {
       return (position >> 9) & (blocksPerCluster_ - 1);
     }
@@ -604,12 +938,37 @@ class SdVolume {
     uint32_t blockNumber(uint32_t cluster, uint32_t position) const {
       return clusterStartBlock(cluster) + blockOfCluster(position);
     }
+    static uint8_t cacheClass(uint8_t slot);
+    static uint8_t cacheEvict(uint8_t slot);
+    static uint8_t cacheFind(uint32_t blockNumber);
     static uint8_t cacheFlush(uint8_t blocking = 1);
+    static uint8_t cacheFlushRange(uint32_t blockNumber, uint32_t count);
+    static void cacheInvalidate(uint32_t blockNumber, uint32_t count);
     static uint8_t cacheMirrorBlockFlush(uint8_t blocking);
-    static uint8_t cacheRawBlock(uint32_t blockNumber, uint8_t action);
+    static uint8_t cacheMirrorEvict(uint8_t slot);
+    static void cacheMirrorStale(uint8_t slot);
+    static uint8_t cacheMirrorSync(void);
+    static uint8_t cacheMirrorWrite(uint8_t slot);
+    static uint8_t cacheNewBlock(uint32_t blockNumber, uint8_t action);
+    static uint8_t cacheRawBlock(uint32_t blockNumber, uint8_t action,
+                                 uint8_t ahead = 0);
+    static uint8_t cacheReadAhead(uint32_t blockNumber, uint8_t action,
+                                  uint8_t ahead);
+    static void cacheReset(void);
+    static void cacheSelect(uint8_t slot);
     static void cacheSetDirty(void) {
-      cacheDirty_ |= CACHE_FOR_WRITE;
+      cacheTag(cacheCurrent_, CACHE_FOR_WRITE);
     }
+    // Add action to a slot's flags.  A write without CACHE_DATA is metadata,
+    // so a block last cached as file data moves to its metadata class.
+    static void cacheTag(uint8_t slot, uint8_t action) {
+      if ((action & (CACHE_FOR_WRITE | CACHE_DATA)) == CACHE_FOR_WRITE) {
+        cacheSlotFlags_[slot] &= ~CACHE_DATA;
+      }
+      cacheSlotFlags_[slot] |= action;
+    }
+    static uint8_t cacheVictim(void);
+    static uint8_t cacheWriteSlot(uint8_t slot, uint8_t blocking);
     static uint8_t cacheZeroBlock(uint32_t blockNumber);
     uint8_t chainSize(uint32_t beginCluster, uint32_t* size) const;
     uint8_t fatGet(uint32_t cluster, uint32_t* value) const;
@@ -618,6 +977,8 @@ class SdVolume {
       return fatPut(cluster, 0x0FFFFFFF);
     }
     uint8_t freeChain(uint32_t cluster);
+    void freeCountChange(uint32_t cluster, uint8_t freed);
+    uint8_t syncFsInfo(void);
     uint8_t isEOC(uint32_t cluster) const {
       return  cluster >= (fatType_ == 16 ? FAT16EOC_MIN : FAT32EOC_MIN);
     }
@@ -628,14 +989,41 @@ class SdVolume {
                      uint16_t count, uint8_t* dst) {
       return sdCard_->readData(block, offset, count, dst);
     }
+    uint8_t readStart(uint32_t block) {
+      return sdCard_->readStart(block);
+    }
+    uint8_t readData(uint8_t* dst) {
+      return sdCard_->readData(dst);
+    }
+    uint8_t readStop(void) {
+      return sdCard_->readStop();
+    }
     uint8_t writeBlock(uint32_t block, const uint8_t* dst, uint8_t blocking = 1) {
       return sdCard_->writeBlock(block, dst, blocking);
     }
+    uint8_t writeStart(uint32_t block, uint32_t eraseCount) {
+      return sdCard_->writeStart(block, eraseCount);
+    }
+    uint8_t writeData(const uint8_t* src) {
+      return sdCard_->writeData(src);
+    }
+    uint8_t writeStop(uint8_t blocking = 1) {
+      return sdCard_->writeStop(blocking);
+    }
     uint8_t isBusy(void) {
       return sdCard_->isBusy();
     }
     uint8_t isCacheMirrorBlockDirty(void) {
-      return (cacheMirrorBlock_ != 0);
+      // batched mirror blocks are written by the next blocking flush
+      if (cacheMirrorBatch_) {
+        return false;
+      }
+      for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+        if (cacheSlotMirror_[i]) {
+          return true;
+        }
+      }
+      return false;
     }
 };
 #endif  // SdFat_h
@@ -71,7 +71,7 @@ dir_t* SdFile::cacheDirEntry(uint8_t action) {
   if (!SdVolume::cacheRawBlock(dirBlock_, action)) {
     return NULL;
   }
-  return SdVolume::cacheBuffer_.dir + dirIndex_;
+  return SdVolume::cacheBuffer_->dir + dirIndex_;
 }
 //------------------------------------------------------------------------------
 /**
@@ -83,6 +83,10 @@ dir_t* SdFile::cacheDirEntry(uint8_t action) {
    Reasons for failure include no file is open or an I/O error.
 */
 uint8_t SdFile::close(void) {
+  // an SdFile that was never opened has no extent to give back
+  if (isOpen() && preAllocClusters_ && !freePreAllocation()) {
+    return false;
+  }
   if (!sync()) {
     return false;
   }
@@ -170,6 +174,34 @@ uint8_t SdFile::createContiguous(SdFile* dirFile,
   return sync();
 }
 //------------------------------------------------------------------------------
+// free clusters reserved by preAllocate() that are past the end of file
+uint8_t SdFile::freePreAllocation(void) {
+  uint32_t count = preAllocClusters_;
+  preAllocClusters_ = 0;
+
+  // clusters that hold file data
+  uint32_t used = fileSize_ == 0 ? 0
+                  : ((fileSize_ - 1) >> (vol_->clusterSizeShift_ + 9)) + 1;
+  if (used >= count) {
+    // extent filled - chain already ends with end of chain mark
+    return true;
+  }
+  if (used == 0) {
+    if (!vol_->freeChain(firstCluster_)) {
+      return false;
+    }
+    firstCluster_ = 0;
+    flags_ |= F_FILE_DIR_DIRTY;
+    return true;
+  }
+  // extent is contiguous so the last data cluster is known without a walk
+  uint32_t last = firstCluster_ + used - 1;
+  if (!vol_->freeChain(last + 1)) {
+    return false;
+  }
+  return vol_->fatPutEOC(last);
+}
+//------------------------------------------------------------------------------
 /**
    Return a files directory entry
 
@@ -216,6 +248,32 @@ void SdFile::dirName(const dir_t& dir, char* name) {
   name[j] = 0;
 }
 //------------------------------------------------------------------------------
+/**
+   Format the name of the directory entry at \a dirIndex in \a dirBlock,
+   read through the cache, without opening the file.
+
+   \param[in] dirBlock The SD block that holds the entry.
+   \param[in] dirIndex The index of the entry in \a dirBlock.
+   \param[out] name A 13 byte char array for the formatted name.
+
+   \return The value one, true, is returned for a file or subdirectory
+   entry.  The value zero, false, is returned for a free, deleted, dot or
+   volume label entry or an I/O error.
+*/
+uint8_t SdFile::entryName(uint32_t dirBlock, uint8_t dirIndex, char* name) {
+  if (dirIndex > 0XF ||
+      !SdVolume::cacheRawBlock(dirBlock, SdVolume::CACHE_FOR_READ)) {
+    return false;
+  }
+  dir_t* p = SdVolume::cacheBuffer_->dir + dirIndex;
+  if (p->name[0] == DIR_NAME_FREE || p->name[0] == DIR_NAME_DELETED ||
+      p->name[0] == '.' || !DIR_IS_FILE_OR_SUBDIR(p)) {
+    return false;
+  }
+  dirName(*p, name);
+  return true;
+}
+//------------------------------------------------------------------------------
 /** List directory contents to Serial.
 
    \param[in] flags The inclusive OR of
@@ -307,7 +365,7 @@ uint8_t SdFile::make83Name(const char* str, uint8_t* name) {
       while ((b = pgm_read_byte(p++))) if (b == c) {
           return false;
         }
-      #elif defined(__arm__)
+      #else
       const uint8_t valid[] = "|<>^+=?/[];,*\"\\";
       const uint8_t *p = valid;
       while ((b = *p++)) if (b == c) {
@@ -383,7 +441,7 @@ uint8_t SdFile::makeDir(SdFile* dir, const char* dirName) {
   }
 
   // copy '.' to block
-  memcpy(&SdVolume::cacheBuffer_.dir[0], &d, sizeof(d));
+  memcpy(&SdVolume::cacheBuffer_->dir[0], &d, sizeof(d));
 
   // make entry for '..'
   d.name[1] = '.';
@@ -395,7 +453,7 @@ uint8_t SdFile::makeDir(SdFile* dir, const char* dirName) {
     d.firstClusterHigh = dir->firstCluster_ >> 16;
   }
   // copy '..' to block
-  memcpy(&SdVolume::cacheBuffer_.dir[1], &d, sizeof(d));
+  memcpy(&SdVolume::cacheBuffer_->dir[1], &d, sizeof(d));
 
   // set position after '..'
   curPosition_ = 2 * sizeof(d);
@@ -436,7 +494,8 @@ uint8_t SdFile::makeDir(SdFile* dir, const char* dirName) {
    O_SYNC - Call sync() after each write.  This flag should not be used with
    write(uint8_t), write_P(PGM_P), writeln_P(PGM_P), or the Arduino Print class.
    These functions do character at a time writes so sync() will be called
-   after each byte.
+   after each byte.  With O_SYNC, sync() and close() also write through
+   under SD_SYNC_DEFERRED.
 
    O_TRUNC - If the file exists and is a regular file, and the file is
    successfully opened and is not read only, its length shall be truncated to 0.
@@ -520,7 +579,7 @@ uint8_t SdFile::open(SdFile* dirFile, const char* fileName, uint8_t oflag) {
 
     // use first entry in cluster
     dirIndex_ = 0;
-    p = SdVolume::cacheBuffer_.dir;
+    p = SdVolume::cacheBuffer_->dir;
   }
   // initialize as empty file
   memset(p, 0, sizeof(dir_t));
@@ -539,8 +598,9 @@ uint8_t SdFile::open(SdFile* dirFile, const char* fileName, uint8_t oflag) {
   p->lastWriteDate = p->creationDate;
   p->lastWriteTime = p->creationTime;
 
-  // force write of entry to SD
-  if (!SdVolume::cacheFlush()) {
+  // force write of entry to SD, unless deferred like sync()
+  if ((SdVolume::syncPolicy_ != SD_SYNC_DEFERRED || (oflag & O_SYNC)) &&
+      !SdVolume::cacheFlush()) {
     return false;
   }
 
@@ -595,10 +655,59 @@ uint8_t SdFile::open(SdFile* dirFile, uint16_t index, uint8_t oflag) {
   return openCachedEntry(index & 0XF, oflag);
 }
 //------------------------------------------------------------------------------
+/**
+   Open a file by the location of its directory entry.
+
+   \param[in] vol The volume that contains the file.
+
+   \param[in] dirBlock The block that contains the file's directory entry,
+   as returned by dirBlock() for an earlier open of the file.
+
+   \param[in] dirIndex The index of the entry in \a dirBlock, as returned
+   by dirIndex().
+
+   \param[in] oflag Values for \a oflag are constructed by a bitwise-inclusive
+   OR of flags O_READ, O_WRITE, O_TRUNC, and O_SYNC.
+
+   No directory is searched, so the caller must know that the entry still
+   holds the expected file.  A free or deleted entry is an error.
+
+   See open() by fileName for definition of flags and return values.
+
+*/
+uint8_t SdFile::open(SdVolume* vol, uint32_t dirBlock, uint8_t dirIndex,
+                     uint8_t oflag) {
+  // error if already open or bad index
+  if (isOpen() || dirIndex > 0XF) {
+    return false;
+  }
+
+  // don't open existing file if O_CREAT and O_EXCL - user call error
+  if ((oflag & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL)) {
+    return false;
+  }
+
+  vol_ = vol;
+
+  // read entry into cache
+  if (!SdVolume::cacheRawBlock(dirBlock, SdVolume::CACHE_FOR_READ)) {
+    return false;
+  }
+  dir_t* p = SdVolume::cacheBuffer_->dir + dirIndex;
+
+  // error if empty slot or '.' or '..'
+  if (p->name[0] == DIR_NAME_FREE ||
+      p->name[0] == DIR_NAME_DELETED || p->name[0] == '.') {
+    return false;
+  }
+  // open cached entry
+  return openCachedEntry(dirIndex, oflag);
+}
+//------------------------------------------------------------------------------
 // open a cached directory entry. Assumes vol_ is initializes
 uint8_t SdFile::openCachedEntry(uint8_t dirIndex, uint8_t oflag) {
   // location of entry in cache
-  dir_t* p = SdVolume::cacheBuffer_.dir + dirIndex;
+  dir_t* p = SdVolume::cacheBuffer_->dir + dirIndex;
 
   // write or truncate is an error for a directory or read-only file
   if (p->attributes & (DIR_ATT_READ_ONLY | DIR_ATT_DIRECTORY)) {
@@ -628,6 +737,10 @@ uint8_t SdFile::openCachedEntry(uint8_t dirIndex, uint8_t oflag) {
   }
   // save open flags for read/write
   flags_ = oflag & (O_ACCMODE | O_SYNC | O_APPEND);
+  preAllocClusters_ = 0;
+  #if SD_READ_AHEAD_BLOCKS
+  readAheadReset();
+  #endif  // SD_READ_AHEAD_BLOCKS
 
   // set to start of file
   curCluster_ = 0;
@@ -673,6 +786,10 @@ uint8_t SdFile::openRoot(SdVolume* vol) {
   vol_ = vol;
   // read only
   flags_ = O_READ;
+  preAllocClusters_ = 0;
+  #if SD_READ_AHEAD_BLOCKS
+  readAheadReset();
+  #endif  // SD_READ_AHEAD_BLOCKS
 
   // set to start of file
   curCluster_ = 0;
@@ -684,6 +801,39 @@ uint8_t SdFile::openRoot(SdVolume* vol) {
   return true;
 }
 //------------------------------------------------------------------------------
+/**
+   Reserve a contiguous extent for an empty file.
+
+   \param[in] length Expected file size in bytes.
+
+   The clusters are linked into the file's chain when this is called, so
+   write() streams into them without any FAT updates.  close() frees the
+   clusters past the end of file with a single chain update.  Writing more
+   than \a length bytes is allowed; the file then grows as usual.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+   Reasons for failure include the file is not open for write, is not
+   empty, or the volume has no contiguous free space of that size.
+*/
+uint8_t SdFile::preAllocate(uint32_t length) {
+  // only for empty files open for write
+  if (!isFile() || !(flags_ & O_WRITE) || firstCluster_ != 0 || length == 0) {
+    return false;
+  }
+  // calculate number of clusters needed
+  uint32_t count = ((length - 1) >> (vol_->clusterSizeShift_ + 9)) + 1;
+
+  if (!vol_->allocContiguous(count, &firstCluster_)) {
+    return false;
+  }
+  preAllocClusters_ = count;
+
+  // insure sync() will record the first cluster
+  flags_ |= F_FILE_DIR_DIRTY;
+  return true;
+}
+//------------------------------------------------------------------------------
 /** %Print the name field of a directory entry in 8.3 format to Serial.
 
    \param[in] dir The directory structure containing the name.
@@ -779,6 +929,13 @@ int16_t SdFile::read(void* buf, uint16_t nbyte) {
     nbyte = fileSize_ - curPosition_;
   }
 
+  #if SD_READ_AHEAD_BLOCKS
+  // prefetch only while reads continue where the last one ended
+  if (curPosition_ != readAheadPos_) {
+    readAheadBlocks_ = 0;
+  }
+  #endif  // SD_READ_AHEAD_BLOCKS
+
   // amount left to read
   uint16_t toRead = nbyte;
   while (toRead > 0) {
@@ -804,6 +961,23 @@ int16_t SdFile::read(void* buf, uint16_t nbyte) {
     }
     uint16_t n = toRead;
 
+    #if SD_MULTI_BLOCK_READ_MIN
+    if (offset == 0 && type_ != FAT_FILE_TYPE_ROOT16 &&
+        (toRead >> 9) >= SD_MULTI_BLOCK_READ_MIN &&
+        SdVolume::cacheFind(block) == SD_CACHE_SLOTS) {
+      // run of whole blocks - read straight into caller's buffer
+      uint16_t nBlocks = readMultiple(block, dst, toRead >> 9);
+      if (nBlocks == 0) {
+        return -1;
+      }
+      n = nBlocks << 9;
+      dst += n;
+      curPosition_ += n;
+      toRead -= n;
+      continue;
+    }
+    #endif  // SD_MULTI_BLOCK_READ_MIN
+
     // amount to be read from current block
     if (n > (512 - offset)) {
       n = 512 - offset;
@@ -811,17 +985,25 @@ int16_t SdFile::read(void* buf, uint16_t nbyte) {
 
     // no buffering needed if n == 512 or user requests no buffering
     if ((unbufferedRead() || n == 512) &&
-        block != SdVolume::cacheBlockNumber_) {
+        SdVolume::cacheFind(block) == SD_CACHE_SLOTS) {
       if (!vol_->readData(block, offset, n, dst)) {
         return -1;
       }
       dst += n;
     } else {
       // read block to cache and copy data to caller
-      if (!SdVolume::cacheRawBlock(block, SdVolume::CACHE_FOR_READ)) {
+      uint8_t ahead = 0;
+      #if SD_READ_AHEAD_BLOCKS
+      // directories are read an entry at a time and their blocks are
+      // rewritten as metadata, so only regular files prefetch
+      if (isFile() && SdVolume::cacheFind(block) == SD_CACHE_SLOTS) {
+        ahead = readAheadCount();
+      }
+      #endif  // SD_READ_AHEAD_BLOCKS
+      if (!SdVolume::cacheRawBlock(block, SdVolume::CACHE_FOR_READ, ahead)) {
         return -1;
       }
-      uint8_t* src = SdVolume::cacheBuffer_.data + offset;
+      uint8_t* src = SdVolume::cacheBuffer_->data + offset;
       uint8_t* end = src + n;
       while (src != end) {
         *dst++ = *src++;
@@ -830,8 +1012,93 @@ int16_t SdFile::read(void* buf, uint16_t nbyte) {
     curPosition_ += n;
     toRead -= n;
   }
+  #if SD_READ_AHEAD_BLOCKS
+  readAheadPos_ = curPosition_;
+  #endif  // SD_READ_AHEAD_BLOCKS
   return nbyte;
 }
+#if SD_READ_AHEAD_BLOCKS
+//------------------------------------------------------------------------------
+// Blocks to prefetch for a sequential miss at the current position, then
+// widen the window for the next miss.  Prefetch stays inside the current
+// cluster, whose blocks are known to be contiguous, and the file.
+uint8_t SdFile::readAheadCount(void) {
+  uint8_t count = readAheadBlocks_;
+  uint8_t inCluster = vol_->blocksPerCluster_ - 1
+                      - vol_->blockOfCluster(curPosition_);
+  uint32_t inFile = fileSize_ ? ((fileSize_ - 1) >> 9) - (curPosition_ >> 9) : 0;
+  if (count > inCluster) {
+    count = inCluster;
+  }
+  if (count > inFile) {
+    count = inFile;
+  }
+  if (readAheadBlocks_ == 0) {
+    readAheadBlocks_ = 1;
+  } else if (readAheadBlocks_ < SD_READ_AHEAD_BLOCKS) {
+    readAheadBlocks_ <<= 1;
+    if (readAheadBlocks_ > SD_READ_AHEAD_BLOCKS) {
+      readAheadBlocks_ = SD_READ_AHEAD_BLOCKS;
+    }
+  }
+  return count;
+}
+#endif  // SD_READ_AHEAD_BLOCKS
+#if SD_MULTI_BLOCK_READ_MIN
+//------------------------------------------------------------------------------
+// Read whole blocks starting at the current position with one multiple
+// block read.  The run extends into following clusters of the chain for
+// as long as they are physically contiguous.  The current position must
+// be block aligned and curCluster_ must hold it.  Leaves curCluster_ at
+// the cluster of the last block read.
+// return number of blocks read or zero for failure
+uint16_t SdFile::readMultiple(uint32_t block, uint8_t* dst,
+                              uint16_t maxBlocks) {
+  uint8_t blockOfCluster = vol_->blockOfCluster(curPosition_);
+  uint16_t nBlocks = vol_->blocksPerCluster_ - blockOfCluster;
+  uint32_t lastCluster = curCluster_;
+
+  while (nBlocks < maxBlocks) {
+    uint32_t next;
+    if (!vol_->fatGet(lastCluster, &next)) {
+      return 0;
+    }
+    if (next != lastCluster + 1) {
+      // end of chain or fragmented - the normal path follows the chain
+      break;
+    }
+    lastCluster = next;
+    nBlocks += vol_->blocksPerCluster_;
+  }
+  if (nBlocks > maxBlocks) {
+    nBlocks = maxBlocks;
+  }
+
+  // the card has stale data if a block in the run is dirty in the cache
+  if (!SdVolume::cacheFlushRange(block, nBlocks)) {
+    return 0;
+  }
+
+  if (!vol_->readStart(block)) {
+    return 0;
+  }
+  for (uint16_t i = 0; i < nBlocks; i++) {
+    if (!vol_->readData(dst)) {
+      // return the card to transfer state
+      vol_->readStop();
+      return 0;
+    }
+    dst += 512;
+  }
+  if (!vol_->readStop()) {
+    return 0;
+  }
+
+  // cluster that holds the last block read
+  curCluster_ += (blockOfCluster + nBlocks - 1) >> vol_->clusterSizeShift_;
+  return nBlocks;
+}
+#endif  // SD_MULTI_BLOCK_READ_MIN
 //------------------------------------------------------------------------------
 /**
    Read the next directory entry from a directory file.
@@ -889,7 +1156,7 @@ dir_t* SdFile::readDirCache(void) {
   curPosition_ += 31;
 
   // return pointer to entry
-  return (SdVolume::cacheBuffer_.dir + i);
+  return (SdVolume::cacheBuffer_->dir + i);
 }
 //------------------------------------------------------------------------------
 /**
@@ -954,6 +1221,110 @@ uint8_t SdFile::remove(SdFile* dirFile, const char* fileName) {
   return file.remove();
 }
 //------------------------------------------------------------------------------
+/**
+   Remove many files in a directory.
+
+   Unlike remove() for each file, entries are marked deleted in the cache and
+   each directory block is written once, with the cluster chains of its
+   entries freed after it is on the SD.  FAT blocks are written as the cache
+   evicts them and at the end, so each is written about once however many
+   files it maps.  Subdirectories and read-only files are skipped.
+
+   \param[in] match Called with the 8.3 name of each file, as returned by
+   dirName(); the file is removed if it returns true.  NULL removes every
+   file.
+
+   \param[in] context Passed to \a match.
+
+   \param[out] count Number of files removed, also set on failure.  May be
+   NULL.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+   Reasons for failure include this SdFile is not a directory
+   or an I/O error occurred.
+*/
+uint8_t SdFile::removeFiles(uint8_t (*match)(const char* name, void* context),
+                            void* context, uint16_t* count) {
+  // first clusters of entries deleted in the current directory block
+  uint32_t chains[16];
+  uint8_t nChains = 0;
+  uint8_t pending = 0;
+  uint16_t removed = 0;
+  uint8_t rtn = false;
+
+  if (!isDir()) {
+    goto done;
+  }
+  rewind();
+  while (curPosition_ < fileSize_) {
+    dir_t* p = readDirCache();
+    if (!p) {
+      goto done;
+    }
+
+    // done if past last entry
+    if (p->name[0] == DIR_NAME_FREE) {
+      break;
+    }
+
+    // only undeleted files that may be written
+    if (p->name[0] != DIR_NAME_DELETED && p->name[0] != '.' &&
+        DIR_IS_FILE(p) && !(p->attributes & DIR_ATT_READ_ONLY)) {
+      char name[13];
+      dirName(*p, name);
+      if (!match || match(name, context)) {
+        uint32_t cluster = (uint32_t)p->firstClusterHigh << 16;
+        cluster |= p->firstClusterLow;
+        p->name[0] = DIR_NAME_DELETED;
+        SdVolume::cacheSetDirty();
+        if (cluster) {
+          chains[nChains++] = cluster;
+        }
+        pending = true;
+        removed++;
+      }
+    }
+
+    // leaving a directory block with deleted entries
+    if (pending && (curPosition_ & 0X1FF) == 0) {
+      if (!removeFlush(chains, nChains)) {
+        goto done;
+      }
+      nChains = 0;
+      pending = false;
+    }
+  }
+  if (pending && !removeFlush(chains, nChains)) {
+    goto done;
+  }
+  if (!SdVolume::cacheFlush()) {
+    goto done;
+  }
+  rtn = vol_->syncFsInfo();
+
+done:
+  if (count) {
+    *count = removed;
+  }
+  return rtn;
+}
+//------------------------------------------------------------------------------
+// Write the directory block holding just deleted entries, then free their
+// cluster chains, so the SD never has an entry for a freed chain.  The flush
+// also writes FAT blocks freed for earlier directory blocks.
+uint8_t SdFile::removeFlush(uint32_t* chains, uint8_t count) {
+  if (!SdVolume::cacheFlush()) {
+    return false;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    if (!vol_->freeChain(chains[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
 /** Remove a directory file.
 
    The directory file will be removed only if it is empty and is not the
@@ -1127,7 +1498,8 @@ uint8_t SdFile::seekSet(uint32_t pos) {
    \return The value one, true, is returned for success and
    the value zero, false, is returned for failure.
    Reasons for failure include a call to sync() before a file has been
-   opened or an I/O error.
+   opened or an I/O error.  The FAT32 FSINFO free count is not written,
+   see SdVolume::sync().
 */
 uint8_t SdFile::sync(uint8_t blocking) {
   // only allow open files and directories
@@ -1157,13 +1529,29 @@ uint8_t SdFile::sync(uint8_t blocking) {
     }
     // clear directory dirty
     flags_ &= ~F_FILE_DIR_DIRTY;
+    SdVolume::entryUpdates_++;
+  }
+
+  // deferred: entry and FAT stay in the cache until SdVolume::sync()
+  if (SdVolume::syncPolicy_ == SD_SYNC_DEFERRED && !(flags_ & O_SYNC)) {
+    if (!blocking) {
+      flags_ &= ~F_FILE_NON_BLOCKING_WRITE;
+    }
+    SdVolume::deferredSyncs_++;
+    return true;
   }
 
   if (!blocking) {
     flags_ &= ~F_FILE_NON_BLOCKING_WRITE;
+    return SdVolume::cacheFlush(blocking);
   }
 
-  return SdVolume::cacheFlush(blocking);
+  if (!SdVolume::cacheFlush()) {
+    return false;
+  }
+  SdVolume::syncs_++;
+  // the FSINFO free count is only a hint; SdVolume::sync() writes it
+  return true;
 }
 //------------------------------------------------------------------------------
 /**
@@ -1300,6 +1688,9 @@ uint8_t SdFile::truncate(uint32_t length) {
   }
   fileSize_ = length;
 
+  // any preallocated tail was freed with the chain
+  preAllocClusters_ = 0;
+
   // need to update directory entry
   flags_ |= F_FILE_DIR_DIRTY;
 
@@ -1387,12 +1778,24 @@ size_t SdFile::write(const void* buf, uint16_t nbyte) {
 
     // block for data write
     uint32_t block = vol_->clusterStartBlock(curCluster_) + blockOfCluster;
+    #if SD_MULTI_BLOCK_WRITE_MIN
+    if (blockOffset == 0 && (nToWrite >> 9) >= SD_MULTI_BLOCK_WRITE_MIN) {
+      // run of whole blocks - send as one multiple block write
+      uint16_t nBlocks = writeMultiple(block, src, nToWrite >> 9);
+      if (nBlocks == 0) {
+        goto writeErrorReturn;
+      }
+      n = nBlocks << 9;
+      src += n;
+      nToWrite -= n;
+      curPosition_ += n;
+      continue;
+    }
+    #endif  // SD_MULTI_BLOCK_WRITE_MIN
     if (n == 512) {
       // full block - don't need to use cache
       // invalidate cache if block is in cache
-      if (SdVolume::cacheBlockNumber_ == block) {
-        SdVolume::cacheBlockNumber_ = 0XFFFFFFFF;
-      }
+      SdVolume::cacheInvalidate(block, 1);
       if (!vol_->writeBlock(block, src, blocking)) {
         goto writeErrorReturn;
       }
@@ -1400,18 +1803,18 @@ size_t SdFile::write(const void* buf, uint16_t nbyte) {
     } else {
       if (blockOffset == 0 && curPosition_ >= fileSize_) {
         // start of new block don't need to read into cache
-        if (!SdVolume::cacheFlush()) {
+        if (!SdVolume::cacheNewBlock(block,
+                                     SdVolume::CACHE_FOR_WRITE | SdVolume::CACHE_DATA)) {
           goto writeErrorReturn;
         }
-        SdVolume::cacheBlockNumber_ = block;
-        SdVolume::cacheSetDirty();
       } else {
         // rewrite part of block
-        if (!SdVolume::cacheRawBlock(block, SdVolume::CACHE_FOR_WRITE)) {
+        if (!SdVolume::cacheRawBlock(block,
+                                     SdVolume::CACHE_FOR_WRITE | SdVolume::CACHE_DATA)) {
           goto writeErrorReturn;
         }
       }
-      uint8_t* dst = SdVolume::cacheBuffer_.data + blockOffset;
+      uint8_t* dst = SdVolume::cacheBuffer_->data + blockOffset;
       uint8_t* end = dst + n;
       while (dst != end) {
         *dst++ = *src++;
@@ -1429,7 +1832,7 @@ size_t SdFile::write(const void* buf, uint16_t nbyte) {
     flags_ |= F_FILE_DIR_DIRTY;
   }
 
-  if (flags_ & O_SYNC) {
+  if ((flags_ & O_SYNC) || SdVolume::syncPolicy_ == SD_SYNC_WRITE) {
     if (!sync()) {
       goto writeErrorReturn;
     }
@@ -1442,6 +1845,69 @@ writeErrorReturn:
   setWriteError();
   return 0;
 }
+#if SD_MULTI_BLOCK_WRITE_MIN
+//------------------------------------------------------------------------------
+// Write whole blocks starting at the current position with one multiple
+// block write.  The run extends into following clusters, allocating them
+// at the end of the chain, for as long as they are physically contiguous.
+// The current position must be block aligned and curCluster_ must hold it.
+// Leaves curCluster_ at the cluster of the last block written.
+// return number of blocks written or zero for failure
+uint16_t SdFile::writeMultiple(uint32_t block, const uint8_t* src,
+                               uint16_t maxBlocks) {
+  uint8_t blockOfCluster = vol_->blockOfCluster(curPosition_);
+  uint16_t nBlocks = vol_->blocksPerCluster_ - blockOfCluster;
+  uint32_t lastCluster = curCluster_;
+
+  while (nBlocks < maxBlocks) {
+    uint32_t next;
+    if (!vol_->fatGet(lastCluster, &next)) {
+      return 0;
+    }
+    if (vol_->isEOC(next)) {
+      // allocContiguous() tries lastCluster + 1 first
+      next = lastCluster;
+      if (!vol_->allocContiguous(1, &next)) {
+        return 0;
+      }
+      flags_ |= F_FILE_CLUSTER_ADDED;
+    }
+    if (next != lastCluster + 1) {
+      // fragmented - the normal path follows the chain from here
+      break;
+    }
+    lastCluster = next;
+    nBlocks += vol_->blocksPerCluster_;
+  }
+  if (nBlocks > maxBlocks) {
+    nBlocks = maxBlocks;
+  }
+
+  // a cached copy of any block in the run is replaced by this write
+  SdVolume::cacheInvalidate(block, nBlocks);
+
+  // pre-erase hint lets the card program the run without read-modify-write
+  if (!vol_->writeStart(block, nBlocks)) {
+    return 0;
+  }
+  for (uint16_t i = 0; i < nBlocks; i++) {
+    if (!vol_->writeData(src)) {
+      // end the transfer so the next command finds the card in transfer state
+      vol_->writeStop();
+      return 0;
+    }
+    src += 512;
+  }
+  // a non-blocking write leaves the card programming the run
+  if (!vol_->writeStop((flags_ & F_FILE_NON_BLOCKING_WRITE) == 0)) {
+    return 0;
+  }
+
+  // cluster that holds the last block written
+  curCluster_ += (blockOfCluster + nBlocks - 1) >> vol_->clusterSizeShift_;
+  return nBlocks;
+}
+#endif  // SD_MULTI_BLOCK_WRITE_MIN
 //------------------------------------------------------------------------------
 /**
    Write a byte to a file. Required by the Arduino Print class.
@@ -18,14 +18,40 @@
    <http://www.gnu.org/licenses/>.
 */
 #include "SdFat.h"
+#include <stdlib.h>
+#if SD_FREE_CLUSTER_BITMAP && defined(ESP32)
+  #include <esp_heap_caps.h>
+#endif
 //------------------------------------------------------------------------------
-// raw block cache
+// raw block cache - slots are invalidated by cacheReset() in init()
+cache_t  SdVolume::cacheSlots_[SD_CACHE_SLOTS];       // block buffers
+uint32_t SdVolume::cacheSlotBlock_[SD_CACHE_SLOTS];   // block held by slot
+uint32_t SdVolume::cacheSlotMirror_[SD_CACHE_SLOTS];  // mirror FAT block or 0
+uint32_t SdVolume::cacheSlotUse_[SD_CACHE_SLOTS];     // LRU stamp
+uint8_t  SdVolume::cacheSlotFlags_[SD_CACHE_SLOTS];   // dirty and data flags
+uint32_t SdVolume::cacheUseCount_ = 0;
+uint8_t  SdVolume::cacheCurrent_ = 0;
+cache_t* SdVolume::cacheBuffer_ = &SdVolume::cacheSlots_[0];
 // init cacheBlockNumber_to invalid SD block number
 uint32_t SdVolume::cacheBlockNumber_ = 0XFFFFFFFF;
-cache_t  SdVolume::cacheBuffer_;     // 512 byte cache for Sd2Card
+uint32_t SdVolume::cacheFatStart_ = 0;
+uint32_t SdVolume::cacheFatEnd_ = 0;
+uint32_t SdVolume::cacheHits_ = 0;
+uint32_t SdVolume::cacheMisses_ = 0;
+uint32_t SdVolume::readAheadBlocks_ = 0;
+uint32_t SdVolume::readAheadHits_ = 0;
+uint8_t  SdVolume::cacheMirrorBatch_ = SD_FAT_MIRROR_BATCH;
+uint32_t SdVolume::cacheMirrorStale_[SD_FAT_MIRROR_STALE];
+uint8_t  SdVolume::cacheMirrorEvicted_ = 0;
+uint32_t SdVolume::cacheMirrorOffset_ = 0;
+uint32_t SdVolume::fatWrites_ = 0;
+uint32_t SdVolume::fatMirrorWrites_ = 0;
+uint32_t SdVolume::dirWrites_ = 0;
+uint32_t SdVolume::entryUpdates_ = 0;
+uint32_t SdVolume::syncs_ = 0;
+uint32_t SdVolume::deferredSyncs_ = 0;
+uint8_t  SdVolume::syncPolicy_ = SD_SYNC_POLICY;
 Sd2Card* SdVolume::sdCard_;          // pointer to SD card object
-uint8_t  SdVolume::cacheDirty_ = 0;  // cacheFlush() will write block if true
-uint32_t SdVolume::cacheMirrorBlock_ = 0;  // mirror  block for second FAT
 //------------------------------------------------------------------------------
 // find a contiguous group of clusters
 uint8_t SdVolume::allocContiguous(uint32_t count, uint32_t* curCluster) {
@@ -55,28 +81,42 @@ uint8_t SdVolume::allocContiguous(uint32_t count, uint32_t* curCluster) {
   // last cluster of FAT
   uint32_t fatEnd = clusterCount_ + 1;
 
-  // search the FAT for free clusters
-  for (uint32_t n = 0;; n++, endCluster++) {
-    // can't find space checked all clusters
-    if (n >= clusterCount_) {
+  if (SD_AU_ALIGN_MIN_BLOCKS && *curCluster == 0 && auClusters_ &&
+      (count << clusterSizeShift_) >= SD_AU_ALIGN_MIN_BLOCKS &&
+      findAligned(count, &bgnCluster)) {
+    // large extent starts on an allocation unit boundary
+    endCluster = bgnCluster + count - 1;
+    alignedExtents_++;
+  } else if (freeBitmapReady()) {
+    // search the bitmap for free clusters
+    if (!bitmapFindFree(bgnCluster, count, &bgnCluster)) {
       return false;
     }
+    endCluster = bgnCluster + count - 1;
+  } else {
+    // search the FAT for free clusters
+    for (uint32_t n = 0;; n++, endCluster++) {
+      // can't find space checked all clusters
+      if (n >= clusterCount_) {
+        return false;
+      }
 
-    // past end - start from beginning of FAT
-    if (endCluster > fatEnd) {
-      bgnCluster = endCluster = 2;
-    }
-    uint32_t f;
-    if (!fatGet(endCluster, &f)) {
-      return false;
-    }
+      // past end - start from beginning of FAT
+      if (endCluster > fatEnd) {
+        bgnCluster = endCluster = 2;
+      }
+      uint32_t f;
+      if (!fatGet(endCluster, &f)) {
+        return false;
+      }
 
-    if (f != 0) {
-      // cluster in use try next cluster as bgnCluster
-      bgnCluster = endCluster + 1;
-    } else if ((endCluster - bgnCluster + 1) == count) {
-      // done - found space
-      break;
+      if (f != 0) {
+        // cluster in use try next cluster as bgnCluster
+        bgnCluster = endCluster + 1;
+      } else if ((endCluster - bgnCluster + 1) == count) {
+        // done - found space
+        break;
+      }
     }
   }
   // mark end of chain
@@ -108,61 +148,564 @@ uint8_t SdVolume::allocContiguous(uint32_t count, uint32_t* curCluster) {
   return true;
 }
 //------------------------------------------------------------------------------
-uint8_t SdVolume::cacheFlush(uint8_t blocking) {
-  if (cacheDirty_) {
-    if (!sdCard_->writeBlock(cacheBlockNumber_, cacheBuffer_.data, blocking)) {
-      return false;
+// find count free clusters in the bitmap, searching from bgnCluster with
+// wrap around.  Words with every cluster in use are skipped whole.
+uint8_t SdVolume::bitmapFindFree(uint32_t bgnCluster, uint32_t count,
+                                 uint32_t* found) const {
+  uint32_t fatEnd = clusterCount_ + 1;
+  uint32_t c = bgnCluster;
+  uint32_t run = 0;
+
+  for (uint32_t n = 0; n < clusterCount_ + 2;) {
+    if (c > fatEnd) {
+      // a group can't wrap past the end of the FAT
+      c = 2;
+      run = 0;
+    }
+    uint32_t word = freeBitmap_[c >> 5];
+    if ((c & 31) == 0 && word == 0XFFFFFFFF) {
+      // all 32 clusters in use
+      run = 0;
+      c += 32;
+      n += 32;
+    } else if ((c & 31) == 0 && word == 0 && count - run > 32) {
+      // all 32 clusters free and group not complete in this word
+      run += 32;
+      c += 32;
+      n += 32;
+    } else {
+      if (word & (1UL << (c & 31))) {
+        run = 0;
+      } else if (++run == count) {
+        *found = c - count + 1;
+        return true;
+      }
+      c++;
+      n++;
     }
+  }
+  return false;
+}
+//------------------------------------------------------------------------------
+// find count free clusters whose first one starts an allocation unit,
+// searching AU boundaries from allocSearchStart_ with wrap around
+uint8_t SdVolume::findAligned(uint32_t count, uint32_t* found) const {
+  uint32_t fatEnd = clusterCount_ + 1;
+  uint32_t c = auAlignUp(allocSearchStart_);
+  uint32_t checked = 0;
 
-    if (!blocking) {
+  while (checked < clusterCount_) {
+    if (c + count - 1 > fatEnd) {
+      // a group can't wrap past the end of the FAT
+      uint32_t first = auAlignUp(2);
+      if (c == first) {
+        // no group fits even at the first boundary
+        return false;
+      }
+      checked += c <= fatEnd ? fatEnd + 1 - c : 0;
+      c = first;
+      continue;
+    }
+    uint32_t i = 0;
+    for (; i < count; i++) {
+      uint32_t cluster = c + i;
+      uint32_t f;
+      if (freeBitmapReady()) {
+        f = freeBitmap_[cluster >> 5] & (1UL << (cluster & 31));
+      } else if (!fatGet(cluster, &f)) {
+        return false;
+      }
+      if (f != 0) {
+        break;
+      }
+    }
+    if (i == count) {
+      *found = c;
       return true;
     }
+    // next boundary past the cluster in use
+    uint32_t next = auAlignUp(c + i + 1);
+    checked += next - c;
+    c = next;
+  }
+  return false;
+}
+//------------------------------------------------------------------------------
+/**
+   Set the allocation unit (AU) of the card, see Sd2Card::allocationUnit().
+   Contiguous allocations of at least SD_AU_ALIGN_MIN_BLOCKS then start on
+   an AU boundary, so large files fill whole AUs in order and the card does
+   not copy data it was not given.
 
-    // mirror FAT tables
-    if (!cacheMirrorBlockFlush(blocking)) {
+   \param[in] blocks AU size in blocks, zero to stop aligning.
+
+   \return The value one, true, if large allocations are aligned and the
+   value zero, false, if \a blocks is zero or not a multiple of the cluster
+   size, no cluster starts on an AU boundary, or the volume holds no whole
+   AU.
+*/
+uint8_t SdVolume::setAllocationUnit(uint32_t blocks) {
+  auBlocks_ = blocks;
+  auClusters_ = 0;
+  if (blocks <= blocksPerCluster_ || (blocks & (blocksPerCluster_ - 1))) {
+    return false;
+  }
+  // blocks from the start of the data area to the first AU boundary
+  uint32_t lead = (blocks - dataStartBlock_ % blocks) % blocks;
+  if (lead & (blocksPerCluster_ - 1)) {
+    // formatted without regard to the AU, clusters straddle boundaries
+    return false;
+  }
+  auClusters_ = blocks >> clusterSizeShift_;
+  auPhase_ = (2 + (lead >> clusterSizeShift_)) % auClusters_;
+  if (auAlignUp(2) + auClusters_ - 1 > clusterCount_ + 1) {
+    // volume smaller than one aligned AU
+    auClusters_ = 0;
+    return false;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Scan the FAT into the free-cluster bitmap.
+
+   The scan is incremental so it can run in the background; the bitmap
+   is used for allocation and the free count is exact once it completes.
+   FAT updates made during the scan are tracked.  If the bitmap can't be
+   allocated the scan still produces the free count.
+
+   \param[in] maxBlocks Maximum number of FAT blocks to read in this call.
+
+   \return One when the scan is complete, zero if more blocks remain or
+   -1 for an I/O error or unsupported volume.
+*/
+int8_t SdVolume::buildFreeBitmap(uint32_t maxBlocks) {
+  uint32_t fatEnd = clusterCount_ + 1;
+  if (fatType_ != 16 && fatType_ != 32) {
+    return -1;
+  }
+  if (freeBitmapScan_ > fatEnd) {
+    return 1;
+  }
+  if (freeBitmapScan_ < 2) {
+    #if SD_FREE_CLUSTER_BITMAP
+    uint32_t words = (fatEnd >> 5) + 1;
+    if (!freeBitmap_ && 4 * words <= SD_FREE_BITMAP_MAX_BYTES) {
+      #if defined(ESP32)
+      freeBitmap_ = (uint32_t*)heap_caps_malloc(4 * words,
+                    MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+      #endif  // ESP32
+      if (!freeBitmap_) {
+        freeBitmap_ = (uint32_t*)malloc(4 * words);
+      }
+    }
+    if (freeBitmap_) {
+      for (uint32_t i = 0; i < words; i++) {
+        freeBitmap_[i] = 0;
+      }
+      // reserved clusters and bits past the end of the FAT read as in use
+      freeBitmap_[0] |= 3;
+      if ((fatEnd & 31) != 31) {
+        freeBitmap_[words - 1] |= 0XFFFFFFFF << ((fatEnd & 31) + 1);
+      }
+    }
+    #endif  // SD_FREE_CLUSTER_BITMAP
+    freeBitmapScan_ = 2;
+    scanFreeCount_ = 0;
+  }
+  uint16_t perBlock = fatType_ == 16 ? 256 : 128;
+  while (maxBlocks-- && freeBitmapScan_ <= fatEnd) {
+    uint32_t lba = fatStartBlock_;
+    lba += fatType_ == 16 ? freeBitmapScan_ >> 8 : freeBitmapScan_ >> 7;
+    if (!cacheRawBlock(lba, CACHE_FOR_READ)) {
+      return -1;
+    }
+    do {
+      uint32_t f = fatType_ == 16 ? cacheBuffer_->fat16[freeBitmapScan_ & 0XFF]
+                   : cacheBuffer_->fat32[freeBitmapScan_ & 0X7F] & FAT32MASK;
+      if (f == 0) {
+        scanFreeCount_++;
+      } else if (freeBitmap_) {
+        freeBitmap_[freeBitmapScan_ >> 5] |= 1UL << (freeBitmapScan_ & 31);
+      }
+      freeBitmapScan_++;
+    } while (freeBitmapScan_ <= fatEnd && (freeBitmapScan_ & (perBlock - 1)));
+  }
+  if (freeBitmapScan_ <= fatEnd) {
+    return 0;
+  }
+  if (freeClusters_ != scanFreeCount_) {
+    // correct a missing or stale FSINFO hint
+    freeClusters_ = scanFreeCount_;
+    fsInfoDirty_ = 1;
+  }
+  return 1;
+}
+//------------------------------------------------------------------------------
+// Write-back class of a slot.  Dirty slots are written in class order,
+// file data, then FAT, then directory and other metadata, so a crash
+// never leaves a directory entry or FAT chain pointing at unwritten data.
+uint8_t SdVolume::cacheClass(uint8_t slot) {
+  if (cacheSlotFlags_[slot] & CACHE_DATA) {
+    return 0;
+  }
+  uint32_t block = cacheSlotBlock_[slot];
+  return block >= cacheFatStart_ && block < cacheFatEnd_ ? 1 : 2;
+}
+//------------------------------------------------------------------------------
+// empty a slot, first writing dirty slots of earlier classes
+uint8_t SdVolume::cacheEvict(uint8_t slot) {
+  if (cacheSlotFlags_[slot] & CACHE_FOR_WRITE) {
+    uint8_t cls = cacheClass(slot);
+    for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+      if ((cacheSlotFlags_[i] & CACHE_FOR_WRITE) && cacheClass(i) < cls) {
+        if (!cacheWriteSlot(i, 1)) {
+          return false;
+        }
+      }
+    }
+    if (!cacheWriteSlot(slot, 1)) {
       return false;
     }
-    cacheDirty_ = 0;
+  }
+  if ((cacheSlotFlags_[slot] & CACHE_MIRROR_STALE) && !cacheMirrorEvict(slot)) {
+    return false;
+  }
+  cacheSlotBlock_[slot] = 0XFFFFFFFF;
+  cacheSlotFlags_[slot] = 0;
+  if (slot == cacheCurrent_) {
+    cacheBlockNumber_ = 0XFFFFFFFF;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+// return slot holding blockNumber or SD_CACHE_SLOTS if not cached
+uint8_t SdVolume::cacheFind(uint32_t blockNumber) {
+  if (cacheBlockNumber_ == blockNumber) {
+    return cacheCurrent_;
+  }
+  for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+    if (cacheSlotBlock_[i] == blockNumber) {
+      return i;
+    }
+  }
+  return SD_CACHE_SLOTS;
+}
+//------------------------------------------------------------------------------
+// Write all dirty slots in class order.  A non-blocking flush starts the
+// write of the first dirty slot and leaves it dirty, as the single block
+// cache did.
+//
+// A blocking flush is the transaction boundary for the second FAT.  With
+// cacheMirrorBatch_ set, FAT blocks written since the last flush have their
+// mirror copied here, after the primary FAT and before directory blocks,
+// giving the order data, FAT, mirror FAT, directory.  Between flushes the
+// mirror may lag the primary FAT; a directory block evicted early may reach
+// the card before the mirror, never before the primary FAT.
+uint8_t SdVolume::cacheFlush(uint8_t blocking) {
+  for (uint8_t cls = 0; cls < 3; cls++) {
+    for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+      if (!(cacheSlotFlags_[i] & CACHE_FOR_WRITE) || cacheClass(i) != cls) {
+        continue;
+      }
+      if (!cacheWriteSlot(i, blocking)) {
+        return false;
+      }
+      if (!blocking) {
+        return true;
+      }
+    }
+    if (cls == 1 && blocking && !cacheMirrorSync()) {
+      return false;
+    }
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+// write dirty slots holding blocks in [blockNumber, blockNumber + count)
+uint8_t SdVolume::cacheFlushRange(uint32_t blockNumber, uint32_t count) {
+  for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+    if ((cacheSlotFlags_[i] & CACHE_FOR_WRITE) &&
+        (cacheSlotBlock_[i] - blockNumber) < count) {
+      if (!cacheWriteSlot(i, 1)) {
+        return false;
+      }
+    }
   }
   return true;
 }
 //------------------------------------------------------------------------------
 uint8_t SdVolume::cacheMirrorBlockFlush(uint8_t blocking) {
-  if (cacheMirrorBlock_) {
-    if (!sdCard_->writeBlock(cacheMirrorBlock_, cacheBuffer_.data, blocking)) {
+  for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+    if (cacheSlotMirror_[i]) {
+      if (!sdCard_->writeBlock(cacheSlotMirror_[i], cacheSlots_[i].data, blocking)) {
+        return false;
+      }
+      fatMirrorWrites_++;
+      cacheSlotMirror_[i] = 0;
+      if (!blocking) {
+        return true;
+      }
+    }
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+// Remember the stale mirror of a FAT block leaving the cache for the next
+// cacheMirrorSync().  When the list is full write the mirror now, while the
+// slot still holds the block.
+uint8_t SdVolume::cacheMirrorEvict(uint8_t slot) {
+  if (cacheMirrorEvicted_ < SD_FAT_MIRROR_STALE) {
+    cacheMirrorStale_[cacheMirrorEvicted_++] = cacheSlotBlock_[slot];
+    cacheSlotFlags_[slot] &= ~CACHE_MIRROR_STALE;
+    return true;
+  }
+  return cacheMirrorWrite(slot);
+}
+//------------------------------------------------------------------------------
+// note that the mirror of the FAT block in slot must be written by the
+// next cacheMirrorSync()
+void SdVolume::cacheMirrorStale(uint8_t slot) {
+  uint32_t block = cacheSlotBlock_[slot];
+  cacheMirrorOffset_ = cacheSlotMirror_[slot] - block;
+  cacheSlotMirror_[slot] = 0;
+  cacheSlotFlags_[slot] |= CACHE_MIRROR_STALE;
+  // the slot flag now covers a block that was evicted and read back
+  for (uint8_t i = 0; i < cacheMirrorEvicted_; i++) {
+    if (cacheMirrorStale_[i] == block) {
+      cacheMirrorStale_[i] = cacheMirrorStale_[--cacheMirrorEvicted_];
+      break;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+// Copy FAT blocks with a stale mirror to the second FAT, each once.  Cached
+// ones are written from their slot.  Evicted ones are read back into a slot
+// other than the current one, so callers may keep using cacheBuffer_ across
+// cacheFlush().
+uint8_t SdVolume::cacheMirrorSync(void) {
+  for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+    if ((cacheSlotFlags_[i] & CACHE_MIRROR_STALE) && !cacheMirrorWrite(i)) {
       return false;
     }
-    cacheMirrorBlock_ = 0;
   }
+  while (cacheMirrorEvicted_) {
+    uint32_t block = cacheMirrorStale_[cacheMirrorEvicted_ - 1];
+    uint8_t slot = cacheFind(block);
+    if (slot == SD_CACHE_SLOTS) {
+      slot = cacheVictim();
+      if (slot == cacheCurrent_) {
+        slot = (slot + 1) % SD_CACHE_SLOTS;
+      }
+      if (!cacheEvict(slot)) {
+        return false;
+      }
+      if (!sdCard_->readBlock(block, cacheSlots_[slot].data)) {
+        return false;
+      }
+      cacheSlotBlock_[slot] = block;
+    }
+    if (!cacheMirrorWrite(slot)) {
+      return false;
+    }
+    cacheMirrorEvicted_--;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+// write the second FAT copy of the FAT block in slot
+uint8_t SdVolume::cacheMirrorWrite(uint8_t slot) {
+  if (!sdCard_->writeBlock(cacheSlotBlock_[slot] + cacheMirrorOffset_,
+                           cacheSlots_[slot].data)) {
+    return false;
+  }
+  fatMirrorWrites_++;
+  cacheSlotFlags_[slot] &= ~CACHE_MIRROR_STALE;
   return true;
 }
 //------------------------------------------------------------------------------
-uint8_t SdVolume::cacheRawBlock(uint32_t blockNumber, uint8_t action) {
-  if (cacheBlockNumber_ != blockNumber) {
-    if (!cacheFlush()) {
+// drop cached copies of blocks in [blockNumber, blockNumber + count) that
+// are being overwritten on the card
+void SdVolume::cacheInvalidate(uint32_t blockNumber, uint32_t count) {
+  for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+    if ((cacheSlotBlock_[i] - blockNumber) < count) {
+      cacheSlotBlock_[i] = 0XFFFFFFFF;
+      cacheSlotFlags_[i] = 0;
+      cacheSlotMirror_[i] = 0;
+      if (i == cacheCurrent_) {
+        cacheBlockNumber_ = 0XFFFFFFFF;
+      }
+    }
+  }
+}
+//------------------------------------------------------------------------------
+// make blockNumber current without reading it - caller fills the buffer
+uint8_t SdVolume::cacheNewBlock(uint32_t blockNumber, uint8_t action) {
+  uint8_t slot = cacheFind(blockNumber);
+  if (slot == SD_CACHE_SLOTS) {
+    slot = cacheVictim();
+    if (!cacheEvict(slot)) {
       return false;
     }
-    if (!sdCard_->readBlock(blockNumber, cacheBuffer_.data)) {
+    cacheSlotBlock_[slot] = blockNumber;
+  }
+  cacheSelect(slot);
+  cacheTag(slot, action);
+  return true;
+}
+//------------------------------------------------------------------------------
+// make blockNumber current, reading it on a miss along with up to ahead
+// following blocks
+uint8_t SdVolume::cacheRawBlock(uint32_t blockNumber, uint8_t action,
+                                uint8_t ahead) {
+  uint8_t slot = cacheFind(blockNumber);
+  if (slot < SD_CACHE_SLOTS) {
+    cacheHits_++;
+    if (cacheSlotFlags_[slot] & CACHE_READ_AHEAD) {
+      readAheadHits_++;
+      cacheSlotFlags_[slot] &= ~CACHE_READ_AHEAD;
+    }
+  } else {
+    cacheMisses_++;
+    if (ahead) {
+      return cacheReadAhead(blockNumber, action, ahead);
+    }
+    slot = cacheVictim();
+    if (!cacheEvict(slot)) {
       return false;
     }
-    cacheBlockNumber_ = blockNumber;
+    if (!sdCard_->readBlock(blockNumber, cacheSlots_[slot].data)) {
+      return false;
+    }
+    cacheSlotBlock_[slot] = blockNumber;
+  }
+  cacheSelect(slot);
+  cacheTag(slot, action);
+  return true;
+}
+//------------------------------------------------------------------------------
+// Read blockNumber and up to ahead following blocks into the cache with one
+// multiple block read, then make blockNumber current.  The run stops at the
+// first block that is already cached.  Slots are claimed before the read
+// starts since evicting a dirty slot writes to the card.
+uint8_t SdVolume::cacheReadAhead(uint32_t blockNumber, uint8_t action,
+                                 uint8_t ahead) {
+  uint8_t slots[SD_CACHE_SLOTS];
+  uint8_t count = 0;
+  if (ahead >= SD_CACHE_SLOTS) {
+    ahead = SD_CACHE_SLOTS - 1;
+  }
+  do {
+    uint8_t slot = cacheVictim();
+    if (!cacheEvict(slot)) {
+      goto fail;
+    }
+    // claimed slots are most recently used so cacheVictim() skips them
+    cacheSlotBlock_[slot] = blockNumber + count;
+    cacheSlotUse_[slot] = ++cacheUseCount_;
+    slots[count++] = slot;
+  } while (count <= ahead && cacheFind(blockNumber + count) == SD_CACHE_SLOTS);
+
+  if (!sdCard_->readStart(blockNumber)) {
+    goto fail;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    if (!sdCard_->readData(cacheSlots_[slots[i]].data)) {
+      sdCard_->readStop();
+      goto fail;
+    }
+    cacheSlotFlags_[slots[i]] = i ? CACHE_READ_AHEAD : 0;
+  }
+  if (!sdCard_->readStop()) {
+    goto fail;
+  }
+  readAheadBlocks_ += count - 1;
+  cacheSelect(slots[0]);
+  cacheTag(slots[0], action);
+  return true;
+
+fail:
+  for (uint8_t i = 0; i < count; i++) {
+    cacheSlotBlock_[slots[i]] = 0XFFFFFFFF;
+    cacheSlotFlags_[slots[i]] = 0;
+  }
+  cacheBlockNumber_ = cacheSlotBlock_[cacheCurrent_];
+  return false;
+}
+//------------------------------------------------------------------------------
+// invalidate all slots without writing them
+void SdVolume::cacheReset(void) {
+  for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+    cacheSlotBlock_[i] = 0XFFFFFFFF;
+    cacheSlotMirror_[i] = 0;
+    cacheSlotUse_[i] = 0;
+    cacheSlotFlags_[i] = 0;
+  }
+  cacheMirrorEvicted_ = 0;
+  cacheSelect(0);
+}
+//------------------------------------------------------------------------------
+// make slot the current block and mark it most recently used
+void SdVolume::cacheSelect(uint8_t slot) {
+  cacheCurrent_ = slot;
+  cacheBuffer_ = &cacheSlots_[slot];
+  cacheBlockNumber_ = cacheSlotBlock_[slot];
+  cacheSlotUse_[slot] = ++cacheUseCount_;
+}
+//------------------------------------------------------------------------------
+// choose the slot to reuse - an empty slot or the least recently used
+uint8_t SdVolume::cacheVictim(void) {
+  uint8_t victim = 0;
+  for (uint8_t i = 0; i < SD_CACHE_SLOTS; i++) {
+    if (cacheSlotBlock_[i] == 0XFFFFFFFF) {
+      return i;
+    }
+    if (cacheSlotUse_[i] < cacheSlotUse_[victim]) {
+      victim = i;
+    }
+  }
+  return victim;
+}
+//------------------------------------------------------------------------------
+// write a slot and its FAT mirror; a non-blocking write leaves it dirty
+uint8_t SdVolume::cacheWriteSlot(uint8_t slot, uint8_t blocking) {
+  if (!sdCard_->writeBlock(cacheSlotBlock_[slot], cacheSlots_[slot].data, blocking)) {
+    return false;
+  }
+  if (cacheClass(slot) == 1) {
+    fatWrites_++;
+  } else if (cacheClass(slot) == 2) {
+    dirWrites_++;
+  }
+  if (!blocking) {
+    return true;
   }
-  cacheDirty_ |= action;
+  // mirror FAT tables, now or at the next blocking cacheFlush()
+  if (cacheSlotMirror_[slot]) {
+    if (cacheMirrorBatch_) {
+      cacheMirrorStale(slot);
+    } else {
+      if (!sdCard_->writeBlock(cacheSlotMirror_[slot], cacheSlots_[slot].data)) {
+        return false;
+      }
+      fatMirrorWrites_++;
+      cacheSlotMirror_[slot] = 0;
+    }
+  }
+  cacheSlotFlags_[slot] &= ~CACHE_FOR_WRITE;
   return true;
 }
 //------------------------------------------------------------------------------
 // cache a zero block for blockNumber
 uint8_t SdVolume::cacheZeroBlock(uint32_t blockNumber) {
-  if (!cacheFlush()) {
+  if (!cacheNewBlock(blockNumber, CACHE_FOR_WRITE)) {
     return false;
   }
 
-  // loop take less flash than memset(cacheBuffer_.data, 0, 512);
+  // loop take less flash than memset(cacheBuffer_->data, 0, 512);
   for (uint16_t i = 0; i < 512; i++) {
-    cacheBuffer_.data[i] = 0;
+    cacheBuffer_->data[i] = 0;
   }
-  cacheBlockNumber_ = blockNumber;
-  cacheSetDirty();
   return true;
 }
 //------------------------------------------------------------------------------
@@ -192,9 +735,9 @@ uint8_t SdVolume::fatGet(uint32_t cluster, uint32_t* value) const {
     }
   }
   if (fatType_ == 16) {
-    *value = cacheBuffer_.fat16[cluster & 0XFF];
+    *value = cacheBuffer_->fat16[cluster & 0XFF];
   } else {
-    *value = cacheBuffer_.fat32[cluster & 0X7F] & FAT32MASK;
+    *value = cacheBuffer_->fat32[cluster & 0X7F] & FAT32MASK;
   }
   return true;
 }
@@ -221,20 +764,75 @@ uint8_t SdVolume::fatPut(uint32_t cluster, uint32_t value) {
     }
   }
   // store entry
+  uint32_t old;
   if (fatType_ == 16) {
-    cacheBuffer_.fat16[cluster & 0XFF] = value;
+    old = cacheBuffer_->fat16[cluster & 0XFF];
+    cacheBuffer_->fat16[cluster & 0XFF] = value;
   } else {
-    cacheBuffer_.fat32[cluster & 0X7F] = value;
+    old = cacheBuffer_->fat32[cluster & 0X7F] & FAT32MASK;
+    cacheBuffer_->fat32[cluster & 0X7F] = value;
   }
   cacheSetDirty();
 
   // mirror second FAT
   if (fatCount_ > 1) {
-    cacheMirrorBlock_ = lba + blocksPerFat_;
+    cacheSlotMirror_[cacheCurrent_] = lba + blocksPerFat_;
+  }
+
+  // keep free space accounting in step with the FAT
+  if ((old == 0) != (value == 0)) {
+    freeCountChange(cluster, value == 0);
   }
   return true;
 }
 //------------------------------------------------------------------------------
+// account for a cluster that was allocated or freed
+void SdVolume::freeCountChange(uint32_t cluster, uint8_t freed) {
+  if (freeClusters_ != FSINFO_UNKNOWN) {
+    freeClusters_ += freed ? 1 : -1;
+  }
+  // clusters not yet scanned are counted when the scan reaches them
+  if (cluster < freeBitmapScan_) {
+    scanFreeCount_ += freed ? 1 : -1;
+    if (freeBitmap_) {
+      if (freed) {
+        freeBitmap_[cluster >> 5] &= ~(1UL << (cluster & 31));
+      } else {
+        freeBitmap_[cluster >> 5] |= 1UL << (cluster & 31);
+      }
+    }
+  }
+  fsInfoDirty_ = 1;
+}
+//------------------------------------------------------------------------------
+// write free count and next free hints to the FAT32 FSINFO sector
+uint8_t SdVolume::syncFsInfo(void) {
+  if (!fsInfoDirty_ || fsInfoBlock_ == 0) {
+    return true;
+  }
+  if (!cacheRawBlock(fsInfoBlock_, CACHE_FOR_WRITE)) {
+    return false;
+  }
+  cacheBuffer_->fsinfo.freeCount = freeClusters_;
+  cacheBuffer_->fsinfo.nextFree = allocSearchStart_;
+  fsInfoDirty_ = 0;
+  return cacheFlush();
+}
+//------------------------------------------------------------------------------
+/**
+   Write everything the cache holds, including directory entries left there
+   by SD_SYNC_DEFERRED, and the FSINFO free count.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t SdVolume::sync(void) {
+  if (!cacheFlush()) {
+    return false;
+  }
+  return syncFsInfo();
+}
+//------------------------------------------------------------------------------
 // free a cluster chain
 uint8_t SdVolume::freeChain(uint32_t cluster) {
   // clear free cluster location
@@ -275,6 +873,8 @@ uint8_t SdVolume::freeChain(uint32_t cluster) {
 uint8_t SdVolume::init(Sd2Card* dev, uint8_t part) {
   uint32_t volumeStartBlock = 0;
   sdCard_ = dev;
+  forgetVolume();
+
   // if part == 0 assume super floppy with FAT boot sector in block zero
   // if part > 0 assume mbr volume with partition table
   if (part) {
@@ -284,7 +884,7 @@ uint8_t SdVolume::init(Sd2Card* dev, uint8_t part) {
     if (!cacheRawBlock(volumeStartBlock, CACHE_FOR_READ)) {
       return false;
     }
-    part_t* p = &cacheBuffer_.mbr.part[part - 1];
+    part_t* p = &cacheBuffer_->mbr.part[part - 1];
     if ((p->boot & 0X7F) != 0  ||
         p->totalSectors < 100 ||
         p->firstSector == 0) {
@@ -293,10 +893,72 @@ uint8_t SdVolume::init(Sd2Card* dev, uint8_t part) {
     }
     volumeStartBlock = p->firstSector;
   }
+  return mount(volumeStartBlock, 0);
+}
+//------------------------------------------------------------------------------
+/**
+   Initialize a FAT volume from the state getState() saved at an earlier
+   mount.  Only the boot sector is read; the MBR is skipped and the free
+   cluster count and allocation hint are taken from \a state instead of
+   the FSINFO sector.  The allocation unit is left to the caller.
+
+   \param[in] dev The SD card where the volume is located.
+
+   \param[in] state The saved state.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.  Reasons for
+   failure include an I/O error and a boot sector that is not a valid
+   FAT boot sector or whose serial number or cluster count differ from
+   \a state, e.g. because the card has been reformatted.
+*/
+uint8_t SdVolume::init(Sd2Card* dev, const SdVolumeState& state) {
+  sdCard_ = dev;
+  forgetVolume();
+  return mount(state.startBlock, &state);
+}
+//------------------------------------------------------------------------------
+/**
+   Save the volume state for a later init(Sd2Card*, const SdVolumeState&).
+
+   \param[out] state The volume layout, free space hints and allocation
+   unit.  The free cluster count is a hint only, like FSINFO: the volume
+   may change before it is used.
+*/
+void SdVolume::getState(SdVolumeState* state) const {
+  state->startBlock = volumeStartBlock_;
+  state->serial = volumeSerial_;
+  state->clusterCount = clusterCount_;
+  state->freeClusters = freeClusters_;
+  state->allocStart = allocSearchStart_;
+  state->fsInfoBlock = fsInfoBlock_;
+  state->auBlocks = auBlocks_;
+}
+//------------------------------------------------------------------------------
+// drop cached blocks and free space state of a previous volume
+void SdVolume::forgetVolume(void) {
+  // blocks cached from a previous card are not valid
+  cacheReset();
+  cacheFatStart_ = cacheFatEnd_ = 0;
+
+  // forget free space state of a previous volume
+  if (freeBitmap_) {
+    free(freeBitmap_);
+    freeBitmap_ = 0;
+  }
+  freeBitmapScan_ = 0;
+  freeClusters_ = FSINFO_UNKNOWN;
+  fsInfoBlock_ = 0;
+  fsInfoDirty_ = 0;
+}
+//------------------------------------------------------------------------------
+// read the boot sector at volumeStartBlock and set up the volume, taking
+// the free space hints from state if not null, else from FSINFO
+uint8_t SdVolume::mount(uint32_t volumeStartBlock, const SdVolumeState* state) {
   if (!cacheRawBlock(volumeStartBlock, CACHE_FOR_READ)) {
     return false;
   }
-  bpb_t* bpb = &cacheBuffer_.fbs.bpb;
+  bpb_t* bpb = &cacheBuffer_->fbs.bpb;
   if (bpb->bytesPerSector != 512 ||
       bpb->fatCount == 0 ||
       bpb->reservedSectorCount == 0 ||
@@ -320,6 +982,10 @@ uint8_t SdVolume::init(Sd2Card* dev, uint8_t part) {
 
   fatStartBlock_ = volumeStartBlock + bpb->reservedSectorCount;
 
+  // FAT range for cache write-back ordering
+  cacheFatStart_ = fatStartBlock_;
+  cacheFatEnd_ = fatStartBlock_ + fatCount_ * blocksPerFat_;
+
   // count for FAT16 zero for FAT32
   rootDirEntryCount_ = bpb->rootDirEntryCount;
 
@@ -346,6 +1012,56 @@ uint8_t SdVolume::init(Sd2Card* dev, uint8_t part) {
   } else {
     rootDirStart_ = bpb->fat32RootCluster;
     fatType_ = 32;
+    if (bpb->fat32FSInfo) {
+      fsInfoBlock_ = volumeStartBlock + bpb->fat32FSInfo;
+    }
+  }
+  volumeStartBlock_ = volumeStartBlock;
+
+  // serial number from the FAT16 or FAT32 extended boot record, whose
+  // signature byte says if it is valid
+  uint8_t* ebr = cacheBuffer_->data + (fatType_ == 32 ? 64 : 36);
+  volumeSerial_ = 0;
+  if (ebr[2] == 0X29) {
+    for (uint8_t i = 6; i > 2; i--) {
+      volumeSerial_ = (volumeSerial_ << 8) | ebr[i];
+    }
+  }
+  if (state) {
+    if (state->serial != volumeSerial_ ||
+        state->clusterCount != clusterCount_ ||
+        (state->fsInfoBlock && state->fsInfoBlock != fsInfoBlock_)) {
+      // not the volume state was saved for
+      return false;
+    }
+    // FSINFO was checked when state was saved
+    fsInfoBlock_ = state->fsInfoBlock;
+    if (state->freeClusters <= clusterCount_) {
+      freeClusters_ = state->freeClusters;
+    }
+    if (state->allocStart >= 2 && state->allocStart <= clusterCount_ + 1) {
+      allocSearchStart_ = state->allocStart;
+    }
+    return true;
+  }
+  // use FSINFO hints if the sector is valid
+  if (fsInfoBlock_) {
+    if (!cacheRawBlock(fsInfoBlock_, CACHE_FOR_READ)) {
+      return false;
+    }
+    fsinfo_t* fsi = &cacheBuffer_->fsinfo;
+    if (fsi->leadSignature != FSINFO_LEAD_SIG ||
+        fsi->structSignature != FSINFO_STRUCT_SIG) {
+      // don't write to a sector that isn't FSINFO
+      fsInfoBlock_ = 0;
+    } else {
+      if (fsi->freeCount <= clusterCount_) {
+        freeClusters_ = fsi->freeCount;
+      }
+      if (fsi->nextFree >= 2 && fsi->nextFree <= clusterCount_ + 1) {
+        allocSearchStart_ = fsi->nextFree;
+      }
+    }
   }
   return true;
 }
@@ -18,6 +18,7 @@
 *   - DEV_SPI_Write_Bulk_Data() - Stream data in bulk mode (no CS toggling)
 *   - DEV_SPI_Write_Bulk_End() - Complete bulk transfer mode
 *   - getDMABuffer() - Access to aligned DMA buffer for efficient transfers
+*   - DEV_SPI_SetClock() - Change the DMA/bulk SPI clock at runtime
 * OPTIMIZATIONS:
 *   - Hardware DMA support using ESP32's built-in SPI DMA
 *   - Bulk transfer mode (DEV_SPI_Write_Bulk_*) for continuous data streaming
@@ -72,13 +73,21 @@ void Config_Init()
     Serial.println("LCD Config Init - Memory Optimized DMA");
 }
 
+// SPI clock for DMA/bulk transfers (80MHz unless a power profile lowers it)
+static volatile uint32_t spi_clock_hz = 80000000;
+
+void DEV_SPI_SetClock(uint32_t hz)
+{
+    spi_clock_hz = hz;
+}
+
 // Hardware DMA transfer using ESP32's built-in DMA
 void DEV_SPI_Write_DMA(const uint8_t *data, uint32_t len)
 {
     if (len == 0) return;
     
-    // Use 80MHz SPI with hardware DMA
-    SPIlcd.beginTransaction(SPISettings(80000000, MSBFIRST, SPI_MODE3));
+    // Use 80MHz SPI (see DEV_SPI_SetClock) with hardware DMA
+    SPIlcd.beginTransaction(SPISettings(spi_clock_hz, MSBFIRST, SPI_MODE3));
     
     // ESP32's writeBytes() uses DMA internally for large transfers
     SPIlcd.writeBytes(data, len);
@@ -93,7 +102,7 @@ void DEV_SPI_Write_Bulk_Start()
 {
     DEV_Digital_Write(DEV_CS_PIN, 0);
     DEV_Digital_Write(DEV_DC_PIN, 1);
-    SPIlcd.beginTransaction(SPISettings(80000000, MSBFIRST, SPI_MODE3));
+    SPIlcd.beginTransaction(SPISettings(spi_clock_hz, MSBFIRST, SPI_MODE3));
     bulk_active = true;
 }
 
@@ -86,6 +86,9 @@ void DEV_SPI_Write_Bulk_Start();
 void DEV_SPI_Write_Bulk_Data(const uint8_t *data, uint32_t len);
 void DEV_SPI_Write_Bulk_End();
 
+// DMA/bulk transfer SPI clock (default 80MHz, lowered by power profiles)
+void DEV_SPI_SetClock(uint32_t hz);
+
 #define DEV_Delay_ms(__xms) delay(__xms)
 
 // PWM (ESP32 uses ledcWrite)
@@ -58,6 +58,23 @@ void LCD_SetBacklight(UWORD Value)
     DEV_Set_BL(DEV_BL_PIN, (Value * 2.55));
 }
 
+/********************************************************************************
+function:   Enter/leave panel sleep (display off + SLPIN / SLPOUT + display on)
+parameter:
+    Sleep   :   1 = sleep, 0 = wake (panel accepts commands ~5ms after wake)
+********************************************************************************/
+void LCD_Sleep(UBYTE Sleep)
+{
+    if(Sleep) {
+        LCD_WriteReg(0x28);
+        LCD_WriteReg(0x10);
+    } else {
+        LCD_WriteReg(0x11);
+        DEV_Delay_ms(5);
+        LCD_WriteReg(0x29);
+    }
+}
+
 void LCD_WriteData_Byte(UBYTE da) 
 { 
     DEV_Digital_Write(DEV_CS_PIN,0);
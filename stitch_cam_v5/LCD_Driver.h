@@ -53,6 +53,7 @@ void LCD_SetUWORD(UWORD x, UWORD y, UWORD Color);
 
 void LCD_Init(void);
 void LCD_SetBacklight(UWORD Value);
+void LCD_Sleep(UBYTE Sleep);
 void LCD_Clear(UWORD Color);
 void LCD_ClearWindow(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD color);
 
@@ -0,0 +1,205 @@
+/**
+ * @file burst_capture.h
+ * @brief Burst capture into a PSRAM frame ring with deferred SD flush
+ *
+ * The camera task captures JPEGs back-to-back straight into ring slots in
+ * PSRAM; BurstFlush hands each frame to the async SD writer, which saves
+ * it in the background while the next frames are captured. The ring is
+ * single-producer (camera task) / single-consumer (executor).
+ */
+
+#ifndef BURST_CAPTURE_H
+#define BURST_CAPTURE_H
+
+#include <Arduino.h>
+#include "slice_executor.h"
+#include "sd_async.h"
+
+//=============================================================================
+// BURST CONFIGURATION
+//=============================================================================
+namespace BurstConfig {
+  constexpr uint32_t SLOT_BYTES       = 32768;   // Max JPEG per frame (= Config::MAX_JPEG_SIZE)
+  constexpr uint16_t MAX_FRAMES       = 64;      // Upper bound on ring slots
+  constexpr uint8_t  PSRAM_SHARE_PCT  = 50;      // Use at most this much of free PSRAM
+  constexpr uint16_t DEFAULT_FRAMES   = 10;      // Burst length when none is given
+  constexpr uint32_t DISPLAY_EVERY_MS = 250;     // Live count refresh on the LCD
+}
+
+//=============================================================================
+// FRAME RING
+//=============================================================================
+
+/**
+ * @brief Fixed-slot JPEG ring in PSRAM
+ */
+class BurstRing {
+public:
+  /**
+   * @brief Allocate ring slots from PSRAM
+   *
+   * Slot count is limited by BurstConfig::MAX_FRAMES and by
+   * PSRAM_SHARE_PCT of the PSRAM free at boot.
+   *
+   * @return Number of slots (0 if no PSRAM)
+   */
+  static uint16_t begin() {
+    if (slots != NULL) return capacity;
+
+    size_t freePsram = ESP.getFreePsram();
+    uint32_t fit = (uint32_t)(freePsram / 100 * BurstConfig::PSRAM_SHARE_PCT)
+                   / BurstConfig::SLOT_BYTES;
+    uint16_t want = fit < BurstConfig::MAX_FRAMES ? fit : BurstConfig::MAX_FRAMES;
+
+    while (want > 0) {
+      slots = (uint8_t*)ps_malloc((size_t)want * BurstConfig::SLOT_BYTES);
+      if (slots != NULL) break;
+      want /= 2;
+    }
+    capacity = slots != NULL ? want : 0;
+
+    Serial.printf("[BURST] Ring: %u slots x %lu bytes (PSRAM free %lu)\n",
+                  capacity, (unsigned long)BurstConfig::SLOT_BYTES,
+                  (unsigned long)freePsram);
+    return capacity;
+  }
+
+  static uint16_t size() { return capacity; }
+  static uint32_t used() { return head - tail; }
+  static bool full() { return capacity == 0 || used() >= capacity; }
+  static bool empty() { return head == tail; }
+
+  /** @brief Producer: slot to capture the next frame into (NULL if full) */
+  static uint8_t* reserve() {
+    if (full()) return NULL;
+    return slots + (size_t)(head % capacity) * BurstConfig::SLOT_BYTES;
+  }
+
+  /** @brief Producer: publish the reserved slot with its JPEG length */
+  static void commit(uint32_t length) {
+    lengths[head % capacity] = length;
+    __sync_synchronize();
+    head = head + 1;
+  }
+
+  /** @brief Frames committed since boot (index of the next commit) */
+  static uint32_t committed() { return head; }
+
+  /** @brief Committed frame by commit index (must not be popped yet) */
+  static const uint8_t* frame(uint32_t index, uint32_t& length) {
+    uint16_t slot = index % capacity;
+    length = lengths[slot];
+    return slots + (size_t)slot * BurstConfig::SLOT_BYTES;
+  }
+
+  /** @brief Consumer: oldest frame (NULL if empty) */
+  static const uint8_t* peek(uint32_t& length) {
+    if (empty()) return NULL;
+    uint16_t slot = tail % capacity;
+    length = lengths[slot];
+    return slots + (size_t)slot * BurstConfig::SLOT_BYTES;
+  }
+
+  /** @brief Consumer: release the oldest frame */
+  static void pop() {
+    __sync_synchronize();
+    tail = tail + 1;
+  }
+
+private:
+  static uint8_t* slots;
+  static uint16_t capacity;
+  static uint32_t lengths[BurstConfig::MAX_FRAMES];
+  static volatile uint32_t head;
+  static volatile uint32_t tail;
+};
+
+//=============================================================================
+// BACKGROUND FLUSH
+//=============================================================================
+
+/**
+ * @brief Drains the burst ring to SD through the async writer
+ *
+ * One write request per ring slot. Requests complete in commit order, so
+ * each completion releases the oldest frame.
+ */
+class BurstFlush {
+public:
+  /** Opens the photo file for req (or saves it outright); StorageGuard held */
+  typedef bool (*PhotoStart)(AsyncWriteRequest& req);
+  /** Closes and records the photo once req is done; StorageGuard held */
+  typedef void (*PhotoDone)(AsyncWriteRequest& req, bool ok);
+
+  BurstFlush(PhotoStart start, PhotoDone done) : start(start), done(done) {}
+
+  /**
+   * @brief Producer: queue every committed frame not queued yet
+   *
+   * Frames the queue cannot take now are picked up by the next call.
+   */
+  void submitCommitted() {
+    while (submitted != BurstRing::committed()) {
+      AsyncWriteRequest& req = requests[submitted % BurstRing::size()];
+      req.data = BurstRing::frame(submitted, req.length);
+      req.closeWhenDone = false;
+      req.onStart = start;
+      req.onDone = onWritten;
+      req.context = this;
+      if (!AsyncWriter::submit(&req)) break;
+      submitted++;
+    }
+    AsyncWriter::kick();
+  }
+
+  volatile uint32_t flushed = 0;
+  volatile uint32_t failed = 0;
+
+private:
+  static void onWritten(AsyncWriteRequest& req, bool ok) {
+    BurstFlush* self = (BurstFlush*)req.context;
+    self->done(req, ok);
+    if (ok) {
+      self->flushed++;
+    } else {
+      self->failed++;
+    }
+    BurstRing::pop();
+  }
+
+  PhotoStart start;
+  PhotoDone done;
+  uint32_t submitted = 0;
+  AsyncWriteRequest requests[BurstConfig::MAX_FRAMES];
+};
+
+static_assert(BurstConfig::MAX_FRAMES <= AsyncWriteConfig::QUEUE_DEPTH,
+              "A full burst ring must fit in the async write queue");
+
+//=============================================================================
+// BURST STATISTICS
+//=============================================================================
+
+/**
+ * @brief Result of the most recent burst
+ */
+struct BurstStats {
+  uint16_t requested = 0;
+  uint16_t captured = 0;
+  uint32_t durationMs = 0;    // First capture start to last capture end
+  bool     ringFull = false;  // Burst cut short by ring capacity
+
+  /** @brief Sustained burst rate in frames/s x 10 */
+  uint32_t fpsX10() const {
+    return durationMs == 0 ? 0 : (uint32_t)captured * 10000 / durationMs;
+  }
+};
+
+// Static member initialization
+uint8_t* BurstRing::slots = NULL;
+uint16_t BurstRing::capacity = 0;
+uint32_t BurstRing::lengths[BurstConfig::MAX_FRAMES];
+volatile uint32_t BurstRing::head = 0;
+volatile uint32_t BurstRing::tail = 0;
+
+#endif // BURST_CAPTURE_H
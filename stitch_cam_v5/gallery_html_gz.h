@@ -4,9 +4,9 @@
 #include <Arduino.h>
 
 const uint8_t gallery_html_gz[] PROGMEM = {
-    0x1F, 0x8B, 0x08, 0x08, 0x05, 0x4A, 0x25, 0x69, 0x02, 0xFF, 0x67, 0x61, 0x6C, 0x6C, 0x65, 0x72, 0x79, 0x2E, 0x68, 0x74, 0x6D, 0x6C, 0x00, 0xBD, 0x59, 0xDD, 0x8E, 0xDB, 0xC6, 0x15, 0xBE, 0xD7, 0x53, 0xD0, 0xDA, 0x18, 0x24, 0xBB, 0xA2, 0x44, 0x4A, 0xA2, 0x56, 0x4B, 0x4A, 0xEB, 0xB4, 0x8E, 0xD3, 0x1A, 0x70, 0x53, 0x03, 0x71, 0x2E, 0x82, 0x20, 0x40, 0x86, 0xE4, 0x50, 0x1A, 0x2F, 0xFF, 0x3A, 0x1C, 0x69, 0x57, 0x51, 0x74, 0xD7, 0xFB, 0x5E, 0x14, 0x48, 0x80, 0xA2, 0x40, 0x7B, 0xD9, 0x37, 0x68, 0x50, 0xF4, 0xAE, 0x6F, 0xE2, 0x17, 0x68, 0x1F, 0xA1, 0x67, 0x66, 0xF8, 0x33, 0xE2, 0x6A, 0xD7, 0x1B, 0xA3, 0x2D, 0x6C, 0x89, 0xE2, 0xFC, 0x9C, 0x39, 0x3F, 0xDF, 0xF9, 0xCE, 0x21, 0x77, 0xF1, 0xE4, 0x93, 0xDF, 0x3C, 0x7F, 0xF3, 0xE5, 0xEB, 0x17, 0xDA, 0x9A, 0xA5, 0xC9, 0x55, 0x6F, 0x51, 0x5F, 0x30, 0x8A, 0xE0, 0x92, 0x62, 0x86, 0xB4, 0x70, 0x8D, 0x68, 0x89, 0xD9, 0xB2, 0xFF, 0xC5, 0x9B, 0x4F, 0xAD, 0x79, 0xBF, 0x1E, 0xCE, 0x50, 0x8A, 0x97, 0xFD, 0x2D, 0xC1, 0x37, 0x45, 0x4E, 0x59, 0x5F, 0x0B, 0xF3, 0x8C, 0xE1, 0x0C, 0x96, 0xDD, 0x90, 0x88, 0xAD, 0x97, 0x11, 0xDE, 0x92, 0x10, 0x5B, 0xE2, 0x66, 0x40, 0x32, 0xC2, 0x08, 0x4A, 0xAC, 0x32, 0x44, 0x09, 0x5E, 0x3A, 0x43, 0x9B, 0x4B, 0x61, 0x84, 0x25, 0xF8, 0xEA, 0x73, 0xB8, 0x84, 0x6B, 0xED, 0x97, 0x28, 0x49, 0x30, 0xDD, 0x2D, 0x46, 0x72, 0xB4, 0xB7, 0x28, 0xD9, 0x8E, 0x5F, 0x3D, 0x9A, 0xE7, 0x6C, 0x6F, 0x59, 0x41, 0xB2, 0xC1, 0x56, 0x84, 0xE8, 0xB5, 0x77, 0x66, 0x07, 0x13, 0xDB, 0x9D, 0xF9, 0xD5, 0x58, 0x8A, 0x48, 0xE6, 0x9D, 0x8D, 0xC3, 0x59, 0x1C, 0xC7, 0xF5, 0x58, 0x99, 0xC7, 0xCC, 0x3B, 0xBB, 0x98, 0xA2, 0xCB, 0x76, 0xAC, 0x40, 0x25, 0xC3, 0x89, 0x77, 0x16, 0x05, 0x18, 0x89, 0xD1, 0x9B, 0x35, 0x61, 0xD8, 0x3B, 0x93, 0xDB, 0x50, 0x18, 0x82, 0xEE, 0x56, 0x41, 0xB2, 0x6B, 0x3E, 0x34, 0xBF, 0x08, 0x2E, 0x0E, 0xBD, 0x9F, 0xED, 0x83, 0xFC, 0xD6, 0x2A, 0xC9, 0xB7, 0x24, 0x5B, 0x79, 0x41, 0x4E, 0x23, 0x4C, 0x2D, 0x18, 0x39, 0xF4, 0x82, 0x3C, 0xDA, 0xED, 0x53, 0x44, 0x57, 0x70, 0xB4, 0xED, 0x17, 0x28, 0x8A, 0xF8, 0x0A, 0xDB, 0x8F, 0xC1, 0x05, 0x56, 0x8C, 0x52, 0x92, 0xEC, 0xBC, 0x72, 0x07, 0xE7, 0xA5, 0xD6, 0x86, 0x0C, 0x2C, 0x54, 0x14, 0x09, 0x28, 0x25, 0x06, 0x06, 0x25, 0xCA, 0x4A, 0xAB, 0xC4, 0x94, 0xC4, 0x7E, 0x80, 0xC2, 0xEB, 0x15, 0xCD, 0x37, 0x59, 0xE4, 0x51, 0x14, 0x71, 0xFF, 0xAC, 0xF8, 0x15, 0x14, 0x31, 0x42, 0x42, 0xC3, 0x04, 0x6B, 0x88, 0x69, 0x2C, 0x2F, 0x06, 0x67, 0xD3, 0xE0, 0xD2, 0x89, 0x63, 0xCD, 0x1E, 0x80, 0xF1, 0x63, 0x67, 0x6A, 0x6B, 0x53, 0xF7, 0x29, 0xFC, 0x1E, 0xDB, 0x17, 0xCE, 0x58, 0x73, 0x6C, 0xFB, 0xA9, 0xE9, 0x87, 0x79, 0x92, 0x53, 0x6F, 0x8B, 0xA8, 0x51, 0x99, 0x66, 0xFA, 0x29, 0xC9, 0xAC, 0x35, 0x26, 0xAB, 0x35, 0xF3, 0x60, 0xCD, 0x76, 0xED, 0x47, 0xA4, 0x2C, 0x12, 0xB4, 0xF3, 0xE2, 0x04, 0xDF, 0xFA, 0xFC, 0xCB, 0x8A, 0x08, 0xC5, 0x21, 0x23, 0x79, 0xE6, 0xC1, 0xFE, 0x4D, 0x9A, 0x1D, 0x7A, 0xC3, 0x60, 0x13, 0x04, 0xA0, 0x6E, 0xB0, 0xDA, 0x17, 0x79, 0x49, 0xC4, 0x5C, 0x4C, 0x6E, 0x71, 0xE4, 0x93, 0x0C, 0x50, 0x00, 0x56, 0xE6, 0x5B, 0x4C, 0xE3, 0x24, 0xBF, 0xF1, 0xD6, 0x24, 0x8A, 0x70, 0xE6, 0x17, 0x39, 0x81, 0xC8, 0x53, 0x0B, 0x6F, 0x41, 0xF3, 0xD2, 0xCB, 0xF2, 0x0C, 0xFB, 0xDF, 0x5A, 0x24, 0x8B, 0xF0, 0xAD, 0x67, 0x39, 0x8D, 0xC4, 0x56, 0x1C, 0x0A, 0x4A, 0x38, 0x8C, 0x61, 0xBF, 0xF2, 0x29, 0x37, 0x7A, 0x53, 0x7A, 0xAE, 0xFD, 0xF4, 0xFD, 0x2E, 0x19, 0xD0, 0x55, 0x80, 0x8C, 0xB1, 0xEB, 0x0E, 0xEA, 0x8F, 0x3D, 0x9C, 0xBB, 0x26, 0xB8, 0x46, 0x4C, 0x38, 0xCE, 0x6C, 0xE0, 0xCC, 0x2E, 0xAB, 0x09, 0xC7, 0xD4, 0x66, 0xDC, 0x37, 0x79, 0x81, 0x42, 0xC2, 0x76, 0x1E, 0x8C, 0xB8, 0x3E, 0xCA, 0x48, 0x8A, 0xA4, 0x59, 0x49, 0x8E, 0xD8, 0x17, 0x85, 0xE6, 0xCC, 0x4B, 0x2D, 0x21, 0x19, 0x46, 0x54, 0x23, 0x59, 0xCC, 0xB1, 0x8A, 0x1B, 0xAD, 0xBD, 0x8C, 0xAD, 0xAD, 0x70, 0x4D, 0x92, 0xC8, 0x70, 0xCC, 0xBD, 0x40, 0xB3, 0x07, 0x01, 0x28, 0x6E, 0xFD, 0xDA, 0xB3, 0xE2, 0x26, 0xC1, 0x80, 0x38, 0x17, 0xF4, 0xCF, 0x19, 0xCB, 0x53, 0x30, 0xDB, 0xE5, 0xA3, 0xCD, 0x51, 0x56, 0x84, 0xB9, 0xDF, 0xED, 0xF2, 0x94, 0xDC, 0x71, 0x2D, 0xF7, 0x52, 0x11, 0x7B, 0xD9, 0x48, 0xBD, 0x50, 0xC5, 0x8E, 0x4F, 0x89, 0x9D, 0x9C, 0x14, 0x3B, 0xA9, 0xC5, 0xCE, 0x14, 0xB1, 0xB3, 0x46, 0xAC, 0x33, 0x6F, 0xC5, 0xCE, 0x4F, 0x49, 0x9D, 0x9D, 0x94, 0x3A, 0x6D, 0x9C, 0xA0, 0x6A, 0xEB, 0xB4, 0xEA, 0xBA, 0x8A, 0xBA, 0x63, 0xFB, 0x94, 0xE0, 0x4B, 0x10, 0xFC, 0xF1, 0x35, 0xDE, 0xC5, 0x14, 0x18, 0xA4, 0xD4, 0xAA, 0x28, 0xEC, 0x63, 0x9A, 0xA7, 0x7B, 0x46, 0x21, 0x3D, 0xE2, 0x9C, 0xA6, 0x9E, 0xF8, 0x95, 0x20, 0x86, 0xBF, 0x34, 0x6C, 0xF3, 0xC0, 0xF2, 0xD3, 0x53, 0xDC, 0x23, 0xDB, 0xB5, 0x79, 0x00, 0x55, 0x33, 0xB4, 0xDD, 0x1F, 0x01, 0x7C, 0x85, 0x0A, 0xC0, 0x3D, 0x28, 0x50, 0x27, 0xA8, 0xE3, 0x16, 0xB7, 0x9A, 0xF0, 0xA0, 0x0A, 0x33, 0x01, 0x9B, 0xF1, 0x60, 0x3A, 0x1E, 0xCC, 0xC7, 0x1C, 0x4C, 0xA6, 0x98, 0x8D, 0x68, 0x5E, 0x58, 0x31, 0x49, 0x00, 0xD8, 0x1E, 0xF0, 0x07, 0x35, 0xB8, 0x24, 0x53, 0x1E, 0xA3, 0xA1, 0x3D, 0x3F, 0xC0, 0x73, 0x5A, 0xC9, 0x63, 0x10, 0xCA, 0xF0, 0x2D, 0xB3, 0x50, 0x42, 0x56, 0x90, 0x4C, 0x98, 0x67, 0x84, 0x7A, 0x8C, 0xC4, 0x57, 0x8B, 0x66, 0x67, 0xE2, 0x46, 0x78, 0x35, 0x38, 0x73, 0x82, 0xC9, 0xD8, 0xBD, 0x84, 0xAB, 0x3D, 0x76, 0x26, 0x81, 0xD9, 0x49, 0x09, 0x21, 0x57, 0x66, 0xB6, 0x20, 0x2A, 0x71, 0x44, 0x84, 0xC3, 0x9C, 0x4A, 0x04, 0x8B, 0x5C, 0x13, 0xAC, 0x73, 0x53, 0xC7, 0xB7, 0x62, 0x21, 0x60, 0x2D, 0x0C, 0x78, 0xBF, 0xA4, 0x38, 0xF5, 0x85, 0xBF, 0x64, 0xEA, 0xD9, 0xC3, 0x71, 0x59, 0x1B, 0xE1, 0xAD, 0x79, 0x26, 0xEF, 0x1F, 0xA1, 0xA4, 0x64, 0xD7, 0x9A, 0x86, 0x4C, 0xFF, 0x74, 0x28, 0xC6, 0x8A, 0x83, 0x86, 0x08, 0x58, 0x65, 0x8B, 0x1F, 0x21, 0x5C, 0x32, 0x96, 0xC2, 0xBF, 0xE6, 0x00, 0x4C, 0x8D, 0x26, 0xB1, 0x5D, 0x73, 0xDA, 0x99, 0xE3, 0x3A, 0xEE, 0x78, 0x0E, 0xA2, 0x79, 0x89, 0x01, 0xBA, 0x07, 0xA5, 0x3B, 0xFE, 0x17, 0x41, 0xAD, 0x79, 0xC9, 0xDA, 0x79, 0x68, 0xC3, 0x72, 0x58, 0xCF, 0xAB, 0x18, 0x2C, 0xBE, 0x1B, 0x18, 0xC9, 0xDD, 0x56, 0x85, 0xD3, 0x09, 0xEC, 0x6E, 0x56, 0x6B, 0x6B, 0xA7, 0xA1, 0x76, 0xCD, 0xD6, 0x04, 0x80, 0x5A, 0x8F, 0x8E, 0x85, 0x3F, 0xB9, 0xBC, 0x72, 0x8D, 0x22, 0xE0, 0x40, 0x5B, 0x03, 0xB3, 0xC5, 0x2A, 0x4D, 0x20, 0xC9, 0x1E, 0x88, 0x7F, 0x43, 0xD7, 0x6C, 0x25, 0x16, 0x6D, 0xAD, 0x68, 0x99, 0x68, 0xAE, 0x48, 0x75, 0x40, 0x2A, 0x2C, 0x5F, 0xC9, 0x1A, 0xD8, 0xA0, 0x78, 0x45, 0x49, 0xE4, 0xF3, 0x2F, 0x0B, 0x0A, 0x47, 0xC1, 0xBD, 0x6C, 0x49, 0x96, 0x2E, 0x3D, 0x8A, 0x0B, 0x8C, 0x98, 0xC1, 0xED, 0xE4, 0x28, 0x4D, 0x06, 0xC0, 0xF5, 0x29, 0xBA, 0x35, 0x04, 0xEF, 0x0C, 0x9C, 0x98, 0x9A, 0xA6, 0xC4, 0x3F, 0x40, 0x1E, 0xAC, 0xBD, 0xB5, 0xAA, 0xA4, 0x95, 0x19, 0xD9, 0xD8, 0x57, 0xF9, 0xA9, 0x58, 0xE7, 0x20, 0x27, 0x44, 0x34, 0xDA, 0xA3, 0xB2, 0x80, 0x82, 0x60, 0x09, 0x7C, 0x79, 0xD3, 0xD1, 0xA4, 0x0B, 0x48, 0x57, 0x71, 0x74, 0x5D, 0x00, 0x1E, 0x0A, 0xF2, 0x54, 0x04, 0xB9, 0x9B, 0x64, 0x97, 0x73, 0xB3, 0x22, 0x72, 0x67, 0x30, 0x73, 0x07, 0xA0, 0x96, 0x1C, 0xE4, 0xF8, 0xBF, 0x6D, 0x5D, 0x3B, 0xE5, 0xAE, 0x75, 0xBB, 0xAE, 0x9D, 0x02, 0x30, 0x36, 0xB4, 0x04, 0x64, 0x54, 0x95, 0xA7, 0x0B, 0x70, 0xBF, 0xA9, 0x34, 0x14, 0x08, 0x87, 0xE3, 0xF0, 0xC8, 0xC6, 0x0A, 0xF7, 0xA7, 0x41, 0x0C, 0xA7, 0x75, 0x94, 0x98, 0x73, 0xD2, 0xB8, 0xA3, 0xC4, 0xCC, 0x3C, 0x92, 0xA9, 0x91, 0x74, 0x55, 0x13, 0x23, 0x94, 0x63, 0xBF, 0x2D, 0xBB, 0x4F, 0xFD, 0x3C, 0x78, 0xCB, 0x5D, 0x1A, 0x13, 0x06, 0x45, 0x16, 0x4E, 0x3E, 0xDE, 0x38, 0x04, 0x52, 0xC4, 0x10, 0xD9, 0x80, 0x65, 0x27, 0x2A, 0x24, 0x54, 0x7F, 0x8F, 0xBB, 0x9C, 0x0A, 0x71, 0xFC, 0x97, 0x3C, 0x64, 0xA2, 0x90, 0xAF, 0xF8, 0xFD, 0x70, 0x29, 0xAD, 0x6B, 0xA6, 0x63, 0x5F, 0x88, 0x0F, 0x38, 0xBB, 0xA6, 0x1A, 0xC9, 0x21, 0x0A, 0xC7, 0x28, 0xB0, 0x1C, 0x0A, 0xB8, 0x77, 0x9C, 0x7D, 0xC4, 0xB1, 0x22, 0xAB, 0x2C, 0x28, 0x98, 0x69, 0x59, 0xE7, 0xD6, 0xDB, 0x4D, 0xC9, 0x48, 0xBC, 0xB3, 0xAA, 0x7E, 0xB0, 0x1E, 0x6E, 0x90, 0x7F, 0x82, 0x8E, 0xBA, 0xB1, 0x39, 0x72, 0x4A, 0xBD, 0xD1, 0xB9, 0xD7, 0x6F, 0x77, 0x89, 0xAC, 0x31, 0xD8, 0xB5, 0xF9, 0x7F, 0x47, 0xA5, 0x2C, 0xD1, 0x83, 0x1A, 0x0E, 0x34, 0x07, 0x20, 0x10, 0xF2, 0x8A, 0xED, 0x4E, 0x10, 0x44, 0x4D, 0x2C, 0xBC, 0x5E, 0xCA, 0x92, 0xD1, 0x66, 0xEE, 0xAC, 0xDE, 0x67, 0x11, 0xB0, 0x71, 0xDF, 0xFA, 0x6B, 0xCA, 0xBD, 0x75, 0x4C, 0x2D, 0x63, 0x49, 0x2D, 0x09, 0x0F, 0x14, 0xA0, 0xAA, 0x49, 0x6D, 0xE1, 0xF4, 0x7B, 0xFA, 0xAB, 0xAE, 0x1D, 0x35, 0xE4, 0x2E, 0x5D, 0xB3, 0xE9, 0xAB, 0x00, 0x58, 0xF6, 0x4F, 0x70, 0xBE, 0xCA, 0x93, 0x8A, 0x3A, 0x35, 0x4B, 0xAB, 0x21, 0x55, 0xA6, 0x6B, 0x29, 0xFB, 0x3B, 0xF9, 0xA4, 0x50, 0xCA, 0xA5, 0xBD, 0xBD, 0x11, 0xB7, 0x4D, 0xE3, 0xB2, 0x5D, 0xAB, 0x32, 0x78, 0x62, 0x28, 0x04, 0xC4, 0x13, 0xA2, 0xB3, 0xBA, 0x83, 0x5D, 0x59, 0xA0, 0xD5, 0x0C, 0x14, 0xEC, 0xEA, 0xDE, 0xA1, 0xD8, 0x79, 0x55, 0x6D, 0x1E, 0x4A, 0x1D, 0x38, 0xED, 0x9E, 0x3C, 0xE7, 0x7D, 0xA1, 0xD4, 0xC9, 0x55, 0x72, 0xC9, 0x7D, 0x6F, 0x2E, 0x7D, 0x40, 0x19, 0x3B, 0x91, 0x68, 0xB2, 0xA4, 0x1D, 0xE5, 0x9A, 0x7B, 0x22, 0xD7, 0x1E, 0xC1, 0x86, 0xAE, 0x79, 0x87, 0xFE, 0x3E, 0x30, 0x43, 0xD5, 0x3E, 0x22, 0xC8, 0x93, 0xA8, 0xF5, 0xEE, 0xC3, 0x8C, 0x09, 0x9E, 0xD4, 0x8E, 0x92, 0xAA, 0xDA, 0x35, 0x2C, 0x28, 0xDE, 0xEE, 0x45, 0x53, 0x68, 0x5D, 0x48, 0xE0, 0xD5, 0x33, 0x19, 0x24, 0xDC, 0x5E, 0x72, 0x5A, 0x3D, 0x15, 0x26, 0x79, 0xF9, 0x10, 0x0B, 0x5A, 0x22, 0x34, 0x72, 0x8F, 0x5D, 0x45, 0x4E, 0xED, 0xC3, 0xA7, 0x8F, 0x67, 0xC1, 0xF6, 0xC9, 0x61, 0xFC, 0x28, 0x16, 0x3C, 0x15, 0x99, 0xBB, 0x24, 0xD6, 0x18, 0xF0, 0x00, 0x1D, 0xB5, 0x27, 0x4F, 0xEE, 0xA3, 0xA4, 0x8F, 0x53, 0x0C, 0xCF, 0x3D, 0x9A, 0xD1, 0xE6, 0xCC, 0xC5, 0x0C, 0x4A, 0x90, 0xB9, 0x6F, 0xFB, 0x83, 0x07, 0x5B, 0x82, 0x89, 0xA8, 0xFE, 0x4D, 0xF3, 0xAB, 0xA4, 0xC8, 0x3D, 0x3E, 0xEB, 0xF2, 0xFD, 0xC9, 0x00, 0x3A, 0xF7, 0xC6, 0xCF, 0xE9, 0x86, 0x8F, 0x07, 0xCB, 0x69, 0x63, 0x25, 0xE7, 0x0F, 0xBD, 0xC5, 0xA8, 0x7A, 0xA2, 0x5F, 0x8C, 0xAA, 0x97, 0x0B, 0xFC, 0x29, 0x1A, 0x2E, 0x11, 0xD9, 0x6A, 0x61, 0x82, 0xCA, 0x72, 0xD9, 0x6F, 0x1E, 0x3D, 0xFB, 0xA7, 0xC6, 0xFB, 0x57, 0x8B, 0x11, 0x0C, 0xFE, 0x2F, 0xA6, 0xE4, 0xA5, 0xB7, 0xE0, 0xBD, 0x6B, 0xB5, 0x04, 0x7E, 0x72, 0x2D, 0x90, 0xB6, 0xA6, 0x38, 0x5E, 0xF6, 0x47, 0xFD, 0xAB, 0x7F, 0xFF, 0xF9, 0x0F, 0x7F, 0xD3, 0x9E, 0xC3, 0x33, 0x0B, 0x45, 0x8B, 0x11, 0x52, 0xE7, 0xAA, 0xC0, 0xF4, 0xEB, 0xBD, 0x92, 0x56, 0xF9, 0x8E, 0xEF, 0xFF, 0xF1, 0xAF, 0x1F, 0x7F, 0xDF, 0xBE, 0xDC, 0xE0, 0xBB, 0x46, 0x20, 0x99, 0x9F, 0xA5, 0xA8, 0xD3, 0xF4, 0xB5, 0x1D, 0xBB, 0x65, 0xFF, 0xC8, 0x07, 0xD7, 0xCE, 0xD5, 0xBB, 0x3F, 0xFD, 0x55, 0x93, 0x2F, 0x4B, 0xF4, 0x52, 0x7B, 0xCD, 0x0B, 0xA1, 0xF6, 0xF3, 0x24, 0xD8, 0xA4, 0x1A, 0x4C, 0x80, 0x4F, 0x1D, 0x58, 0x55, 0x68, 0x24, 0x5A, 0xF6, 0x45, 0x91, 0x7C, 0x99, 0xC5, 0x79, 0xFF, 0xEA, 0x55, 0x8E, 0x38, 0xEF, 0x6B, 0x62, 0xA8, 0x1C, 0x0E, 0x87, 0x8B, 0x51, 0xD1, 0x98, 0x2B, 0x4E, 0xE2, 0x1B, 0xBA, 0xEA, 0xD7, 0xF7, 0x77, 0xDC, 0x53, 0x6F, 0xA8, 0xC9, 0xBD, 0xD9, 0xD1, 0x0E, 0xE4, 0x59, 0x98, 0x90, 0xF0, 0x1A, 0x6C, 0xE2, 0x80, 0x78, 0x55, 0x8D, 0x1B, 0xE2, 0xDD, 0x80, 0xD9, 0x31, 0xAF, 0x5B, 0x67, 0xF8, 0x74, 0xB0, 0x81, 0xBA, 0x99, 0x35, 0x8E, 0xA9, 0x51, 0xF5, 0x5E, 0xC1, 0xFF, 0xFC, 0x61, 0x31, 0x92, 0x7B, 0xEF, 0x08, 0xA9, 0x40, 0xAB, 0x71, 0x34, 0x2B, 0x72, 0xF8, 0xAD, 0x70, 0x63, 0x23, 0xE3, 0xDD, 0x0F, 0xBF, 0x53, 0x84, 0x40, 0xE1, 0x3A, 0x32, 0xF6, 0x65, 0xBA, 0xBA, 0x63, 0x2F, 0xAF, 0x6E, 0x7D, 0xAD, 0xA4, 0xE1, 0xB2, 0xDF, 0xD7, 0x50, 0xC2, 0xE0, 0x72, 0xEF, 0xF1, 0x3C, 0x67, 0x94, 0xE3, 0xF9, 0x6D, 0xE7, 0xF8, 0xEF, 0xFF, 0xAE, 0x1C, 0xDF, 0x71, 0x7D, 0x19, 0x52, 0x52, 0xB0, 0xAB, 0x1E, 0xF4, 0x3C, 0x55, 0x34, 0x97, 0x5F, 0x7D, 0x3D, 0x00, 0x52, 0xA2, 0xB0, 0xF9, 0x25, 0xEF, 0x09, 0x96, 0xB6, 0xDF, 0x8B, 0x37, 0x99, 0x78, 0x9B, 0xA3, 0xC1, 0x33, 0x75, 0x54, 0xA1, 0xCE, 0x00, 0xEA, 0x88, 0x31, 0xC0, 0xC6, 0xD0, 0x47, 0x72, 0xA7, 0x6E, 0x0E, 0xD9, 0x1A, 0x67, 0x06, 0x5D, 0x5E, 0xD1, 0xE1, 0xDB, 0x32, 0xCF, 0x0C, 0xB3, 0x1A, 0x89, 0x96, 0x57, 0xFB, 0x5E, 0x25, 0x3E, 0x92, 0xDD, 0x56, 0xE9, 0xF7, 0xA2, 0x3C, 0xDC, 0xA4, 0x70, 0xCC, 0x70, 0x85, 0xD9, 0x8B, 0x04, 0xF3, 0x9F, 0xBF, 0xD8, 0xBD, 0x8C, 0x0C, 0xBD, 0x41, 0x1A, 0x97, 0x08, 0xF6, 0x3C, 0xAF, 0x5E, 0x01, 0x56, 0x70, 0x4B, 0x70, 0xB6, 0x62, 0xEB, 0x73, 0x5D, 0x2A, 0xAC, 0x9F, 0x1B, 0x47, 0xE3, 0x4F, 0x96, 0x4B, 0xE7, 0x99, 0x5E, 0xEA, 0x9E, 0xAE, 0x9B, 0x7E, 0x0F, 0x20, 0x50, 0x32, 0xAD, 0x42, 0xDE, 0xF2, 0xDE, 0x13, 0xAB, 0x05, 0x7C, 0x07, 0x89, 0x8F, 0xE5, 0x2D, 0x97, 0x4B, 0x1B, 0x4C, 0xAD, 0x56, 0x0C, 0x49, 0x06, 0xF9, 0xF4, 0xAB, 0x37, 0xBF, 0x7E, 0xB5, 0xD4, 0x55, 0xCC, 0x89, 0xC6, 0x0D, 0x90, 0xDD, 0x1D, 0x12, 0xBD, 0x9C, 0xC8, 0xF1, 0x1F, 0xA5, 0xCF, 0xF9, 0x8A, 0xAB, 0xCF, 0xF2, 0xCA, 0xD9, 0xDA, 0x0E, 0xB3, 0x27, 0x8B, 0x80, 0x5E, 0xBD, 0x41, 0xD7, 0x58, 0x2B, 0xF3, 0x14, 0x6B, 0x37, 0x84, 0xAD, 0xAB, 0x84, 0xE4, 0xAC, 0xF0, 0xA4, 0xDA, 0x26, 0xBE, 0x75, 0xBF, 0x47, 0x31, 0xDB, 0xD0, 0xCC, 0x3F, 0x9C, 0x52, 0x08, 0xA6, 0x2B, 0xD5, 0x81, 0xFE, 0x5F, 0x20, 0x08, 0x8D, 0x34, 0x65, 0x40, 0x4C, 0x1E, 0x00, 0xE9, 0x0B, 0xDE, 0xE5, 0xB6, 0x8E, 0x08, 0x29, 0x90, 0x3B, 0xAE, 0x7C, 0x61, 0xE8, 0x70, 0x88, 0xF0, 0x1A, 0xAC, 0x19, 0x0A, 0x33, 0x3E, 0xE3, 0x6F, 0x63, 0xF5, 0xB6, 0x3F, 0xD6, 0xAB, 0xC9, 0xF6, 0xD4, 0x6F, 0x04, 0xA2, 0x05, 0x56, 0x25, 0x0E, 0x9E, 0xC1, 0x83, 0x23, 0x5E, 0x7E, 0xB4, 0x17, 0x37, 0x87, 0x0A, 0xBF, 0x92, 0x58, 0x3E, 0xDA, 0x93, 0x73, 0xE7, 0x00, 0x6E, 0x3A, 0x86, 0x72, 0xDB, 0x72, 0x2B, 0x40, 0x96, 0x83, 0x0A, 0x94, 0x07, 0x7A, 0x2D, 0x53, 0x3F, 0x4E, 0xCC, 0x6F, 0x2A, 0x9D, 0x7E, 0xBB, 0x01, 0x7F, 0x7C, 0x0E, 0xDB, 0x42, 0x96, 0x53, 0x43, 0x07, 0xB5, 0x00, 0x3F, 0xB5, 0x3C, 0x03, 0x5C, 0x90, 0x17, 0x38, 0x6B, 0x32, 0x9C, 0x80, 0x9D, 0xB5, 0x0F, 0x51, 0x01, 0x33, 0xD1, 0x73, 0xF1, 0x26, 0x8A, 0x8B, 0x82, 0xA9, 0x83, 0xF8, 0x0C, 0x43, 0xC4, 0x11, 0x6E, 0x08, 0xFF, 0xBD, 0x1F, 0x3D, 0x1F, 0x88, 0x8E, 0x77, 0x7F, 0xFC, 0x0B, 0xD0, 0xB9, 0x82, 0x8F, 0x4F, 0x11, 0xB8, 0x30, 0xD2, 0xC0, 0x63, 0x3C, 0xE1, 0x2A, 0xAC, 0x74, 0x80, 0x00, 0x0A, 0x1E, 0xDA, 0xC4, 0x3C, 0x36, 0x8D, 0xE7, 0x2D, 0x60, 0xF6, 0x28, 0x8D, 0xC5, 0xE0, 0x03, 0x49, 0xA7, 0xF0, 0x11, 0x18, 0xC2, 0xE3, 0xA9, 0xAB, 0xF1, 0xD4, 0xCF, 0xA5, 0x16, 0x5F, 0xA9, 0x42, 0xBF, 0x7E, 0x84, 0x3C, 0x10, 0xA6, 0x20, 0xA9, 0x1E, 0xD5, 0x64, 0x2D, 0xD3, 0x55, 0x1B, 0x3A, 0x0C, 0x0C, 0x06, 0x40, 0x2E, 0xE2, 0x21, 0x83, 0x27, 0x1F, 0xCC, 0x86, 0xC0, 0x99, 0xCB, 0x76, 0xBF, 0xFE, 0xDD, 0x77, 0xCD, 0x4C, 0x23, 0x1E, 0xDC, 0x1F, 0x26, 0x9B, 0x08, 0x97, 0x86, 0xDE, 0x30, 0xBC, 0x6E, 0x9A, 0xFB, 0x0F, 0x55, 0x12, 0xB4, 0x53, 0xD4, 0x53, 0x88, 0x1D, 0x44, 0xE2, 0x61, 0x09, 0x1D, 0xC9, 0x6B, 0x0A, 0xCF, 0x6F, 0x2B, 0xF1, 0xD2, 0xCC, 0xE0, 0x79, 0xA3, 0x3A, 0xDC, 0x50, 0xEF, 0x2C, 0xE7, 0xFC, 0x88, 0x55, 0xCC, 0xA7, 0x47, 0xB7, 0xFF, 0xF5, 0xB8, 0x28, 0x7A, 0x2B, 0x15, 0xE1, 0xA7, 0xEB, 0x7D, 0xEE, 0xFC, 0x1F, 0x35, 0x3D, 0x4A, 0xF9, 0x01, 0xDF, 0xC4, 0xFF, 0x18, 0x74, 0x9F, 0xD2, 0x00, 0x8E, 0x27, 0x90, 0x3E, 0x31, 0xA1, 0xA9, 0xA1, 0x7F, 0x22, 0xB6, 0x6A, 0x6C, 0x4D, 0x4A, 0x99, 0x2E, 0xCF, 0x20, 0xF0, 0x15, 0x57, 0x36, 0x65, 0x4A, 0xCA, 0xAF, 0xB5, 0x69, 0xE4, 0xCB, 0x1A, 0xC5, 0x73, 0xFC, 0xA8, 0xBC, 0xF1, 0xFC, 0x3A, 0x1A, 0xF0, 0x79, 0xB3, 0x59, 0xD5, 0x4B, 0x20, 0x1F, 0xD9, 0x66, 0x8E, 0xE4, 0x5F, 0xB6, 0xFE, 0x03, 0xA0, 0x38, 0xEB, 0x46, 0xF1, 0x1A, 0x00, 0x00
+    0x1F, 0x8B, 0x08, 0x08, 0x81, 0x19, 0xD4, 0x6A, 0x02, 0xFF, 0x67, 0x61, 0x6C, 0x6C, 0x65, 0x72, 0x79, 0x2E, 0x68, 0x74, 0x6D, 0x6C, 0x00, 0xBD, 0x59, 0xDD, 0x8E, 0xDB, 0xC6, 0x15, 0xBE, 0xD7, 0x53, 0xD0, 0xDA, 0x18, 0x24, 0xBB, 0xA2, 0x44, 0x4A, 0xA2, 0x56, 0x4B, 0x4A, 0xEB, 0xB4, 0x8E, 0xD3, 0x1A, 0x70, 0x53, 0x03, 0x71, 0x2E, 0x82, 0x20, 0x40, 0x86, 0xE4, 0x50, 0x1C, 0x2F, 0xFF, 0x3A, 0x1C, 0x69, 0x57, 0x56, 0x74, 0xD7, 0xFB, 0x5E, 0x14, 0x48, 0x80, 0xA2, 0x40, 0x7B, 0xD9, 0x37, 0x68, 0x50, 0xF4, 0xAE, 0x6F, 0x92, 0x17, 0x68, 0x1F, 0xA1, 0x67, 0x66, 0xF8, 0x33, 0xD2, 0x6A, 0xD7, 0x1B, 0xA3, 0x2D, 0x6C, 0x89, 0xE2, 0xFC, 0x9C, 0x39, 0x3F, 0xDF, 0xF9, 0xCE, 0x21, 0x77, 0xF1, 0xE4, 0x93, 0xDF, 0x3C, 0x7F, 0xF3, 0xE5, 0xEB, 0x17, 0x5A, 0xC2, 0xB2, 0xF4, 0xAA, 0xB7, 0x68, 0x2E, 0x18, 0x45, 0x70, 0xC9, 0x30, 0x43, 0x5A, 0x98, 0x20, 0x5A, 0x61, 0xB6, 0xEC, 0x7F, 0xF1, 0xE6, 0x53, 0x6B, 0xDE, 0x6F, 0x86, 0x73, 0x94, 0xE1, 0x65, 0x7F, 0x43, 0xF0, 0x4D, 0x59, 0x50, 0xD6, 0xD7, 0xC2, 0x22, 0x67, 0x38, 0x87, 0x65, 0x37, 0x24, 0x62, 0xC9, 0x32, 0xC2, 0x1B, 0x12, 0x62, 0x4B, 0xDC, 0x0C, 0x48, 0x4E, 0x18, 0x41, 0xA9, 0x55, 0x85, 0x28, 0xC5, 0x4B, 0x67, 0x68, 0x73, 0x29, 0x8C, 0xB0, 0x14, 0x5F, 0x7D, 0x0E, 0x97, 0x30, 0xD1, 0x7E, 0x89, 0xD2, 0x14, 0xD3, 0xED, 0x62, 0x24, 0x47, 0x7B, 0x8B, 0x8A, 0x6D, 0xF9, 0xD5, 0xA3, 0x45, 0xC1, 0x76, 0x96, 0x15, 0xA4, 0x6B, 0x6C, 0x45, 0x88, 0x5E, 0x7B, 0x67, 0x76, 0x30, 0xB1, 0xDD, 0x99, 0x5F, 0x8F, 0x65, 0x88, 0xE4, 0xDE, 0xD9, 0x38, 0x9C, 0xC5, 0x71, 0xDC, 0x8C, 0x55, 0x45, 0xCC, 0xBC, 0xB3, 0x8B, 0x29, 0xBA, 0xEC, 0xC6, 0x4A, 0x54, 0x31, 0x9C, 0x7A, 0x67, 0x51, 0x80, 0x91, 0x18, 0xBD, 0x49, 0x08, 0xC3, 0xDE, 0x99, 0xDC, 0x86, 0xC2, 0x10, 0x74, 0xB7, 0x4A, 0x92, 0x5F, 0xF3, 0xA1, 0xF9, 0x45, 0x70, 0xB1, 0xEF, 0xFD, 0x6C, 0x17, 0x14, 0xB7, 0x56, 0x45, 0xDE, 0x91, 0x7C, 0xE5, 0x05, 0x05, 0x8D, 0x30, 0xB5, 0x60, 0x64, 0xDF, 0x0B, 0x8A, 0x68, 0xBB, 0xCB, 0x10, 0x5D, 0xC1, 0xD1, 0xB6, 0x5F, 0xA2, 0x28, 0xE2, 0x2B, 0x6C, 0x3F, 0x06, 0x17, 0x58, 0x31, 0xCA, 0x48, 0xBA, 0xF5, 0xAA, 0x2D, 0x9C, 0x97, 0x59, 0x6B, 0x32, 0xB0, 0x50, 0x59, 0xA6, 0xA0, 0x94, 0x18, 0x18, 0x54, 0x28, 0xAF, 0xAC, 0x0A, 0x53, 0x12, 0xFB, 0x01, 0x0A, 0xAF, 0x57, 0xB4, 0x58, 0xE7, 0x91, 0x47, 0x51, 0xC4, 0xFD, 0xB3, 0xE2, 0x57, 0x50, 0xC4, 0x08, 0x09, 0x0D, 0x53, 0xAC, 0x21, 0xA6, 0xB1, 0xA2, 0x1C, 0x9C, 0x4D, 0x83, 0x4B, 0x27, 0x8E, 0x35, 0x7B, 0x00, 0xC6, 0x8F, 0x9D, 0xA9, 0xAD, 0x4D, 0xDD, 0xA7, 0xF0, 0x7B, 0x6C, 0x5F, 0x38, 0x63, 0xCD, 0xB1, 0xED, 0xA7, 0xA6, 0x1F, 0x16, 0x69, 0x41, 0xBD, 0x0D, 0xA2, 0x46, 0x6D, 0x9A, 0xE9, 0x67, 0x24, 0xB7, 0x12, 0x4C, 0x56, 0x09, 0xF3, 0x60, 0xCD, 0x26, 0xF1, 0x23, 0x52, 0x95, 0x29, 0xDA, 0x7A, 0x71, 0x8A, 0x6F, 0x7D, 0xFE, 0x65, 0x45, 0x84, 0xE2, 0x90, 0x91, 0x22, 0xF7, 0x60, 0xFF, 0x3A, 0xCB, 0xF7, 0xBD, 0x61, 0xB0, 0x0E, 0x02, 0x50, 0x37, 0x58, 0xED, 0xCA, 0xA2, 0x22, 0x62, 0x2E, 0x26, 0xB7, 0x38, 0xF2, 0x49, 0x0E, 0x28, 0x00, 0x2B, 0x8B, 0x0D, 0xA6, 0x71, 0x5A, 0xDC, 0x78, 0x09, 0x89, 0x22, 0x9C, 0xFB, 0x65, 0x41, 0x20, 0xF2, 0xD4, 0xC2, 0x1B, 0xD0, 0xBC, 0xF2, 0xF2, 0x22, 0xC7, 0xFE, 0x3B, 0x8B, 0xE4, 0x11, 0xBE, 0xF5, 0x2C, 0xA7, 0x95, 0xD8, 0x89, 0x43, 0x41, 0x05, 0x87, 0x31, 0xEC, 0xD7, 0x3E, 0xE5, 0x46, 0xAF, 0x2B, 0xCF, 0xB5, 0x9F, 0xBE, 0xDF, 0x25, 0x03, 0xBA, 0x0A, 0x90, 0x31, 0x76, 0xDD, 0x41, 0xF3, 0xB1, 0x87, 0x73, 0xD7, 0x04, 0xD7, 0x88, 0x09, 0xC7, 0x99, 0x0D, 0x9C, 0xD9, 0x65, 0x3D, 0xE1, 0x98, 0xDA, 0x8C, 0xFB, 0xA6, 0x28, 0x51, 0x48, 0xD8, 0xD6, 0x83, 0x11, 0xD7, 0x47, 0x39, 0xC9, 0x90, 0x34, 0x2B, 0x2D, 0x10, 0xFB, 0xA2, 0xD4, 0x9C, 0x79, 0xA5, 0xA5, 0x24, 0xC7, 0x88, 0x6A, 0x24, 0x8F, 0x39, 0x56, 0x71, 0xAB, 0xB5, 0x97, 0xB3, 0xC4, 0x0A, 0x13, 0x92, 0x46, 0x86, 0x63, 0xEE, 0x04, 0x9A, 0x3D, 0x08, 0x40, 0x79, 0xEB, 0x37, 0x9E, 0x15, 0x37, 0x29, 0x06, 0xC4, 0xB9, 0xA0, 0x7F, 0xC1, 0x58, 0x91, 0x81, 0xD9, 0x2E, 0x1F, 0x6D, 0x8F, 0xB2, 0x22, 0xCC, 0xFD, 0x6E, 0x57, 0xA7, 0xE4, 0x8E, 0x1B, 0xB9, 0x97, 0x8A, 0xD8, 0xCB, 0x56, 0xEA, 0x85, 0x2A, 0x76, 0x7C, 0x4A, 0xEC, 0xE4, 0xA4, 0xD8, 0x49, 0x23, 0x76, 0xA6, 0x88, 0x9D, 0xB5, 0x62, 0x9D, 0x79, 0x27, 0x76, 0x7E, 0x4A, 0xEA, 0xEC, 0xA4, 0xD4, 0x69, 0xEB, 0x04, 0x55, 0x5B, 0xA7, 0x53, 0xD7, 0x55, 0xD4, 0x1D, 0xDB, 0xA7, 0x04, 0x5F, 0x82, 0xE0, 0x8F, 0xAF, 0xF1, 0x36, 0xA6, 0xC0, 0x20, 0x95, 0x56, 0x47, 0x61, 0x17, 0xD3, 0x22, 0xDB, 0x31, 0x0A, 0xE9, 0x11, 0x17, 0x34, 0xF3, 0xC4, 0xAF, 0x14, 0x31, 0xFC, 0xA5, 0x61, 0x9B, 0x7B, 0x56, 0x9C, 0x9E, 0xE2, 0x1E, 0xD9, 0x24, 0xE6, 0x1E, 0x54, 0xCD, 0xD1, 0x66, 0x77, 0x00, 0xF0, 0x15, 0x2A, 0x01, 0xF7, 0xA0, 0x40, 0x93, 0xA0, 0x8E, 0x5B, 0xDE, 0x6A, 0xC2, 0x83, 0x2A, 0xCC, 0x04, 0x6C, 0xC6, 0x83, 0xE9, 0x78, 0x30, 0x1F, 0x73, 0x30, 0x99, 0x62, 0x36, 0xA2, 0x45, 0x69, 0xC5, 0x24, 0x05, 0x60, 0x7B, 0xC0, 0x1F, 0xD4, 0xE0, 0x92, 0x4C, 0x79, 0x8C, 0x86, 0x76, 0xFC, 0x00, 0xCF, 0xE9, 0x24, 0x8F, 0x41, 0x28, 0xC3, 0xB7, 0xCC, 0x42, 0x29, 0x59, 0x41, 0x32, 0x61, 0x9E, 0x11, 0xEA, 0x31, 0x12, 0x5F, 0x1D, 0x9A, 0x9D, 0x89, 0x1B, 0xE1, 0xD5, 0xE0, 0xCC, 0x09, 0x26, 0x63, 0xF7, 0x12, 0xAE, 0xF6, 0xD8, 0x99, 0x04, 0xE6, 0x51, 0x4A, 0x08, 0xB9, 0x32, 0xB3, 0x05, 0x51, 0x89, 0x23, 0x22, 0x1C, 0x16, 0x54, 0x22, 0x58, 0xE4, 0x9A, 0x60, 0x9D, 0x9B, 0x26, 0xBE, 0x35, 0x0B, 0x01, 0x6B, 0x61, 0xC0, 0xFB, 0x25, 0xC5, 0x99, 0x2F, 0xFC, 0x25, 0x53, 0xCF, 0x1E, 0x8E, 0xAB, 0xC6, 0x08, 0x2F, 0xE1, 0x99, 0xBC, 0x7B, 0x84, 0x92, 0x92, 0x5D, 0x1B, 0x1A, 0x32, 0xFD, 0xD3, 0xA1, 0x18, 0x2B, 0x0E, 0x1A, 0x22, 0x60, 0x95, 0x0D, 0x7E, 0x84, 0x70, 0xC9, 0x58, 0x0A, 0xFF, 0x9A, 0x03, 0x30, 0x35, 0x9A, 0xC4, 0x76, 0xC3, 0x69, 0x67, 0x8E, 0xEB, 0xB8, 0xE3, 0x39, 0x88, 0xE6, 0x25, 0x06, 0xE8, 0x1E, 0x94, 0x3E, 0xF2, 0xBF, 0x08, 0x6A, 0xC3, 0x4B, 0xD6, 0xD6, 0x43, 0x6B, 0x56, 0xC0, 0x7A, 0x5E, 0xC5, 0x60, 0xF1, 0xDD, 0xC0, 0x48, 0xEE, 0xB6, 0x6A, 0x9C, 0x4E, 0x60, 0x77, 0xBB, 0x5A, 0x4B, 0x9C, 0x96, 0xDA, 0x35, 0x5B, 0x13, 0x00, 0xEA, 0x3C, 0x3A, 0x16, 0xFE, 0xE4, 0xF2, 0xAA, 0x04, 0x45, 0xC0, 0x81, 0xB6, 0x06, 0x66, 0x8B, 0x55, 0x9A, 0x40, 0x92, 0x3D, 0x10, 0xFF, 0x86, 0xAE, 0xD9, 0x49, 0x2C, 0xBB, 0x5A, 0xD1, 0x31, 0xD1, 0x5C, 0x91, 0xEA, 0x80, 0x54, 0x58, 0xBE, 0x92, 0x35, 0xB0, 0x45, 0xF1, 0x8A, 0x92, 0xC8, 0xE7, 0x5F, 0x16, 0x14, 0x8E, 0x92, 0x7B, 0xD9, 0x92, 0x2C, 0x5D, 0x79, 0x14, 0x97, 0x18, 0x31, 0x83, 0xDB, 0xC9, 0x51, 0x9A, 0x0E, 0x80, 0xEB, 0x33, 0x74, 0x6B, 0x08, 0xDE, 0x19, 0x38, 0x31, 0x35, 0x4D, 0x89, 0x7F, 0x80, 0x3C, 0x58, 0x7B, 0x6B, 0xD5, 0x49, 0x2B, 0x33, 0xB2, 0xB5, 0xAF, 0xF6, 0x53, 0x99, 0x14, 0x20, 0x27, 0x44, 0x34, 0xDA, 0xA1, 0xAA, 0x84, 0x82, 0x60, 0x09, 0x7C, 0x79, 0xD3, 0xD1, 0xE4, 0x18, 0x90, 0xAE, 0xE2, 0xE8, 0xA6, 0x00, 0x3C, 0x14, 0xE4, 0xA9, 0x08, 0xF2, 0x71, 0x92, 0x5D, 0xCE, 0xCD, 0x9A, 0xC8, 0x9D, 0xC1, 0xCC, 0x1D, 0x80, 0x5A, 0x72, 0x90, 0xE3, 0xFF, 0xB6, 0x73, 0xED, 0x94, 0xBB, 0xD6, 0x3D, 0x76, 0xED, 0x14, 0x80, 0xB1, 0xA6, 0x15, 0x20, 0xA3, 0xAE, 0x3C, 0xC7, 0x00, 0xF7, 0xDB, 0x4A, 0x43, 0x81, 0x70, 0x38, 0x0E, 0x0F, 0x6C, 0xAC, 0x71, 0x7F, 0x1A, 0xC4, 0x70, 0xDA, 0x91, 0x12, 0x73, 0x4E, 0x1A, 0x77, 0x94, 0x98, 0x99, 0x07, 0x32, 0x35, 0x92, 0xAD, 0x1A, 0x62, 0x84, 0x72, 0xEC, 0x77, 0x65, 0xF7, 0xA9, 0x5F, 0x04, 0x6F, 0xB9, 0x4B, 0x63, 0xC2, 0xA0, 0xC8, 0xC2, 0xC9, 0x87, 0x1B, 0x87, 0x40, 0x8A, 0x18, 0x22, 0x1B, 0xB0, 0xFC, 0x44, 0x85, 0x84, 0xEA, 0xEF, 0x71, 0x97, 0x53, 0x21, 0x8E, 0xFF, 0x92, 0x87, 0x4C, 0x14, 0xF2, 0x15, 0xBF, 0x1F, 0x2E, 0xA5, 0x4D, 0xCD, 0x74, 0xEC, 0x0B, 0xF1, 0x01, 0x67, 0x37, 0x54, 0x23, 0x39, 0x44, 0xE1, 0x18, 0x05, 0x96, 0x43, 0x01, 0xF7, 0x23, 0x67, 0x1F, 0x70, 0xAC, 0xC8, 0x2A, 0x0B, 0x0A, 0x66, 0x56, 0x35, 0xB9, 0xF5, 0x76, 0x5D, 0x31, 0x12, 0x6F, 0xAD, 0xBA, 0x1F, 0x6C, 0x86, 0x5B, 0xE4, 0x9F, 0xA0, 0xA3, 0xE3, 0xD8, 0x1C, 0x38, 0xA5, 0xD9, 0xE8, 0xDC, 0xEB, 0xB7, 0xBB, 0x44, 0xD6, 0x1A, 0xEC, 0xDA, 0xFC, 0xBF, 0xA3, 0x52, 0x96, 0xE8, 0x41, 0x0D, 0x07, 0x9A, 0x03, 0x10, 0x08, 0x79, 0xC5, 0xB6, 0x27, 0x08, 0xA2, 0x21, 0x16, 0x5E, 0x2F, 0x65, 0xC9, 0xE8, 0x32, 0x77, 0xD6, 0xEC, 0xB3, 0x08, 0xD8, 0xB8, 0xEB, 0xFC, 0x35, 0xE5, 0xDE, 0x3A, 0xA4, 0x96, 0xB1, 0xA4, 0x96, 0x94, 0x07, 0x0A, 0x50, 0xD5, 0xA6, 0xB6, 0x70, 0xFA, 0x3D, 0xFD, 0xD5, 0xB1, 0x1D, 0x0D, 0xE4, 0x2E, 0x5D, 0xB3, 0xED, 0xAB, 0x00, 0x58, 0xF6, 0x4F, 0x70, 0xBE, 0xCA, 0x93, 0x8A, 0x3A, 0x0D, 0x4B, 0xAB, 0x21, 0x55, 0xA6, 0x1B, 0x29, 0xBB, 0x3B, 0xF9, 0xA4, 0x50, 0xCA, 0xA5, 0xBD, 0xB9, 0x11, 0xB7, 0x6D, 0xE3, 0xB2, 0x49, 0x54, 0x19, 0x3C, 0x31, 0x14, 0x02, 0xE2, 0x09, 0x71, 0xB4, 0xFA, 0x08, 0xBB, 0xB2, 0x40, 0xAB, 0x19, 0x28, 0xD8, 0xD5, 0xBD, 0x43, 0xB1, 0xF3, 0xBA, 0xDA, 0x3C, 0x94, 0x3A, 0x70, 0xDA, 0x3D, 0x79, 0xCE, 0xFB, 0x42, 0xA9, 0x93, 0xAB, 0xE4, 0x92, 0xFB, 0xDE, 0x5C, 0xFA, 0x80, 0x32, 0x76, 0x22, 0xD1, 0x64, 0x49, 0x3B, 0xC8, 0x35, 0xF7, 0x44, 0xAE, 0x3D, 0x82, 0x0D, 0x5D, 0xF3, 0x0E, 0xFD, 0x7D, 0x60, 0x86, 0xAA, 0x7D, 0x44, 0x50, 0xA4, 0x51, 0xE7, 0xDD, 0x87, 0x19, 0x13, 0x3C, 0xA9, 0x1D, 0x24, 0x55, 0xBD, 0x6B, 0x58, 0x52, 0xBC, 0xD9, 0x89, 0xA6, 0xD0, 0xBA, 0x90, 0xC0, 0x6B, 0x66, 0x72, 0x48, 0xB8, 0x9D, 0xE4, 0xB4, 0x66, 0x2A, 0x4C, 0x8B, 0xEA, 0x21, 0x16, 0xB4, 0x44, 0x68, 0xE4, 0x1E, 0xBB, 0x8E, 0x9C, 0xDA, 0x87, 0x4F, 0x1F, 0xCF, 0x82, 0xDD, 0x93, 0xC3, 0xF8, 0x51, 0x2C, 0x78, 0x2A, 0x32, 0x77, 0x49, 0xAC, 0x35, 0xE0, 0x01, 0x3A, 0xEA, 0x4E, 0x9E, 0xDC, 0x47, 0x49, 0x1F, 0x67, 0x18, 0x9E, 0x7B, 0x34, 0xA3, 0xCB, 0x99, 0x8B, 0x19, 0x94, 0x20, 0x73, 0xD7, 0xF5, 0x07, 0x0F, 0xB6, 0x04, 0x13, 0x51, 0xFD, 0xDB, 0xE6, 0x57, 0x49, 0x91, 0x7B, 0x7C, 0x76, 0xCC, 0xF7, 0x27, 0x03, 0xE8, 0xDC, 0x1B, 0x3F, 0xE7, 0x38, 0x7C, 0x3C, 0x58, 0x4E, 0x17, 0x2B, 0x39, 0xBF, 0xEF, 0x2D, 0x46, 0xF5, 0x13, 0xFD, 0x62, 0x54, 0xBF, 0x5C, 0xE0, 0x4F, 0xD1, 0x70, 0x89, 0xC8, 0x46, 0x0B, 0x53, 0x54, 0x55, 0xCB, 0x7E, 0xFB, 0xE8, 0xD9, 0x3F, 0x35, 0xDE, 0xBF, 0x5A, 0x8C, 0x60, 0xF0, 0x7F, 0x31, 0x25, 0x2F, 0xBD, 0x05, 0xEF, 0x5D, 0xEB, 0x25, 0xF0, 0x93, 0x6B, 0x81, 0xB4, 0x84, 0xE2, 0x78, 0xD9, 0x1F, 0xF5, 0xAF, 0xFE, 0xFD, 0xE7, 0x3F, 0xFC, 0x4D, 0x7B, 0x0E, 0xCF, 0x2C, 0x14, 0x2D, 0x46, 0x48, 0x9D, 0xAB, 0x03, 0xD3, 0x6F, 0xF6, 0x4A, 0x5A, 0xE5, 0x3B, 0xBE, 0xFB, 0xC7, 0xBF, 0x7E, 0xF8, 0x7D, 0xF7, 0x72, 0x83, 0xEF, 0x1A, 0x81, 0x64, 0x7E, 0x96, 0xA2, 0x4E, 0xDB, 0xD7, 0x1E, 0xD9, 0x2D, 0xFB, 0x47, 0x3E, 0x98, 0x38, 0x57, 0x3F, 0xFE, 0xE9, 0xAF, 0x9A, 0x7C, 0x59, 0xA2, 0x57, 0xDA, 0x6B, 0x5E, 0x08, 0xB5, 0x9F, 0xA7, 0xC1, 0x3A, 0xD3, 0x60, 0x02, 0x7C, 0xEA, 0xC0, 0xAA, 0x52, 0x23, 0xD1, 0xB2, 0x2F, 0x8A, 0xE4, 0xCB, 0x3C, 0x2E, 0xFA, 0x57, 0xAF, 0x0A, 0xC4, 0x79, 0x5F, 0x13, 0x43, 0xD5, 0x70, 0x38, 0x5C, 0x8C, 0xCA, 0xD6, 0x5C, 0x71, 0x12, 0xDF, 0x70, 0xAC, 0x7E, 0x73, 0x7F, 0xC7, 0x3D, 0xCD, 0x86, 0x86, 0xDC, 0xDB, 0x1D, 0xDD, 0x40, 0x91, 0x87, 0x29, 0x09, 0xAF, 0xC1, 0x26, 0x0E, 0x88, 0x57, 0xF5, 0xB8, 0x21, 0xDE, 0x0D, 0x98, 0x47, 0xE6, 0x1D, 0xD7, 0x19, 0x3E, 0x1D, 0xAC, 0xA1, 0x6E, 0xE6, 0xAD, 0x63, 0x1A, 0x54, 0xBD, 0x57, 0xF0, 0x3F, 0xBF, 0x5F, 0x8C, 0xE4, 0xDE, 0x3B, 0x42, 0x6A, 0xD0, 0x6A, 0x1C, 0xCD, 0x8A, 0x1C, 0x7E, 0x2B, 0xDC, 0xD8, 0xCA, 0xF8, 0xF1, 0xFB, 0xDF, 0x29, 0x42, 0xA0, 0x70, 0x1D, 0x18, 0xFB, 0x32, 0x5B, 0xDD, 0xB1, 0x97, 0x57, 0xB7, 0xBE, 0x56, 0xD1, 0x70, 0xD9, 0xEF, 0x6B, 0x28, 0x65, 0x70, 0xB9, 0xF7, 0x78, 0x9E, 0x33, 0xCA, 0xF1, 0xFC, 0xF6, 0xE8, 0xF8, 0xEF, 0xFE, 0xAE, 0x1C, 0x7F, 0xE4, 0xFA, 0x2A, 0xA4, 0xA4, 0x64, 0x57, 0x3D, 0xE8, 0x79, 0xEA, 0x68, 0x2E, 0xBF, 0xFA, 0x7A, 0x00, 0xA4, 0x44, 0x61, 0xF3, 0x4B, 0xDE, 0x13, 0x2C, 0x6D, 0xBF, 0x17, 0xAF, 0x73, 0xF1, 0x36, 0x47, 0x83, 0x67, 0xEA, 0xA8, 0x46, 0x9D, 0x01, 0xD4, 0x11, 0x63, 0x80, 0x8D, 0xA1, 0x8F, 0xE4, 0x4E, 0xDD, 0x1C, 0xB2, 0x04, 0xE7, 0x06, 0x5D, 0x5E, 0xD1, 0xE1, 0xDB, 0xAA, 0xC8, 0x0D, 0xB3, 0x1E, 0x89, 0x96, 0x57, 0xBB, 0x5E, 0x2D, 0x3E, 0x92, 0xDD, 0x56, 0xE5, 0xF7, 0xA2, 0x22, 0x5C, 0x67, 0x70, 0xCC, 0x70, 0x85, 0xD9, 0x8B, 0x14, 0xF3, 0x9F, 0xBF, 0xD8, 0xBE, 0x8C, 0x0C, 0xBD, 0x45, 0x1A, 0x97, 0x08, 0xF6, 0x3C, 0xAF, 0x5F, 0x01, 0xD6, 0x70, 0x4B, 0x71, 0xBE, 0x62, 0xC9, 0xB9, 0x2E, 0x15, 0xD6, 0xCF, 0x8D, 0x83, 0xF1, 0x27, 0xCB, 0xA5, 0xF3, 0x4C, 0xAF, 0x74, 0x4F, 0xD7, 0x4D, 0xBF, 0x07, 0x10, 0xA8, 0x98, 0x56, 0x23, 0x6F, 0x79, 0xEF, 0x89, 0xF5, 0x02, 0xBE, 0x83, 0xC4, 0x87, 0xF2, 0x96, 0xCB, 0xA5, 0x0D, 0xA6, 0xD6, 0x2B, 0x86, 0x24, 0x87, 0x7C, 0xFA, 0xD5, 0x9B, 0x5F, 0xBF, 0x5A, 0xEA, 0x2A, 0xE6, 0x44, 0xE3, 0x06, 0xC8, 0x3E, 0x1E, 0x12, 0xBD, 0x9C, 0xC8, 0xF1, 0x1F, 0xA4, 0xCF, 0xF9, 0x8A, 0xAB, 0xCF, 0x8A, 0xDA, 0xD9, 0xDA, 0x16, 0xB3, 0x27, 0x8B, 0x80, 0x5E, 0xBD, 0x41, 0xD7, 0x58, 0xAB, 0x8A, 0x0C, 0x6B, 0x37, 0x84, 0x25, 0x75, 0x42, 0x72, 0x56, 0x78, 0x52, 0x6F, 0x13, 0xDF, 0xBA, 0xDF, 0xA3, 0x98, 0xAD, 0x69, 0xEE, 0xEF, 0x4F, 0x29, 0x04, 0xD3, 0xB5, 0xEA, 0x40, 0xFF, 0x2F, 0x10, 0x84, 0x46, 0x9A, 0x32, 0x20, 0x26, 0x0F, 0x80, 0xF4, 0x05, 0xEF, 0x72, 0x3B, 0x47, 0x84, 0x14, 0xC8, 0x1D, 0xD7, 0xBE, 0x30, 0x74, 0x38, 0x44, 0x78, 0x0D, 0xD6, 0x0C, 0x85, 0x19, 0x9F, 0xF1, 0xB7, 0xB1, 0x7A, 0xD7, 0x1F, 0xEB, 0xF5, 0x64, 0x77, 0xEA, 0x37, 0x02, 0xD1, 0x02, 0xAB, 0x23, 0x96, 0xAC, 0xB3, 0xE0, 0x19, 0x3C, 0x38, 0xE2, 0xE5, 0x47, 0x3B, 0xB1, 0x69, 0xDF, 0x17, 0x98, 0x01, 0xB2, 0x00, 0x74, 0xA3, 0x77, 0xDB, 0x1A, 0xCE, 0x92, 0x67, 0x3E, 0xDA, 0x91, 0x73, 0x67, 0x0F, 0x5E, 0x3B, 0x44, 0x76, 0xD7, 0x81, 0x2B, 0xB8, 0x96, 0x83, 0x0A, 0xB2, 0x07, 0x7A, 0x73, 0x84, 0x7E, 0x98, 0xA7, 0xDF, 0xD4, 0x2A, 0xFE, 0x76, 0x0D, 0xEE, 0xF9, 0x1C, 0xB6, 0x85, 0xAC, 0xA0, 0x86, 0x0E, 0x5A, 0x02, 0x9C, 0x1A, 0x79, 0x06, 0x78, 0xA4, 0x28, 0x71, 0xDE, 0x26, 0x3C, 0x01, 0xB3, 0x1B, 0x97, 0xA2, 0x12, 0x66, 0xA2, 0xE7, 0xE2, 0xC5, 0x14, 0x17, 0x05, 0x53, 0x7B, 0xF1, 0x19, 0x86, 0x88, 0x03, 0xDE, 0x10, 0xEE, 0x7C, 0x3F, 0x98, 0x3E, 0x10, 0x2C, 0x3F, 0xFE, 0xF1, 0x2F, 0xC0, 0xEE, 0x0A, 0x5C, 0x3E, 0x45, 0xE0, 0xD1, 0x48, 0x03, 0x8F, 0x71, 0x5F, 0xD6, 0xD0, 0x39, 0xC2, 0x05, 0x28, 0xB8, 0xEF, 0xF2, 0xF4, 0xD0, 0x34, 0x9E, 0xC6, 0x00, 0xE1, 0x83, 0xAC, 0x16, 0x83, 0x0F, 0xE4, 0xA0, 0x42, 0x4F, 0x60, 0x08, 0x0F, 0x6F, 0x9D, 0xE6, 0x32, 0xBC, 0xFA, 0xB9, 0xD4, 0xE2, 0x2B, 0x55, 0xE8, 0xD7, 0x8F, 0x90, 0x07, 0xC2, 0x14, 0x60, 0x35, 0xA3, 0x9A, 0x2C, 0x6D, 0xBA, 0x6A, 0xC3, 0x11, 0x21, 0x83, 0x01, 0x90, 0x9A, 0x78, 0xC8, 0xE0, 0x41, 0x08, 0xB3, 0x21, 0x50, 0xE8, 0xB2, 0xDB, 0xAF, 0x7F, 0xFB, 0x6D, 0x3B, 0xD3, 0x8A, 0x07, 0xF7, 0x87, 0xE9, 0x3A, 0xC2, 0x95, 0xA1, 0xB7, 0x84, 0xAF, 0x9B, 0xE6, 0xEE, 0x43, 0x95, 0x04, 0xED, 0x14, 0xF5, 0x14, 0x9E, 0x07, 0x91, 0x78, 0x58, 0x41, 0x83, 0xF2, 0x9A, 0xC2, 0xE3, 0xDC, 0x4A, 0xBC, 0x43, 0x33, 0x78, 0x1A, 0xA9, 0x0E, 0x37, 0xD4, 0x3B, 0xCB, 0x39, 0x3F, 0x20, 0x19, 0xF3, 0xE9, 0xC1, 0xED, 0x7F, 0x3D, 0x2E, 0x8A, 0xDE, 0x4A, 0x81, 0xF8, 0xE9, 0x7A, 0x9F, 0x3B, 0xFF, 0x47, 0x4D, 0x0F, 0x52, 0x7E, 0xC0, 0x37, 0xF1, 0xBF, 0x0D, 0xDD, 0xA7, 0x34, 0x80, 0xE3, 0x09, 0xA4, 0x4F, 0x4C, 0x68, 0x66, 0xE8, 0x9F, 0x88, 0xAD, 0x1A, 0x4B, 0x48, 0x25, 0xD3, 0xE5, 0x19, 0x04, 0xBE, 0xA6, 0xCE, 0xB6, 0x6A, 0x49, 0xF9, 0x8D, 0x36, 0xAD, 0x7C, 0x59, 0xB2, 0x78, 0x8E, 0x1F, 0x54, 0x3B, 0x9E, 0x5F, 0x07, 0x03, 0x3E, 0xEF, 0x3D, 0xEB, 0xF2, 0x09, 0xE4, 0x23, 0xBB, 0xCE, 0x91, 0xFC, 0x43, 0xD7, 0x7F, 0x00, 0x11, 0x5A, 0x5B, 0x75, 0x00, 0x1B, 0x00, 0x00
 };
 
-const size_t gallery_html_gz_len = 2476;
+const size_t gallery_html_gz_len = 2490;
 
 #endif
@@ -0,0 +1,421 @@
+/**
+ * @file photo_catalog.h
+ * @brief Append-only photo catalog with checkpoints and replay recovery
+ *
+ * Counting and listing photos used to enumerate /photos on the card. The
+ * catalog keeps one fixed-size record per photo in a small file instead,
+ * loaded once at boot and then served from RAM.
+ *
+ * File layout (two files, used alternately):
+ *
+ *   HEADER   generation, snapshot count
+ *   PHOTO    } snapshot of all photos at the checkpoint
+ *   END      snapshot complete
+ *   PHOTO / DELETE ...  journal appended since the checkpoint
+ *
+ * Every record carries its position in the file and a CRC, so replay stops
+ * at the first torn or stale record and the tail is cut off. A checkpoint
+ * writes a fresh snapshot into the other file; until its END record is on
+ * the card the previous file stays the valid one. Recovery picks the file
+ * with the highest generation whose snapshot is complete.
+ *
+ * All calls need the StorageGuard.
+ */
+
+#ifndef PHOTO_CATALOG_H
+#define PHOTO_CATALOG_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <time.h>
+
+//=============================================================================
+// CATALOG CONFIGURATION
+//=============================================================================
+namespace CatalogConfig {
+  const char* const  FILES[2]         = { "/catalog0.dat", "/catalog1.dat" };
+  constexpr uint32_t CHECKPOINT_EVERY = 64;          // Journal records before a checkpoint
+  constexpr uint32_t INITIAL_CAPACITY = 256;         // Photos; doubled as needed
+  constexpr uint32_t MAGIC            = 0x54414350;  // "PCAT"
+  constexpr uint8_t  IO_RECORDS       = 16;          // Records per card access (one block)
+}
+
+//=============================================================================
+// RECORD FORMAT
+//=============================================================================
+
+enum CatalogRecordType : uint8_t {
+  CAT_HEADER = 'H',   // number = generation, size = MAGIC, firstCluster = snapshot count
+  CAT_PHOTO  = 'P',
+  CAT_DELETE = 'D',
+  CAT_END    = 'E'    // number = snapshot count
+};
+
+struct CatalogRecord {
+  uint8_t  type;
+  uint8_t  reserved[3];
+  uint32_t sequence;      // Position in the file, header = 0
+  uint32_t number;        // Photo number N of photo_N.jpg
+  uint32_t size;          // File size in bytes
+  uint32_t firstCluster;
+  uint32_t timestamp;     // time(): wall clock if set, else seconds since boot
+  uint32_t thumbOffset;   // 0 = no thumbnail
+  uint32_t crc;           // CRC-32 of the fields above
+};
+
+static_assert(sizeof(CatalogRecord) == 32, "catalog records must be 32 bytes");
+
+//=============================================================================
+// PHOTO CATALOG
+//=============================================================================
+
+class PhotoCatalog {
+public:
+  /**
+   * @brief Recover the catalog from the card
+   *
+   * @return false if neither file holds a complete snapshot; the caller
+   *         then rebuilds it from a directory scan
+   */
+  static bool load() {
+    ready = false;
+    int8_t best = -1;
+    uint32_t bestGeneration = 0;
+    for (uint8_t i = 0; i < 2; i++) {
+      uint32_t gen;
+      if (probe(i, gen) && (best < 0 || gen > bestGeneration)) {
+        best = i;
+        bestGeneration = gen;
+      }
+    }
+    if (best < 0 || !replay(best)) return false;
+
+    Serial.printf("[CATALOG] %lu photos from %s (gen %lu, %lu journal records)\n",
+                  (unsigned long)entries, CatalogConfig::FILES[active],
+                  (unsigned long)generation, (unsigned long)journalRecords);
+    return true;
+  }
+
+  /** @brief true once loaded or rebuilt; until then nothing is journaled */
+  static bool isReady() { return ready; }
+
+  /**
+   * @brief Journal a new photo
+   *
+   * Call after the photo file is closed, so a catalog entry never points
+   * at data that is not on the card.
+   */
+  static bool add(uint32_t number, uint32_t size, uint32_t firstCluster,
+                  uint32_t thumbOffset = 0) {
+    CatalogRecord rec = {};
+    rec.type = CAT_PHOTO;
+    rec.number = number;
+    rec.size = size;
+    rec.firstCluster = firstCluster;
+    rec.timestamp = (uint32_t)time(NULL);
+    rec.thumbOffset = thumbOffset;
+    insert(rec);
+    return append(rec);
+  }
+
+  /**
+   * @brief Journal the thumbnail of a photo (thumbnail.h)
+   *
+   * Appends the whole record again; replay keeps the last one.
+   */
+  static bool setThumb(uint32_t number, uint32_t thumbOffset) {
+    int32_t i = find(number);
+    if (i < 0) return false;
+    records[i].thumbOffset = thumbOffset;
+    CatalogRecord rec = records[i];
+    return append(rec);
+  }
+
+  /** @brief Journal a deleted photo */
+  static bool remove(uint32_t number) {
+    int32_t i = find(number);
+    if (i < 0) return false;
+    erase(i);
+    CatalogRecord rec = {};
+    rec.type = CAT_DELETE;
+    rec.number = number;
+    return append(rec);
+  }
+
+  /**
+   * @brief Drop photos from..to after a bulk delete
+   *
+   * Writes one checkpoint instead of a DELETE record per photo.
+   *
+   * @return Number of photos dropped
+   */
+  static uint32_t removeRange(uint32_t from, uint32_t to) {
+    uint32_t first = 0;
+    while (first < entries && records[first].number < from) first++;
+    uint32_t last = first;
+    while (last < entries && records[last].number <= to) last++;
+    uint32_t n = last - first;
+    if (n == 0) return 0;
+    memmove(&records[first], &records[last], (entries - last) * sizeof(CatalogRecord));
+    entries -= n;
+    if (ready) checkpoint();
+    return n;
+  }
+
+  /**
+   * @brief Write a snapshot of all photos into the other file
+   *
+   * Called every CHECKPOINT_EVERY journal records and after a rebuild.
+   */
+  static bool checkpoint() {
+    uint8_t next = ready ? active ^ 1 : 0;
+    File file = SD.open(CatalogConfig::FILES[next], O_READ | O_WRITE | O_CREAT | O_TRUNC);
+    if (!file) return false;
+
+    CatalogRecord buf[CatalogConfig::IO_RECORDS];
+    uint8_t n = 0;
+    bool ok = true;
+
+    CatalogRecord& header = buf[n++];
+    header = CatalogRecord();
+    header.type = CAT_HEADER;
+    header.number = generation + 1;
+    header.size = CatalogConfig::MAGIC;
+    header.firstCluster = entries;
+    seal(header, 0);
+
+    for (uint32_t i = 0; i <= entries && ok; i++) {
+      CatalogRecord& rec = buf[n++];
+      if (i < entries) {
+        rec = records[i];
+      } else {
+        rec = CatalogRecord();
+        rec.type = CAT_END;
+        rec.number = entries;
+      }
+      seal(rec, i + 1);
+      if (n == CatalogConfig::IO_RECORDS || i == entries) {
+        ok = file.write((const uint8_t*)buf, n * sizeof(CatalogRecord)) ==
+             n * sizeof(CatalogRecord);
+        n = 0;
+      }
+    }
+    file.close();
+    if (!ok) return false;
+
+    active = next;
+    generation++;
+    fileRecords = entries + 2;
+    journalRecords = 0;
+    ready = true;
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+  // Rebuild from a directory scan (PhotoIndexJob)
+  //---------------------------------------------------------------------------
+
+  static void beginRebuild() {
+    entries = 0;
+  }
+
+  static void noteScanned(uint32_t number, uint32_t size, uint32_t firstCluster) {
+    if (number == 0) return;
+    CatalogRecord rec = {};
+    rec.type = CAT_PHOTO;
+    rec.number = number;
+    rec.size = size;
+    rec.firstCluster = firstCluster;
+    insert(rec);
+  }
+
+  static void noteScanned(uint32_t number, File& file) {
+    noteScanned(number, file.size(), file.firstCluster());
+  }
+
+  static bool endRebuild() {
+    return checkpoint();
+  }
+
+  //---------------------------------------------------------------------------
+  // Listing (photos in number order)
+  //---------------------------------------------------------------------------
+
+  static uint32_t count() { return entries; }
+  static const CatalogRecord& at(uint32_t i) { return records[i]; }
+
+  /** @brief Index of photo number, or -1 */
+  static int32_t find(uint32_t number) {
+    uint32_t lo = 0, hi = entries;
+    while (lo < hi) {
+      uint32_t mid = (lo + hi) / 2;
+      if (records[mid].number < number) lo = mid + 1; else hi = mid;
+    }
+    return (lo < entries && records[lo].number == number) ? (int32_t)lo : -1;
+  }
+
+private:
+  /** @brief true if file i has a complete snapshot; returns its generation */
+  static bool probe(uint8_t i, uint32_t& gen) {
+    File file = SD.open(CatalogConfig::FILES[i], FILE_READ);
+    if (!file) return false;
+
+    CatalogRecord header, end;
+    bool ok = file.read(&header, sizeof(header)) == sizeof(header) &&
+              valid(header, 0) && header.type == CAT_HEADER &&
+              header.size == CatalogConfig::MAGIC &&
+              file.seek((header.firstCluster + 1) * sizeof(CatalogRecord)) &&
+              file.read(&end, sizeof(end)) == sizeof(end) &&
+              valid(end, header.firstCluster + 1) && end.type == CAT_END;
+    file.close();
+    gen = header.number;
+    return ok;
+  }
+
+  /** @brief Load snapshot and journal of file i, cutting off a torn tail */
+  static bool replay(uint8_t i) {
+    File file = SD.open(CatalogConfig::FILES[i], FILE_READ);
+    if (!file) return false;
+    uint32_t fileSize = file.size();
+
+    CatalogRecord buf[CatalogConfig::IO_RECORDS];
+    uint32_t seq = 0;
+    uint32_t snapshotEnd = 0;
+    bool done = false;
+    entries = 0;
+
+    while (!done) {
+      int got = file.read(buf, sizeof(buf));
+      if (got <= 0) break;
+      uint8_t n = got / sizeof(CatalogRecord);
+      if (n == 0) break;
+      for (uint8_t k = 0; k < n; k++, seq++) {
+        const CatalogRecord& rec = buf[k];
+        if (!valid(rec, seq) || (seq == 0) != (rec.type == CAT_HEADER)) {
+          done = true;
+          break;
+        }
+        if (rec.type == CAT_HEADER) {
+          generation = rec.number;
+        } else if (rec.type == CAT_PHOTO) {
+          insert(rec);
+        } else if (rec.type == CAT_DELETE) {
+          int32_t j = find(rec.number);
+          if (j >= 0) erase(j);
+        } else if (rec.type == CAT_END) {
+          snapshotEnd = seq + 1;
+        } else {
+          done = true;
+          break;
+        }
+      }
+    }
+    file.close();
+    if (snapshotEnd == 0) return false;
+
+    // Cut off a torn or stale tail so new records follow the last good one
+    uint32_t validBytes = seq * sizeof(CatalogRecord);
+    if (fileSize > validBytes) {
+      Serial.printf("[CATALOG] Dropping %lu bytes after record %lu\n",
+                    (unsigned long)(fileSize - validBytes), (unsigned long)seq);
+      File tail = SD.open(CatalogConfig::FILES[i], O_READ | O_WRITE);
+      if (!tail || !tail.truncate(validBytes)) return false;
+      tail.close();
+    }
+
+    active = i;
+    fileRecords = seq;
+    journalRecords = seq - snapshotEnd;
+    ready = true;
+    return true;
+  }
+
+  static bool append(CatalogRecord& rec) {
+    if (!ready) return false;
+    File file = SD.open(CatalogConfig::FILES[active], FILE_WRITE);
+    if (!file) return false;
+    seal(rec, fileRecords);
+    bool ok = file.write((const uint8_t*)&rec, sizeof(rec)) == sizeof(rec);
+    file.close();
+    if (!ok) return false;
+
+    fileRecords++;
+    if (++journalRecords >= CatalogConfig::CHECKPOINT_EVERY) {
+      checkpoint();
+    }
+    return true;
+  }
+
+  /** @brief Insert or replace rec, keeping number order */
+  static bool insert(const CatalogRecord& rec) {
+    int32_t i = find(rec.number);
+    if (i >= 0) {
+      records[i] = rec;
+      return true;
+    }
+    if (entries == capacity && !grow()) return false;
+
+    uint32_t pos = entries;
+    while (pos > 0 && records[pos - 1].number > rec.number) pos--;
+    memmove(&records[pos + 1], &records[pos], (entries - pos) * sizeof(CatalogRecord));
+    records[pos] = rec;
+    entries++;
+    return true;
+  }
+
+  static void erase(uint32_t i) {
+    memmove(&records[i], &records[i + 1], (entries - i - 1) * sizeof(CatalogRecord));
+    entries--;
+  }
+
+  static bool grow() {
+    uint32_t want = capacity ? capacity * 2 : CatalogConfig::INITIAL_CAPACITY;
+    CatalogRecord* grown = (CatalogRecord*)realloc(records, want * sizeof(CatalogRecord));
+    if (grown == NULL) return false;
+    records = grown;
+    capacity = want;
+    return true;
+  }
+
+  static void seal(CatalogRecord& rec, uint32_t sequence) {
+    rec.sequence = sequence;
+    rec.crc = crc32((const uint8_t*)&rec, offsetof(CatalogRecord, crc));
+  }
+
+  static bool valid(const CatalogRecord& rec, uint32_t sequence) {
+    return rec.sequence == sequence &&
+           rec.crc == crc32((const uint8_t*)&rec, offsetof(CatalogRecord, crc));
+  }
+
+  static uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--) {
+      crc ^= *data++;
+      for (uint8_t b = 0; b < 8; b++) {
+        crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+      }
+    }
+    return ~crc;
+  }
+
+  static CatalogRecord* records;   // Live photos in number order
+  static uint32_t entries;
+  static uint32_t capacity;
+  static bool ready;
+  static uint8_t active;           // File index journaled to
+  static uint32_t generation;      // Of the active file's snapshot
+  static uint32_t fileRecords;     // Records in the active file (next sequence)
+  static uint32_t journalRecords;  // Records since the snapshot
+};
+
+// Static member initialization
+CatalogRecord* PhotoCatalog::records = NULL;
+uint32_t PhotoCatalog::entries = 0;
+uint32_t PhotoCatalog::capacity = 0;
+bool PhotoCatalog::ready = false;
+uint8_t PhotoCatalog::active = 0;
+uint32_t PhotoCatalog::generation = 0;
+uint32_t PhotoCatalog::fileRecords = 0;
+uint32_t PhotoCatalog::journalRecords = 0;
+
+#endif // PHOTO_CATALOG_H
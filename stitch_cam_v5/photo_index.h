@@ -0,0 +1,336 @@
+/**
+ * @file photo_index.h
+ * @brief In-memory index of /photos for opening photos without a directory search
+ *
+ * SD.open() walks the path and compares 8.3 names entry by entry, so every
+ * gallery step and web download paid a linear scan of /photos. Photos are
+ * named by number, so the number itself is the hash key: the index maps N
+ * to the location of its directory entry (block + slot) and SD.openEntry()
+ * opens it with a single cached block read.
+ *
+ * The SD library only handles 8.3 names, so photo N is stored as
+ * /photos/P000000N.JPG and exported to the web as photo_N.jpg. Cards
+ * written by older firmware hold photo_N.jpg itself, which fits 8.3 only
+ * up to photo_99.jpg; those are still found and removed.
+ *
+ * Built once by PhotoIndexJob (boot and gallery rescans), then kept current
+ * by closePhotoFile() and the delete paths. An entry that no longer holds
+ * the expected name is dropped and the lookup falls back to SD.open().
+ * All calls need the StorageGuard.
+ */
+
+#ifndef PHOTO_INDEX_H
+#define PHOTO_INDEX_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "slice_executor.h"
+#include "photo_catalog.h"
+#include "photo_pack.h"
+
+//=============================================================================
+// INDEX CONFIGURATION
+//=============================================================================
+namespace PhotoIndexConfig {
+  constexpr uint32_t INITIAL_CAPACITY = 256;      // Entries; doubled as needed
+  constexpr uint32_t MAX_NUMBER       = 65535;    // Highest photo number indexed
+  constexpr uint32_t LEGACY_MAX_NUMBER = 99;      // Last 8.3-safe photo_N.jpg
+  const char* const  DIR              = "/photos";
+}
+
+//=============================================================================
+// PHOTO INDEX
+//=============================================================================
+
+class PhotoIndex {
+public:
+  /** @brief Forget all entries (the table is kept) */
+  static void clear() {
+    if (locations != NULL) memset(locations, 0, capacity * sizeof(uint32_t));
+    entries = 0;
+    highest = 0;
+  }
+
+  /**
+   * @brief Record where photo number's directory entry is
+   *
+   * @param number Photo number N of photo_N.jpg
+   * @param file Open file of that photo
+   * @return false if the table could not grow (lookup falls back to SD.open)
+   */
+  static bool add(uint32_t number, File& file) {
+    if (number == 0 || number > PhotoIndexConfig::MAX_NUMBER) return false;
+    // Packed as block << 4 | slot; block 0 (MBR) never holds a directory
+    uint32_t block = file.dirBlock();
+    if (block == 0 || block >= (1UL << 28)) return false;
+    if (number > capacity && !grow(number)) return false;
+
+    if (locations[number - 1] == 0) entries++;
+    locations[number - 1] = block << 4 | file.dirIndex();
+    if (number > highest) highest = number;
+    return true;
+  }
+
+  /** @brief Drop photo number after it has been deleted */
+  static void remove(uint32_t number) {
+    if (number == 0 || number > capacity || locations[number - 1] == 0) return;
+    locations[number - 1] = 0;
+    entries--;
+  }
+
+  /** @brief Drop photos from..to after a bulk delete */
+  static void removeRange(uint32_t from, uint32_t to) {
+    if (from == 0) from = 1;
+    if (to > capacity) to = capacity;
+    for (uint32_t number = from; number <= to; number++) remove(number);
+  }
+
+  /**
+   * @brief Open photo number
+   *
+   * Indexed photos open by directory entry location; others are opened by
+   * path and added to the index.
+   */
+  static File open(uint32_t number, uint8_t mode = FILE_READ) {
+    uint32_t loc = (number != 0 && number <= capacity) ? locations[number - 1] : 0;
+    if (loc != 0) {
+      File file = SD.openEntry(loc >> 4, loc & 0XF, mode);
+      if (file && parseNumber(file.name()) == number) {
+        hits++;
+        return file;
+      }
+      if (file) file.close();
+      remove(number);
+    }
+
+    misses++;
+    char path[32];
+    photoPath(number, path, sizeof(path));
+    File file = SD.open(path, mode);
+    if (!file && legacyPath(number, path, sizeof(path))) {
+      file = SD.open(path, mode);
+    }
+    if (file) add(number, file);
+    return file;
+  }
+
+  /**
+   * @brief Delete photo number's file (either naming scheme)
+   * @return true if a file was removed
+   */
+  static bool removeFile(uint32_t number) {
+    char path[32];
+    photoPath(number, path, sizeof(path));
+    bool removed = SD.remove(path) ||
+                   (legacyPath(number, path, sizeof(path)) && SD.remove(path));
+    if (removed) noteDirChange();
+    return removed;
+  }
+
+  /**
+   * @brief Re-open a photo kept open across a StorageGuard release
+   *
+   * A photo deleted while the lock was dropped has its clusters freed, and
+   * a save may already have reused them, so a File held across the gap is
+   * only read on once /photos is known unchanged or the photo has been
+   * found again: same name, size and first cluster. Caller holds the
+   * StorageGuard.
+   *
+   * @param file Open photo; on a /photos change it is reopened in place
+   * @param number Photo number, or 0 to reopen by path
+   * @param path Path the photo was opened by when number is 0
+   * @param position Read position to resume at
+   * @param seen dirChangeCount() the file was last checked at (updated)
+   * @return false if the photo is gone or changed (file is then closed)
+   */
+  static bool revalidate(File& file, uint32_t number, const char* path,
+                         uint32_t position, uint32_t& seen) {
+    if (seen == dirChanges) return true;
+    seen = dirChanges;
+    uint32_t size = file.size();
+    uint32_t cluster = file.firstCluster();
+    file.close();
+    file = number != 0 ? open(number) : SD.open(path, FILE_READ);
+    if (file && file.size() == size && file.firstCluster() == cluster &&
+        file.seek(position)) {
+      return true;
+    }
+    if (file) file.close();
+    return false;
+  }
+
+  /**
+   * @brief Note that a /photos directory entry was created or deleted
+   *
+   * Walks of /photos and photo reads that drop the StorageGuard part way
+   * compare dirChangeCount() across the gap and restart or re-open.
+   */
+  static void noteDirChange() { dirChanges++; }
+  static uint32_t dirChangeCount() { return dirChanges; }
+
+  /** @brief Card path of photo number: /photos/P0000123.JPG */
+  static void photoPath(uint32_t number, char* path, size_t size) {
+    snprintf(path, size, "%s/P%07lu.JPG", PhotoIndexConfig::DIR,
+             (unsigned long)number);
+  }
+
+  /** @brief Name photo number is listed and downloaded under: photo_123.jpg */
+  static void exportName(uint32_t number, char* name, size_t size) {
+    snprintf(name, size, "photo_%lu.jpg", (unsigned long)number);
+  }
+
+  /**
+   * @brief Photo number of a file name
+   * @return N for "P000000N.JPG" or "photo_N.jpg" (any case), 0 for other names
+   */
+  static uint32_t parseNumber(const char* name) {
+    const char* p;
+    if (strncasecmp(name, "photo_", 6) == 0) {
+      p = name + 6;
+    } else if ((name[0] == 'P' || name[0] == 'p') && strlen(name) == 12) {
+      p = name + 1;
+    } else {
+      return 0;
+    }
+    uint32_t number = 0;
+    while (*p >= '0' && *p <= '9') {
+      number = number * 10 + (*p++ - '0');
+      if (number > PhotoIndexConfig::MAX_NUMBER) return 0;
+    }
+    return strcasecmp(p, ".jpg") == 0 ? number : 0;
+  }
+
+  static uint32_t size() { return entries; }
+  /** @brief Highest number added since the last clear() (not lowered by remove) */
+  static uint32_t highestNumber() { return highest; }
+  static uint32_t hitCount() { return hits; }
+  static uint32_t missCount() { return misses; }
+
+private:
+  /** @brief Path older firmware used for photo number, false if it had none */
+  static bool legacyPath(uint32_t number, char* path, size_t size) {
+    if (number > PhotoIndexConfig::LEGACY_MAX_NUMBER) return false;
+    snprintf(path, size, "%s/photo_%lu.jpg", PhotoIndexConfig::DIR,
+             (unsigned long)number);
+    return true;
+  }
+
+  static bool grow(uint32_t number) {
+    uint32_t want = capacity ? capacity : PhotoIndexConfig::INITIAL_CAPACITY;
+    while (want < number) want *= 2;
+    if (want > PhotoIndexConfig::MAX_NUMBER) want = PhotoIndexConfig::MAX_NUMBER;
+
+    uint32_t* grown = (uint32_t*)realloc(locations, want * sizeof(uint32_t));
+    if (grown == NULL) return false;
+    memset(grown + capacity, 0, (want - capacity) * sizeof(uint32_t));
+    locations = grown;
+    capacity = want;
+    return true;
+  }
+
+  static uint32_t* locations;   // Entry location of photo N at [N - 1], 0 = unknown
+  static uint32_t capacity;
+  static uint32_t entries;
+  static uint32_t highest;
+  static uint32_t hits;
+  static uint32_t misses;
+  static uint32_t dirChanges;
+};
+
+//=============================================================================
+// INDEX BUILD
+//=============================================================================
+
+/**
+ * @brief Rebuilds the photo index and counts the photos in /photos
+ *
+ * Only files with a photo name (see PhotoIndex::parseNumber()) count;
+ * entries are recorded while the directory is read, so the rebuild costs
+ * no extra card access. The photo catalog is
+ * rebuilt from the same pass and checkpointed when the scan completes.
+ * Photos in the pack have no directory entry and are added from its
+ * region list.
+ *
+ * The directory is read with the StorageGuard dropped between steps. A
+ * photo saved or deleted in a gap could be skipped or counted twice by
+ * the open walk, so the scan starts over when PhotoIndex::dirChangeCount()
+ * moved since it began.
+ */
+class PhotoIndexJob : public SliceJob {
+public:
+  typedef void (*DoneCallback)(int count);
+
+  explicit PhotoIndexJob(DoneCallback onDone = NULL) : onDone(onDone) {}
+
+  bool step(SliceBudget& budget) override {
+    if (scanning && PhotoIndex::dirChangeCount() != walkChanges) {
+      root.close();
+      scanning = false;
+      restarts++;
+    }
+    if (!scanning) {
+      walkChanges = PhotoIndex::dirChangeCount();
+      count = 0;
+      if (restarts == 0) startMs = millis();
+      PhotoIndex::clear();
+      PhotoCatalog::beginRebuild();
+      root = SD.open(PhotoIndexConfig::DIR);
+      if (!root) return true;
+      scanning = true;
+    }
+
+    while (!budget.expired()) {
+      File file = root.openNextFile();
+      if (!file) {
+        root.close();
+        scanning = false;
+        for (uint32_t i = 0; i < PhotoPack::regionTotal(); i++) {
+          const PackRegion& r = PhotoPack::region(i);
+          if (r.state != PACK_LIVE) continue;
+          count++;
+          PhotoCatalog::noteScanned(r.number, r.length, 0);
+        }
+        PhotoCatalog::endRebuild();
+        return true;
+      }
+      uint32_t number = file.isDirectory() ? 0 : PhotoIndex::parseNumber(file.name());
+      if (number != 0) {
+        count++;
+        PhotoIndex::add(number, file);
+        PhotoCatalog::noteScanned(number, file);
+      }
+      file.close();
+    }
+    return false;
+  }
+
+  void finish() override {
+    Serial.printf("[INDEX] %d photos, %lu indexed in %lu ms (%u restarts)\n", count,
+                  (unsigned long)PhotoIndex::size(),
+                  (unsigned long)(millis() - startMs), restarts);
+    restarts = 0;
+    if (onDone) onDone(count);
+  }
+
+  int result() const { return count; }
+
+private:
+  DoneCallback onDone;
+  File root;
+  bool scanning = false;
+  int count = 0;
+  uint32_t startMs = 0;
+  uint32_t walkChanges = 0;
+  unsigned restarts = 0;
+};
+
+// Static member initialization
+uint32_t* PhotoIndex::locations = NULL;
+uint32_t PhotoIndex::capacity = 0;
+uint32_t PhotoIndex::entries = 0;
+uint32_t PhotoIndex::highest = 0;
+uint32_t PhotoIndex::hits = 0;
+uint32_t PhotoIndex::misses = 0;
+uint32_t PhotoIndex::dirChanges = 0;
+
+#endif // PHOTO_INDEX_H
@@ -0,0 +1,479 @@
+/**
+ * @file photo_pack.h
+ * @brief Packed photo container: many JPEGs back-to-back in one file
+ *
+ * A separate FAT file per 20-40 KB photo costs a directory entry, a FAT
+ * chain and on average half a cluster of slack. The pack is one file,
+ * reserved contiguously when it is created, holding block-aligned regions:
+ *
+ *   [PackHeader 32 B][JPEG ...][pad to 512 B]  live photo
+ *   [PackHeader 32 B][...]                     tombstone or free space
+ *
+ * Each header gives the span to the next one, so the in-RAM region list is
+ * rebuilt at boot by walking one header per photo.
+ *
+ * The pack saves slack and directory entries, not time: in StorageBenchmark
+ * (pack_save, pack_list) a save costs about 15% more than a preallocated
+ * file, for the extra flushed header writes, and walking the headers reads
+ * a block per photo where the directory holds 16 entries per block.
+ *
+ * Crash safety: a photo's data is written before its header, and the free
+ * space header that splits off the rest of a region is written before
+ * either, so until the new header lands the old one still describes the
+ * region. Anything past the last valid header is reclaimed as free space.
+ * Deletes overwrite the header with a tombstone. The compactor coalesces
+ * neighbouring holes and moves the last photo into the first hole that
+ * fits, copying before it tombstones the original; a duplicate left by a
+ * crash mid-move is resolved at load by keeping the lower copy.
+ *
+ * All calls need the StorageGuard.
+ */
+
+#ifndef PHOTO_PACK_H
+#define PHOTO_PACK_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <time.h>
+#include "slice_executor.h"
+
+//=============================================================================
+// PACK CONFIGURATION
+//=============================================================================
+namespace PackConfig {
+  constexpr bool     ENABLED          = false;              // Save new photos into the pack
+  const char* const  FILE_PATH        = "/photos.pak";
+  constexpr uint32_t INITIAL_BYTES    = 4UL * 1024 * 1024;  // Reserved contiguously at creation
+  constexpr uint32_t BLOCK            = 512;                // Region alignment
+  constexpr uint32_t MAGIC            = 0x4B415050;         // "PPAK"
+  constexpr uint8_t  COMPACT_HOLE_PCT = 25;                 // Compact when holes pass this share
+  constexpr uint32_t COPY_BYTES       = 4096;               // Compactor and fill buffer
+  constexpr uint32_t INITIAL_REGIONS  = 64;                 // Doubled as needed
+}
+
+//=============================================================================
+// FORMAT
+//=============================================================================
+
+enum PackState : uint8_t {
+  PACK_FREE = 'F',
+  PACK_LIVE = 'L',
+  PACK_DEAD = 'D'     // Tombstone of a deleted photo, reusable like free space
+};
+
+struct PackHeader {
+  uint32_t magic;
+  uint8_t  state;
+  uint8_t  reserved[3];
+  uint32_t number;      // Photo number N (export name photo_N.jpg)
+  uint32_t length;      // JPEG bytes
+  uint32_t span;        // Bytes from this header to the next, multiple of BLOCK
+  uint32_t timestamp;
+  uint32_t reserved2;
+  uint32_t crc;         // CRC-32 of the fields above
+};
+
+static_assert(sizeof(PackHeader) == 32, "pack headers must be 32 bytes");
+
+struct PackRegion {
+  uint32_t offset;
+  uint32_t span;
+  uint32_t number;
+  uint32_t length;
+  uint8_t  state;
+};
+
+//=============================================================================
+// PHOTO PACK
+//=============================================================================
+
+class PhotoPack {
+public:
+  /**
+   * @brief Open (or create and reserve) the pack and walk its headers
+   */
+  static bool begin() {
+    if (file) return true;
+    // O_SYNC keeps flush() a write barrier under SD_SYNC_DEFERRED; the
+    // data-before-header ordering above depends on it
+    file = SD.open(PackConfig::FILE_PATH, O_READ | O_WRITE | O_CREAT | O_SYNC);
+    if (!file) return false;
+
+    if (file.size() < PackConfig::BLOCK && !format()) {
+      file.close();
+      return false;
+    }
+    if (!load()) {
+      file.close();
+      return false;
+    }
+    Serial.printf("[PACK] %lu photos, %lu KB live, %lu KB holes, %lu KB file\n",
+                  (unsigned long)liveCount, (unsigned long)(liveBytes >> 10),
+                  (unsigned long)(holeBytes() >> 10), (unsigned long)(fileBytes >> 10));
+    return true;
+  }
+
+  static bool isOpen() { return (bool)file; }
+
+  /**
+   * @brief Store a photo in the first region that fits, else at the end
+   */
+  static bool save(uint32_t number, const uint8_t* data, uint32_t length) {
+    if (!file || find(number) >= 0) return false;
+    uint32_t span = spanFor(length);
+
+    int32_t r = findSpace(span);
+    uint32_t off;
+    if (r >= 0) {
+      off = regions[r].offset;
+      uint32_t rest = regions[r].span - span;
+      if (rest && !writeHeader(off + span, PACK_FREE, 0, 0, rest)) return false;
+      if (!file.seek(off + sizeof(PackHeader)) || file.write(data, length) != length) {
+        return false;
+      }
+      if (!writeHeader(off, PACK_LIVE, number, length, span)) return false;
+      setRegion(r, off, span, number, length, PACK_LIVE);
+      if (rest && !insertRegion(r + 1, off + span, rest, 0, 0, PACK_FREE)) return false;
+    } else {
+      // Append: placeholder header, data and padding, then the real header
+      off = fileBytes;
+      if (!file.seek(off) || !fill(sizeof(PackHeader))) return false;
+      if (file.write(data, length) != length) return false;
+      if (!fill(span - sizeof(PackHeader) - length)) return false;
+      if (!writeHeader(off, PACK_LIVE, number, length, span)) return false;
+      if (!insertRegion(regionCount, off, span, number, length, PACK_LIVE)) return false;
+      fileBytes += span;
+    }
+    file.flush();
+    liveCount++;
+    liveBytes += span;
+    return true;
+  }
+
+  /** @brief Tombstone a photo */
+  static bool remove(uint32_t number) {
+    int32_t r = find(number);
+    if (r < 0) return false;
+    PackRegion& g = regions[r];
+    if (!writeHeader(g.offset, PACK_DEAD, g.number, g.length, g.span)) return false;
+    file.flush();
+    g.state = PACK_DEAD;
+    liveCount--;
+    liveBytes -= g.span;
+    return true;
+  }
+
+  /**
+   * @brief Tombstone every photo numbered from..to, with one flush
+   * @return Number of photos tombstoned, or -1 on a write error
+   */
+  static int32_t removeRange(uint32_t from, uint32_t to) {
+    int32_t n = 0;
+    for (uint32_t i = 0; i < regionCount; i++) {
+      PackRegion& g = regions[i];
+      if (g.state != PACK_LIVE || g.number < from || g.number > to) continue;
+      if (!writeHeader(g.offset, PACK_DEAD, g.number, g.length, g.span)) {
+        n = -1;
+        break;
+      }
+      g.state = PACK_DEAD;
+      liveCount--;
+      liveBytes -= g.span;
+      n++;
+    }
+    if (n != 0) file.flush();
+    return n;
+  }
+
+  static bool contains(uint32_t number) { return find(number) >= 0; }
+
+  /** @brief JPEG length of a packed photo (0 if not packed) */
+  static uint32_t length(uint32_t number) {
+    int32_t r = find(number);
+    return r < 0 ? 0 : regions[r].length;
+  }
+
+  /**
+   * @brief Read part of a packed photo
+   * @return Bytes read, 0 at end, -1 on error
+   */
+  static int read(uint32_t number, uint32_t pos, uint8_t* dst, uint32_t n) {
+    int32_t r = find(number);
+    if (r < 0) return -1;
+    const PackRegion& g = regions[r];
+    if (pos >= g.length) return 0;
+    if (n > g.length - pos) n = g.length - pos;
+    if (!file.seek(g.offset + sizeof(PackHeader) + pos)) return -1;
+    return file.read(dst, n);
+  }
+
+  /** @brief Live photos; region(i) for i < regionTotal() in file order */
+  static uint32_t count() { return liveCount; }
+  static uint32_t regionTotal() { return regionCount; }
+  static const PackRegion& region(uint32_t i) { return regions[i]; }
+
+  /** @brief Free or tombstoned bytes below the last live photo */
+  static uint32_t holeBytes() {
+    int32_t last = lastLive();
+    uint32_t bytes = 0;
+    for (int32_t i = 0; i < last; i++) {
+      if (regions[i].state != PACK_LIVE) bytes += regions[i].span;
+    }
+    return bytes;
+  }
+
+  static bool needsCompaction() {
+    return file && fileBytes &&
+           (uint64_t)holeBytes() * 100 / fileBytes >= PackConfig::COMPACT_HOLE_PCT;
+  }
+
+  /**
+   * @brief One unit of compaction
+   * @return true when there is nothing left to do
+   */
+  static bool compactStep() {
+    if (!file) return true;
+
+    // Coalesce neighbouring holes
+    for (uint32_t i = 0; i + 1 < regionCount; i++) {
+      if (regions[i].state != PACK_LIVE && regions[i + 1].state != PACK_LIVE) {
+        uint32_t span = regions[i].span + regions[i + 1].span;
+        if (!writeHeader(regions[i].offset, PACK_FREE, 0, 0, span)) return true;
+        file.flush();
+        setRegion(i, regions[i].offset, span, 0, 0, PACK_FREE);
+        eraseRegion(i + 1);
+        return false;
+      }
+    }
+
+    // Move the last photo down into the first hole it fits
+    int32_t last = lastLive();
+    for (int32_t i = 0; i < last; i++) {
+      if (regions[i].state != PACK_LIVE && regions[i].span >= regions[last].span) {
+        return !move(last, i);
+      }
+    }
+    return true;
+  }
+
+private:
+  /** @brief Reserve and zero-fill the initial extent, one free region */
+  static bool format() {
+    file.preAllocate(PackConfig::INITIAL_BYTES);
+    if (!file.seek(0) || !fill(PackConfig::INITIAL_BYTES)) return false;
+    if (!writeHeader(0, PACK_FREE, 0, 0, PackConfig::INITIAL_BYTES)) return false;
+    file.flush();
+    Serial.printf("[PACK] Created %s, %lu KB\n", PackConfig::FILE_PATH,
+                  (unsigned long)(PackConfig::INITIAL_BYTES >> 10));
+    return true;
+  }
+
+  /** @brief Rebuild the region list by walking the headers */
+  static bool load() {
+    regionCount = 0;
+    liveCount = 0;
+    liveBytes = 0;
+    fileBytes = file.size() & ~(PackConfig::BLOCK - 1);
+
+    uint32_t off = 0;
+    while (off < fileBytes) {
+      PackHeader h;
+      if (!readHeader(off, h)) {
+        // Torn write: everything after the last good header is free
+        uint32_t rest = fileBytes - off;
+        Serial.printf("[PACK] Reclaiming %lu bytes at %lu\n",
+                      (unsigned long)rest, (unsigned long)off);
+        if (!writeHeader(off, PACK_FREE, 0, 0, rest)) return false;
+        file.flush();
+        if (!insertRegion(regionCount, off, rest, 0, 0, PACK_FREE)) return false;
+        break;
+      }
+      uint8_t state = h.state;
+      if (state == PACK_LIVE && find(h.number) >= 0) {
+        // Original of an interrupted compaction move; the lower copy wins
+        if (!writeHeader(off, PACK_DEAD, h.number, h.length, h.span)) return false;
+        file.flush();
+        state = PACK_DEAD;
+      }
+      if (!insertRegion(regionCount, off, h.span, h.number, h.length, state)) return false;
+      if (state == PACK_LIVE) {
+        liveCount++;
+        liveBytes += h.span;
+      }
+      off += h.span;
+    }
+    return true;
+  }
+
+  /** @brief Copy region src into hole dst, then tombstone src */
+  static bool move(uint32_t src, uint32_t dst) {
+    PackRegion s = regions[src];
+    PackRegion d = regions[dst];
+    uint32_t rest = d.span - s.span;
+
+    if (rest && !writeHeader(d.offset + s.span, PACK_FREE, 0, 0, rest)) return false;
+    for (uint32_t pos = 0; pos < s.length; ) {
+      uint32_t n = s.length - pos;
+      if (n > PackConfig::COPY_BYTES) n = PackConfig::COPY_BYTES;
+      if (!file.seek(s.offset + sizeof(PackHeader) + pos) ||
+          file.read(copyBuf, n) != (int)n ||
+          !file.seek(d.offset + sizeof(PackHeader) + pos) ||
+          file.write(copyBuf, n) != n) {
+        return false;
+      }
+      pos += n;
+    }
+    if (!writeHeader(d.offset, PACK_LIVE, s.number, s.length, s.span)) return false;
+    file.flush();
+    if (!writeHeader(s.offset, PACK_DEAD, s.number, s.length, s.span)) return false;
+    file.flush();
+
+    setRegion(src, s.offset, s.span, s.number, s.length, PACK_DEAD);
+    setRegion(dst, d.offset, s.span, s.number, s.length, PACK_LIVE);
+    if (rest) insertRegion(dst + 1, d.offset + s.span, rest, 0, 0, PACK_FREE);
+    return true;
+  }
+
+  static uint32_t spanFor(uint32_t length) {
+    uint32_t bytes = sizeof(PackHeader) + length;
+    return (bytes + PackConfig::BLOCK - 1) & ~(PackConfig::BLOCK - 1);
+  }
+
+  static int32_t find(uint32_t number) {
+    for (uint32_t i = 0; i < regionCount; i++) {
+      if (regions[i].state == PACK_LIVE && regions[i].number == number) return i;
+    }
+    return -1;
+  }
+
+  static int32_t findSpace(uint32_t span) {
+    for (uint32_t i = 0; i < regionCount; i++) {
+      if (regions[i].state != PACK_LIVE && regions[i].span >= span) return i;
+    }
+    return -1;
+  }
+
+  static int32_t lastLive() {
+    for (int32_t i = (int32_t)regionCount - 1; i >= 0; i--) {
+      if (regions[i].state == PACK_LIVE) return i;
+    }
+    return -1;
+  }
+
+  /** @brief Write n zero bytes at the current position */
+  static bool fill(uint32_t n) {
+    memset(copyBuf, 0, sizeof(copyBuf));
+    while (n > 0) {
+      uint32_t chunk = n < sizeof(copyBuf) ? n : sizeof(copyBuf);
+      if (file.write(copyBuf, chunk) != chunk) return false;
+      n -= chunk;
+    }
+    return true;
+  }
+
+  static bool readHeader(uint32_t off, PackHeader& h) {
+    if (!file.seek(off) || file.read(&h, sizeof(h)) != sizeof(h)) return false;
+    return h.magic == PackConfig::MAGIC &&
+           h.crc == crc32((const uint8_t*)&h, offsetof(PackHeader, crc)) &&
+           h.span >= PackConfig::BLOCK && (h.span & (PackConfig::BLOCK - 1)) == 0 &&
+           off + h.span <= fileBytes &&
+           (h.state != PACK_LIVE || sizeof(PackHeader) + h.length <= h.span);
+  }
+
+  static bool writeHeader(uint32_t off, uint8_t state, uint32_t number,
+                          uint32_t length, uint32_t span) {
+    PackHeader h = {};
+    h.magic = PackConfig::MAGIC;
+    h.state = state;
+    h.number = number;
+    h.length = length;
+    h.span = span;
+    h.timestamp = (uint32_t)time(NULL);
+    h.crc = crc32((const uint8_t*)&h, offsetof(PackHeader, crc));
+    return file.seek(off) &&
+           file.write((const uint8_t*)&h, sizeof(h)) == sizeof(h);
+  }
+
+  static void setRegion(uint32_t i, uint32_t offset, uint32_t span,
+                        uint32_t number, uint32_t length, uint8_t state) {
+    regions[i].offset = offset;
+    regions[i].span = span;
+    regions[i].number = number;
+    regions[i].length = length;
+    regions[i].state = state;
+  }
+
+  static bool insertRegion(uint32_t i, uint32_t offset, uint32_t span,
+                           uint32_t number, uint32_t length, uint8_t state) {
+    if (regionCount == regionCapacity) {
+      uint32_t want = regionCapacity ? regionCapacity * 2 : PackConfig::INITIAL_REGIONS;
+      PackRegion* grown = (PackRegion*)realloc(regions, want * sizeof(PackRegion));
+      if (grown == NULL) return false;
+      regions = grown;
+      regionCapacity = want;
+    }
+    memmove(&regions[i + 1], &regions[i], (regionCount - i) * sizeof(PackRegion));
+    regionCount++;
+    setRegion(i, offset, span, number, length, state);
+    return true;
+  }
+
+  static void eraseRegion(uint32_t i) {
+    memmove(&regions[i], &regions[i + 1], (regionCount - i - 1) * sizeof(PackRegion));
+    regionCount--;
+  }
+
+  static uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--) {
+      crc ^= *data++;
+      for (uint8_t b = 0; b < 8; b++) {
+        crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+      }
+    }
+    return ~crc;
+  }
+
+  static File file;
+  static PackRegion* regions;     // All regions in file order
+  static uint32_t regionCount;
+  static uint32_t regionCapacity;
+  static uint32_t fileBytes;      // Walked size, a multiple of BLOCK
+  static uint32_t liveCount;
+  static uint32_t liveBytes;
+  static uint8_t copyBuf[PackConfig::COPY_BYTES];
+};
+
+//=============================================================================
+// BACKGROUND COMPACTION
+//=============================================================================
+
+/**
+ * @brief Reclaims tombstoned space, one coalesce or move per unit of work
+ */
+class PackCompactJob : public SliceJob {
+public:
+  bool step(SliceBudget& budget) override {
+    while (!budget.expired()) {
+      if (PhotoPack::compactStep()) return true;
+    }
+    return false;
+  }
+
+  void finish() override {
+    Serial.printf("[PACK] Compacted, %lu KB holes left\n",
+                  (unsigned long)(PhotoPack::holeBytes() >> 10));
+  }
+};
+
+// Static member initialization
+File PhotoPack::file;
+PackRegion* PhotoPack::regions = NULL;
+uint32_t PhotoPack::regionCount = 0;
+uint32_t PhotoPack::regionCapacity = 0;
+uint32_t PhotoPack::fileBytes = 0;
+uint32_t PhotoPack::liveCount = 0;
+uint32_t PhotoPack::liveBytes = 0;
+uint8_t PhotoPack::copyBuf[PackConfig::COPY_BYTES];
+
+#endif // PHOTO_PACK_H
@@ -0,0 +1,292 @@
+/**
+ * @file power_manager.h
+ * @brief Performance/power profiles, idle auto-switching and activity counters
+ *
+ * A profile sets CPU frequency, preview frame cadence, WiFi power save,
+ * LCD backlight and SPI clock, and whether the camera sensor may enter
+ * standby. The user selects a profile; after idle timeouts the manager
+ * steps down to lower-power profiles and restores the selection on the
+ * next user activity.
+ *
+ * Counters are printed periodically as one "[POWER] {json}" line so runs
+ * with different profiles can be captured and compared on the host.
+ */
+
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "LCD_Driver.h"
+
+//=============================================================================
+// PROFILES
+//=============================================================================
+
+enum class PowerProfile : uint8_t {
+  MAX_THROUGHPUT,   // Full speed preview, WiFi always awake
+  BALANCED,         // Reduced CPU clock and frame rate
+  BATTERY,          // Slow preview, modem sleep, sensor standby when idle
+  COUNT
+};
+
+/**
+ * @brief Hardware settings applied together for a profile
+ */
+struct PowerSettings {
+  const char*    name;
+  uint32_t       cpuMhz;           // 240 / 160 / 80
+  uint32_t       frameIntervalMs;  // Minimum time between preview frames
+  wifi_ps_type_t wifiPowerSave;    // WIFI_PS_NONE / MIN_MODEM / MAX_MODEM
+  uint8_t        backlight;        // LCD backlight 0-100
+  uint32_t       lcdSpiHz;         // LCD SPI clock
+  bool           sensorStandby;    // Put OV2640 in standby while idle
+};
+
+namespace PowerConfig {
+  constexpr PowerSettings PROFILES[(uint8_t)PowerProfile::COUNT] = {
+    { "max",      240,   0, WIFI_PS_NONE,      100, 80000000, false },
+    { "balanced", 160,  66, WIFI_PS_MIN_MODEM,  70, 40000000, false },
+    { "battery",   80, 250, WIFI_PS_MAX_MODEM,  30, 20000000, true  },
+  };
+
+  constexpr PowerProfile DEFAULT_PROFILE = PowerProfile::MAX_THROUGHPUT;
+
+  // Idle timeouts (no buttons / web actions)
+  constexpr uint32_t IDLE_TO_BALANCED_MS = 60000;   // 1 minute
+  constexpr uint32_t IDLE_TO_BATTERY_MS  = 300000;  // 5 minutes
+
+  constexpr uint32_t UPDATE_INTERVAL_MS  = 500;
+  constexpr uint32_t REPORT_INTERVAL_MS  = 10000;
+  constexpr uint32_t SENSOR_SETTLE_MS    = 50;      // Sensor wake to first capture
+}
+
+//=============================================================================
+// ACTIVITY COUNTERS
+//=============================================================================
+
+/**
+ * @brief Power-relevant work done since boot
+ */
+struct PowerCounters {
+  volatile uint32_t framesCaptured  = 0;
+  volatile uint32_t framesDisplayed = 0;
+  volatile uint32_t photosSaved     = 0;
+  volatile uint32_t sdBytesWritten  = 0;
+  volatile uint32_t sdBytesRead     = 0;
+  volatile uint32_t webRequests     = 0;
+  volatile uint32_t webBytesSent    = 0;
+  volatile uint32_t profileSwitches = 0;
+  volatile uint32_t sensorWakeups   = 0;
+  uint32_t timeInProfileMs[(uint8_t)PowerProfile::COUNT] = {0, 0, 0};
+  uint32_t sensorStandbyMs = 0;
+  uint64_t cpuMhzMs = 0;   // Integral of CPU clock over time (energy proxy)
+};
+
+//=============================================================================
+// POWER MANAGER
+//=============================================================================
+
+class PowerManager {
+public:
+  /**
+   * @brief Apply the default profile
+   */
+  static void begin() {
+    selected = PowerConfig::DEFAULT_PROFILE;
+    lastActivityMs = millis();
+    lastUpdateMs = millis();
+    lastReportMs = millis();
+    apply(selected);
+  }
+
+  /**
+   * @brief Select the user profile (applied on the next update)
+   */
+  static void select(PowerProfile profile) {
+    if (profile >= PowerProfile::COUNT) return;
+    selected = profile;
+    noteActivity();
+  }
+
+  /**
+   * @brief Parse a profile name ("max", "balanced", "battery")
+   * @return true if the name was recognised
+   */
+  static bool selectByName(const char* name) {
+    for (uint8_t i = 0; i < (uint8_t)PowerProfile::COUNT; i++) {
+      if (strcmp(name, PowerConfig::PROFILES[i].name) == 0) {
+        select((PowerProfile)i);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Record user activity (safe to call from an ISR)
+   */
+  static void IRAM_ATTR noteActivity() {
+    lastActivityMs = millis();
+  }
+
+  /**
+   * @brief Periodic housekeeping, called from loop()
+   *
+   * Accounts time per profile, steps down after idle timeouts, restores
+   * the selected profile on activity and emits the periodic report.
+   */
+  static void update() {
+    uint32_t now = millis();
+    if (now - lastUpdateMs < PowerConfig::UPDATE_INTERVAL_MS) return;
+
+    uint32_t elapsed = now - lastUpdateMs;
+    lastUpdateMs = now;
+    counters.timeInProfileMs[(uint8_t)active] += elapsed;
+    counters.cpuMhzMs += (uint64_t)settings().cpuMhz * elapsed;
+    if (sensorInStandby) counters.sensorStandbyMs += elapsed;
+
+    uint32_t idle = now - lastActivityMs;
+    PowerProfile target = selected;
+    if (idle >= PowerConfig::IDLE_TO_BATTERY_MS) {
+      target = PowerProfile::BATTERY;
+    } else if (idle >= PowerConfig::IDLE_TO_BALANCED_MS &&
+               selected == PowerProfile::MAX_THROUGHPUT) {
+      target = PowerProfile::BALANCED;
+    }
+    // Auto-switching only ever moves towards lower power than selected
+    if (target < selected) target = selected;
+    if (forced) target = forcedProfile;
+
+    if (target != active) {
+      Serial.printf("[POWER] %s -> %s (idle %lu ms)\n",
+                    settings().name, PowerConfig::PROFILES[(uint8_t)target].name,
+                    (unsigned long)idle);
+      apply(target);
+    }
+
+    if (now - lastReportMs >= PowerConfig::REPORT_INTERVAL_MS) {
+      lastReportMs = now;
+      Serial.print("[POWER] ");
+      printJson(Serial);
+      Serial.println();
+    }
+  }
+
+  /** @brief Settings of the profile currently in effect */
+  static const PowerSettings& settings() {
+    return PowerConfig::PROFILES[(uint8_t)active];
+  }
+
+  /**
+   * @brief Pin a profile regardless of selection and idle state
+   *
+   * Used by modes that manage their own power (time-lapse). Applied
+   * immediately; release() hands control back to the idle logic.
+   */
+  static void force(PowerProfile profile) {
+    if (profile >= PowerProfile::COUNT) return;
+    forced = true;
+    forcedProfile = profile;
+    apply(profile);
+  }
+
+  static void release() {
+    forced = false;
+    noteActivity();
+    apply(selected);
+  }
+
+  static PowerProfile activeProfile() { return active; }
+  static PowerProfile selectedProfile() { return selected; }
+
+  /**
+   * @brief true if the camera sensor should be in standby now
+   *
+   * Only in profiles that allow it and only once the battery idle timeout
+   * has passed; the camera task owns the SPI access that applies it.
+   */
+  static bool wantSensorStandby() {
+    return settings().sensorStandby &&
+           millis() - lastActivityMs >= PowerConfig::IDLE_TO_BATTERY_MS;
+  }
+
+  /** @brief Called by the camera task after changing the sensor state */
+  static void setSensorStandby(bool standby) {
+    if (sensorInStandby && !standby) counters.sensorWakeups++;
+    sensorInStandby = standby;
+  }
+
+  /**
+   * @brief Write the counters as a single JSON object
+   */
+  static void printJson(Print& out) {
+    out.printf("{\"uptime_ms\":%lu,\"selected\":\"%s\",\"active\":\"%s\",\"cpu_mhz\":%lu,",
+               (unsigned long)millis(),
+               PowerConfig::PROFILES[(uint8_t)selected].name, settings().name,
+               (unsigned long)settings().cpuMhz);
+    out.printf("\"frames_captured\":%lu,\"frames_displayed\":%lu,\"photos_saved\":%lu,",
+               (unsigned long)counters.framesCaptured,
+               (unsigned long)counters.framesDisplayed,
+               (unsigned long)counters.photosSaved);
+    out.printf("\"sd_bytes_written\":%lu,\"sd_bytes_read\":%lu,",
+               (unsigned long)counters.sdBytesWritten,
+               (unsigned long)counters.sdBytesRead);
+    out.printf("\"web_requests\":%lu,\"web_bytes_sent\":%lu,",
+               (unsigned long)counters.webRequests,
+               (unsigned long)counters.webBytesSent);
+    out.printf("\"profile_switches\":%lu,\"sensor_wakeups\":%lu,\"sensor_standby_ms\":%lu,",
+               (unsigned long)counters.profileSwitches,
+               (unsigned long)counters.sensorWakeups,
+               (unsigned long)counters.sensorStandbyMs);
+    out.printf("\"cpu_mhz_s\":%lu,\"time_in_profile_ms\":{",
+               (unsigned long)(counters.cpuMhzMs / 1000));
+    for (uint8_t i = 0; i < (uint8_t)PowerProfile::COUNT; i++) {
+      out.printf("%s\"%s\":%lu", i ? "," : "", PowerConfig::PROFILES[i].name,
+                 (unsigned long)counters.timeInProfileMs[i]);
+    }
+    out.print("}}");
+  }
+
+  static PowerCounters counters;
+
+private:
+  /**
+   * @brief Apply all hardware settings of a profile
+   */
+  static void apply(PowerProfile profile) {
+    const PowerSettings& s = PowerConfig::PROFILES[(uint8_t)profile];
+
+    setCpuFrequencyMhz(s.cpuMhz);
+    if (WiFi.status() == WL_CONNECTED) {
+      WiFi.setSleep(s.wifiPowerSave);
+    }
+    LCD_SetBacklight(s.backlight);
+    DEV_SPI_SetClock(s.lcdSpiHz);
+
+    if (profile != active) counters.profileSwitches++;
+    active = profile;
+  }
+
+  static PowerProfile selected;
+  static PowerProfile active;
+  static volatile uint32_t lastActivityMs;
+  static uint32_t lastUpdateMs;
+  static uint32_t lastReportMs;
+  static volatile bool sensorInStandby;
+  static bool forced;
+  static PowerProfile forcedProfile;
+};
+
+// Static member initialization
+PowerCounters PowerManager::counters;
+PowerProfile PowerManager::selected = PowerConfig::DEFAULT_PROFILE;
+PowerProfile PowerManager::active = PowerConfig::DEFAULT_PROFILE;
+volatile uint32_t PowerManager::lastActivityMs = 0;
+uint32_t PowerManager::lastUpdateMs = 0;
+uint32_t PowerManager::lastReportMs = 0;
+volatile bool PowerManager::sensorInStandby = false;
+bool PowerManager::forced = false;
+PowerProfile PowerManager::forcedProfile = PowerProfile::BATTERY;
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,229 @@
+/**
+ * @file sd_async.h
+ * @brief Queued SD writes that complete through callbacks
+ *
+ * File::write() returns only once every block is on the card, including
+ * the card's programming time after the last one, and the caller holds the
+ * SD card (and the SPI bus) for all of it. Here callers queue a request
+ * (file, buffer, length) and are told through a callback and/or a task
+ * notification when it has been written.
+ *
+ * AsyncWriteJob issues each chunk as a non-blocking write. While the card
+ * programs it, the job gives up the StorageGuard and the CPU, so the camera
+ * uses the bus and other tasks run instead of waiting in waitNotBusy().
+ *
+ * Requests are owned by the caller and must stay valid, with their
+ * buffers, until they complete. Requests complete in submission order.
+ * Callbacks run on the slice executor task with the StorageGuard held.
+ */
+
+#ifndef SD_ASYNC_H
+#define SD_ASYNC_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "slice_executor.h"
+
+//=============================================================================
+// ASYNC WRITE CONFIGURATION
+//=============================================================================
+namespace AsyncWriteConfig {
+  constexpr uint8_t  QUEUE_DEPTH = 64;     // Requests waiting for the writer
+  constexpr uint32_t CHUNK_BYTES = 8192;   // Bytes per non-blocking write (one multi-block run)
+}
+
+//=============================================================================
+// WRITE REQUEST
+//=============================================================================
+
+struct AsyncWriteRequest;
+
+/** Runs before the first chunk, e.g. to open the file; false fails the request */
+typedef bool (*AsyncWriteStart)(AsyncWriteRequest& req);
+/** Runs once the request is written (and closed, if asked) or has failed */
+typedef void (*AsyncWriteDone)(AsyncWriteRequest& req, bool ok);
+
+/**
+ * @brief One queued write
+ *
+ * onStart may complete the write itself by setting written = length, in
+ * which case no chunk is issued.
+ */
+struct AsyncWriteRequest {
+  File file;                        // Open for writing, or opened by onStart
+  const uint8_t* data = NULL;       // Source; valid until completion
+  uint32_t length = 0;              // Bytes to write
+  uint32_t written = 0;             // Progress, kept by the writer
+  bool closeWhenDone = true;        // Close (and sync) the file after the last chunk
+  AsyncWriteStart onStart = NULL;   // Optional
+  AsyncWriteDone onDone = NULL;     // Optional
+  TaskHandle_t notify = NULL;       // Optional task given a notification on completion
+  void* context = NULL;             // Caller data for the callbacks
+  uint32_t number = 0;              // Caller tag (e.g. photo number)
+  uint32_t startUs = 0;             // Set when the writer takes the request
+  volatile bool pending = false;    // true from submit() until completion
+};
+
+//=============================================================================
+// WRITER JOB
+//=============================================================================
+
+/**
+ * @brief Drains the async write queue, one chunk at a time
+ *
+ * availableForWrite() puts the file in non-blocking mode (or starts a
+ * non-blocking flush of its FAT and directory blocks). Each chunk then
+ * returns as soon as its data is sent, and the job yields its slice for
+ * as long as SD.isBusy() reports the card programming.
+ */
+class AsyncWriteJob : public SliceJob {
+public:
+  bool step(SliceBudget& budget) override;
+  bool hasWork() const override;
+
+  volatile uint32_t completed = 0;
+  volatile uint32_t failed = 0;
+  volatile uint32_t busyYields = 0;    // Slices given up while the card programmed
+  volatile uint32_t bytes = 0;
+
+private:
+  void complete(bool ok);
+
+  AsyncWriteRequest* current = NULL;
+};
+
+//=============================================================================
+// WRITER
+//=============================================================================
+
+class AsyncWriter {
+public:
+  /**
+   * @brief Create the request queue (after SliceExecutor::begin)
+   * @return true if the queue exists
+   */
+  static bool begin() {
+    if (queue != NULL) return true;
+    queue = xQueueCreate(AsyncWriteConfig::QUEUE_DEPTH, sizeof(AsyncWriteRequest*));
+    if (queue == NULL) {
+      Serial.println("[ASYNC] Failed to create write queue");
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Queue a write
+   *
+   * Does not need the StorageGuard. req must not be pending already.
+   *
+   * @return false if the queue is full or the writer is not running
+   */
+  static bool submit(AsyncWriteRequest* req) {
+    if (queue == NULL || req == NULL || req->pending) return false;
+    req->pending = true;
+    req->written = 0;
+    if (xQueueSend(queue, &req, 0) != pdTRUE) {
+      req->pending = false;
+      return false;
+    }
+    kick();
+    return true;
+  }
+
+  /**
+   * @brief Make sure the writer job is queued
+   *
+   * A request submitted while the job is finishing its last step is picked
+   * up through hasWork(), so no kick is lost.
+   */
+  static void kick() { SliceExecutor::submit(&job); }
+
+  static uint32_t queued() { return queue != NULL ? uxQueueMessagesWaiting(queue) : 0; }
+  static uint32_t completedCount() { return job.completed; }
+  static uint32_t failedCount() { return job.failed; }
+  static uint32_t busyYieldCount() { return job.busyYields; }
+  static uint32_t bytesWritten() { return job.bytes; }
+
+private:
+  friend class AsyncWriteJob;
+
+  static QueueHandle_t queue;
+  static AsyncWriteJob job;
+};
+
+//=============================================================================
+// WRITER JOB IMPLEMENTATION
+//=============================================================================
+
+inline bool AsyncWriteJob::step(SliceBudget& budget) {
+  while (!budget.expired()) {
+    if (current == NULL) {
+      if (xQueueReceive(AsyncWriter::queue, &current, 0) != pdTRUE) return true;
+      current->startUs = micros();
+      if (current->onStart != NULL && !current->onStart(*current)) {
+        complete(false);
+        continue;
+      }
+    }
+
+    if (current->written < current->length) {
+      // Card still programming the previous chunk: free the bus until done
+      if (SD.isBusy()) {
+        busyYields++;
+        return false;
+      }
+      if (!current->file) {
+        complete(false);
+        continue;
+      }
+      // Returns 0 (card now busy) when it started a metadata flush instead
+      if (current->file.availableForWrite() == 0 && SD.isBusy()) {
+        busyYields++;
+        return false;
+      }
+
+      uint32_t n = current->length - current->written;
+      if (n > AsyncWriteConfig::CHUNK_BYTES) n = AsyncWriteConfig::CHUNK_BYTES;
+      if (current->file.write(current->data + current->written, n) != n) {
+        complete(false);
+        continue;
+      }
+      current->written += n;
+      bytes += n;
+      continue;
+    }
+
+    if (current->closeWhenDone && current->file) current->file.close();
+    complete(true);
+  }
+  return false;
+}
+
+inline bool AsyncWriteJob::hasWork() const {
+  return AsyncWriter::queued() != 0;
+}
+
+inline void AsyncWriteJob::complete(bool ok) {
+  AsyncWriteRequest* req = current;
+  current = NULL;
+
+  if (ok) {
+    completed++;
+  } else {
+    failed++;
+    if (req->closeWhenDone && req->file) req->file.close();
+  }
+
+  // The owner may reuse req once onDone has released what it refers to
+  TaskHandle_t notify = req->notify;
+  req->pending = false;
+  if (req->onDone != NULL) req->onDone(*req, ok);
+  if (notify != NULL) xTaskNotifyGive(notify);
+}
+
+// Static member initialization
+QueueHandle_t AsyncWriter::queue = NULL;
+AsyncWriteJob AsyncWriter::job;
+
+#endif // SD_ASYNC_H
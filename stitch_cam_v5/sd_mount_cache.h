@@ -0,0 +1,143 @@
+/**
+ * @file sd_mount_cache.h
+ * @brief Fast SD mount from a snapshot of the card's volume kept in NVS
+ *
+ * A full mount reads the MBR, the boot sector and on FAT32 the FSINFO
+ * sector, and asks the card for its allocation unit. On FAT16 the free
+ * space then stays unknown until the background FAT scan completes. None
+ * of this changes between boots unless the card does, so it is saved:
+ *
+ *   card     CID fingerprint (SD.cardHash())
+ *   volume   start block, serial number, cluster count, FSINFO block
+ *   space    free cluster count and allocation hint
+ *   AU       card allocation unit
+ *
+ * At boot SD.beginFast() checks the CID and the boot sector against the
+ * snapshot and, when they match, reads nothing else; otherwise it mounts
+ * in full. selectSdClock() resumes the clock saved for the card instead of
+ * ramping, and the photo index comes from the catalog's own on-card
+ * snapshot (photo_catalog.h), so no directory is scanned either.
+ *
+ * MountSnapshotJob refreshes the snapshot while the card is idle, writing
+ * NVS only when it changed. A stale snapshot is harmless: the free count
+ * is a hint that the FAT scan corrects, and a reformatted card has another
+ * serial number.
+ */
+
+#ifndef SD_MOUNT_CACHE_H
+#define SD_MOUNT_CACHE_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <Preferences.h>
+#include "slice_executor.h"
+
+//=============================================================================
+// MOUNT CACHE CONFIGURATION
+//=============================================================================
+namespace MountCacheConfig {
+  const char* const  NVS_NAMESPACE  = "sdmount";
+  const char* const  NVS_KEY        = "snap";
+  constexpr uint32_t MAGIC          = 0x544E4D46;  // "FMNT"
+  constexpr uint32_t SAVE_PERIOD_MS = 30000;       // Snapshot refresh check while idle
+}
+
+//=============================================================================
+// SNAPSHOT JOB
+//=============================================================================
+
+/**
+ * @brief Saves SD.mountState() to NVS if it differs from the saved one
+ */
+class MountSnapshotJob : public SliceJob {
+public:
+  bool step(SliceBudget& budget) override;
+
+  volatile uint32_t saves = 0;
+};
+
+//=============================================================================
+// MOUNT CACHE
+//=============================================================================
+
+class MountCache {
+public:
+  /**
+   * @brief Mount the SD card, from the saved snapshot if it still matches
+   *
+   * Caller holds the StorageGuard.
+   *
+   * @return false if the card could not be mounted at all
+   */
+  static bool mount(uint8_t csPin) {
+    Snapshot snap;
+    uint32_t start = micros();
+    bool ok = load(snap) ? SD.beginFast(snap.mount, csPin) : SD.begin(csPin);
+    mountUs = micros() - start;
+    if (ok && SD.mountedFast()) saved = snap;
+    return ok;
+  }
+
+  /** @brief Time the last mount() took, in microseconds */
+  static uint32_t lastMountUs() { return mountUs; }
+
+  /** @brief Queue a snapshot refresh (loop(), while the card is idle) */
+  static void refresh() { SliceExecutor::submit(&job); }
+
+  static uint32_t saveCount() { return job.saves; }
+
+private:
+  friend class MountSnapshotJob;
+
+  struct Snapshot {
+    uint32_t     magic;
+    SDMountState mount;
+  };
+
+  static bool load(Snapshot& snap) {
+    Preferences prefs;
+    if (!prefs.begin(MountCacheConfig::NVS_NAMESPACE, true)) return false;
+    bool ok = prefs.getBytes(MountCacheConfig::NVS_KEY, &snap, sizeof(snap)) == sizeof(snap) &&
+              snap.magic == MountCacheConfig::MAGIC;
+    prefs.end();
+    return ok;
+  }
+
+  /** @brief Write snap unless NVS already holds it */
+  static bool store(const Snapshot& snap) {
+    if (memcmp(&snap, &saved, sizeof(snap)) == 0) return false;
+    Preferences prefs;
+    if (!prefs.begin(MountCacheConfig::NVS_NAMESPACE, false)) return false;
+    bool ok = prefs.putBytes(MountCacheConfig::NVS_KEY, &snap, sizeof(snap)) == sizeof(snap);
+    prefs.end();
+    if (ok) saved = snap;
+    return ok;
+  }
+
+  static Snapshot saved;
+  static uint32_t mountUs;
+  static MountSnapshotJob job;
+};
+
+//=============================================================================
+// SNAPSHOT JOB IMPLEMENTATION
+//=============================================================================
+
+inline bool MountSnapshotJob::step(SliceBudget&) {
+  MountCache::Snapshot snap;
+  memset(&snap, 0, sizeof(snap));
+  snap.magic = MountCacheConfig::MAGIC;
+  if (SD.mountState(snap.mount) && MountCache::store(snap)) {
+    saves++;
+    Serial.printf("[MOUNT] Snapshot saved, %lu free clusters\n",
+                  (unsigned long)snap.mount.volume.freeClusters);
+  }
+  return true;
+}
+
+// Static member initialization
+MountCache::Snapshot MountCache::saved = {};
+uint32_t MountCache::mountUs = 0;
+MountSnapshotJob MountCache::job;
+
+#endif // SD_MOUNT_CACHE_H
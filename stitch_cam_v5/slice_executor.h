@@ -0,0 +1,273 @@
+/**
+ * @file slice_executor.h
+ * @brief Cooperative time-sliced execution for long storage/network work
+ *
+ * Directory scans, gallery loads and photo downloads can hold the CPU and
+ * the SD card for hundreds of milliseconds. Work is split into resumable
+ * steps that give up the CPU (and the SD card) once their time budget is
+ * spent, so the camera task and the idle task watchdog are never starved.
+ *
+ * - SliceBudget:   time budget for inline loops (yield when expired)
+ * - SliceJob:      resumable background job, one bounded step at a time
+ * - SliceExecutor: low-priority task that runs queued jobs
+ * - StorageGuard:  scoped ownership of the SD card
+ */
+
+#ifndef SLICE_EXECUTOR_H
+#define SLICE_EXECUTOR_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "task_profiler.h"
+
+//=============================================================================
+// SLICING CONFIGURATION
+//=============================================================================
+namespace SliceConfig {
+  constexpr uint32_t BUDGET_US   = 4000;  // Max run time of one slice (4ms)
+  constexpr uint32_t CHUNK_BYTES = 2048;  // I/O chunk size for sliced transfers
+  constexpr uint32_t DIRECT_CHUNK_BYTES = 8192;  // Reads straight into a caller buffer
+  constexpr uint8_t  QUEUE_DEPTH = 4;     // Pending background jobs
+  constexpr uint16_t FAT_SCAN_BLOCKS = 2; // FAT blocks per free-bitmap call
+}
+
+//=============================================================================
+// STORAGE LOCK
+//=============================================================================
+
+/**
+ * @brief Scoped ownership of the SD card
+ *
+ * The SD library is not thread safe; every task touching the card holds
+ * this guard. Sliced loops release it while yielding (see SliceBudget).
+ */
+class StorageGuard {
+public:
+  StorageGuard() { lock(); }
+  ~StorageGuard() { unlock(); }
+
+  static void init() {
+    if (mutex == NULL) {
+      mutex = xSemaphoreCreateMutex();
+    }
+  }
+
+  static void lock() {
+    if (mutex != NULL) xSemaphoreTake(mutex, portMAX_DELAY);
+  }
+
+  static void unlock() {
+    if (mutex != NULL) xSemaphoreGive(mutex);
+  }
+
+private:
+  StorageGuard(const StorageGuard&);
+  StorageGuard& operator=(const StorageGuard&);
+
+  static SemaphoreHandle_t mutex;
+};
+
+//=============================================================================
+// TIME BUDGET
+//=============================================================================
+
+/**
+ * @brief Time budget for one slice of a long operation
+ *
+ * Loops call yieldIfExpired() once per unit of work. When the budget is
+ * used up the caller sleeps for one tick, letting equal and lower priority
+ * tasks run, then starts a fresh slice.
+ */
+class SliceBudget {
+public:
+  /**
+   * @param holdsStorage true if the caller holds a StorageGuard that
+   *                     should be released while yielding
+   * @param budgetUs     Slice length in microseconds
+   */
+  explicit SliceBudget(bool holdsStorage = false,
+                       uint32_t budgetUs = SliceConfig::BUDGET_US)
+    : budgetUs(budgetUs), holdsStorage(holdsStorage), start(micros()) {}
+
+  bool expired() const {
+    return (uint32_t)(micros() - start) >= budgetUs;
+  }
+
+  /** @brief Start a new slice without yielding */
+  void restart() { start = micros(); }
+
+  /**
+   * @brief Yield if the slice has used its budget
+   * @return true if the caller yielded
+   */
+  bool yieldIfExpired() {
+    if (!expired()) return false;
+    yieldNow();
+    return true;
+  }
+
+  /** @brief Yield unconditionally and start a new slice */
+  void yieldNow() {
+    noteSlice((uint32_t)(micros() - start));
+    if (holdsStorage) StorageGuard::unlock();
+    vTaskDelay(1);
+    if (holdsStorage) StorageGuard::lock();
+    restart();
+  }
+
+  /** @brief Longest slice observed since boot (microseconds) */
+  static uint32_t longestSliceUs() { return maxSliceUs; }
+
+private:
+  static void noteSlice(uint32_t us) {
+    if (us > maxSliceUs) maxSliceUs = us;
+  }
+
+  uint32_t budgetUs;
+  bool holdsStorage;
+  uint32_t start;
+
+  static volatile uint32_t maxSliceUs;
+};
+
+//=============================================================================
+// BACKGROUND JOBS
+//=============================================================================
+
+/**
+ * @brief Resumable unit of background work
+ *
+ * step() does as much work as fits in the budget and returns true once the
+ * job is complete. It runs with the SD card locked; the lock is dropped
+ * between steps. finish() is called once, after the final step.
+ *
+ * A submit() that lands between the final step and the end of finish()
+ * is ignored because the job still reads as pending. Jobs fed from a
+ * queue override hasWork() so the executor runs them again.
+ */
+class SliceJob {
+public:
+  virtual ~SliceJob() {}
+  virtual bool step(SliceBudget& budget) = 0;
+  virtual void finish() {}
+
+  /** @brief true if work arrived after the final step (checked once pending is cleared) */
+  virtual bool hasWork() const { return false; }
+
+  /** @brief true while queued or running (jobs are not queued twice) */
+  volatile bool pending = false;
+};
+
+/**
+ * @brief Builds the SD free-cluster bitmap in the background
+ *
+ * Until it completes, allocation falls back to FAT scans and the free
+ * space reported is the FSINFO hint (if any).
+ */
+class FreeBitmapJob : public SliceJob {
+public:
+  bool step(SliceBudget& budget) override {
+    while (!budget.expired()) {
+      if (SD.buildFreeBitmap(SliceConfig::FAT_SCAN_BLOCKS) != 0) return true;
+    }
+    return false;
+  }
+};
+
+/**
+ * @brief Writes the directory entries and FAT blocks that SD_SYNC_DEFERRED
+ *        leaves in the block cache
+ */
+class SdSyncJob : public SliceJob {
+public:
+  bool step(SliceBudget&) override {
+    if (!SD.sync()) failures++;
+    return true;
+  }
+
+  volatile uint32_t failures = 0;
+};
+
+//=============================================================================
+// EXECUTOR
+//=============================================================================
+
+/**
+ * @brief Low-priority task that runs SliceJobs one slice at a time
+ */
+class SliceExecutor {
+public:
+  /**
+   * @brief Create the executor task
+   * @return true if the task and its queue were created
+   */
+  static bool begin(uint32_t stackSize, UBaseType_t priority, BaseType_t core) {
+    StorageGuard::init();
+    if (queue != NULL) return true;
+
+    queue = xQueueCreate(SliceConfig::QUEUE_DEPTH, sizeof(SliceJob*));
+    if (queue == NULL) {
+      Serial.println("[SLICE] Failed to create job queue");
+      return false;
+    }
+
+    if (xTaskCreatePinnedToCore(taskLoop, "SliceTask", stackSize, NULL,
+                                priority, &taskHandle, core) != pdPASS) {
+      Serial.println("[SLICE] Failed to create executor task");
+      return false;
+    }
+    Serial.println("[SLICE] Executor started");
+    return true;
+  }
+
+  /**
+   * @brief Queue a job; ignored if it is already pending
+   * @return true if the job is (or already was) queued
+   */
+  static bool submit(SliceJob* job) {
+    if (queue == NULL || job == NULL) return false;
+    if (job->pending) return true;
+    job->pending = true;
+    if (xQueueSend(queue, &job, 0) != pdTRUE) {
+      job->pending = false;
+      return false;
+    }
+    return true;
+  }
+
+  static TaskHandle_t handle() { return taskHandle; }
+
+private:
+  static void taskLoop(void* parameter) {
+    SliceJob* job;
+    for (;;) {
+      if (xQueueReceive(queue, &job, portMAX_DELAY) != pdTRUE) continue;
+
+      SliceBudget budget;
+      bool done = false;
+      while (!done) {
+        StorageGuard::lock();
+        budget.restart();
+        uint32_t stepStart = micros();
+        done = job->step(budget);
+        TaskProfiler::addBusy(ProfiledTask::STORAGE, micros() - stepStart);
+        StorageGuard::unlock();
+        if (!done) budget.yieldNow();
+      }
+      job->finish();
+      job->pending = false;
+      if (job->hasWork()) submit(job);
+    }
+  }
+
+  static QueueHandle_t queue;
+  static TaskHandle_t taskHandle;
+};
+
+// Static member initialization
+SemaphoreHandle_t StorageGuard::mutex = NULL;
+volatile uint32_t SliceBudget::maxSliceUs = 0;
+QueueHandle_t SliceExecutor::queue = NULL;
+TaskHandle_t SliceExecutor::taskHandle = NULL;
+
+#endif // SLICE_EXECUTOR_H
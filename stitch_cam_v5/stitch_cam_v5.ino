@@ -64,6 +64,8 @@
  *     https://randomnerdtutorials.com/esp32-websocket-server-arduino/
  *
  * NOTES:
+ * - Needs the SD library in ../libraries, not the one bundled with the
+ *   esp32 core: arduino-cli compile --libraries libraries stitch_cam_v5
  * - Enable PSRAM (OTI PSRAM) before uploading for stable JPEG handling.
  * - On some ESP32-S3 boards, USB CDC on boot must be disabled to avoid
  *   serial monitor conflicts.
@@ -73,12 +75,21 @@
 // Libraries
 #include <WiFi.h>
 #include <WebServer.h>
+#include <StreamString.h>
 #include <Wire.h>
 #include <SPI.h>
 #include <SD.h>
+#include <Preferences.h>
 #include <ArduCAM.h>
 #include "memorysaver.h"
 
+// The esp32 core's own SD library lacks preAllocate(), openEntry() and the
+// sync policies; build with --libraries pointing at ../libraries so the
+// copy there is used (see libraries/SD/docs/readme.md).
+#ifndef SD_PATH_CACHE_SIZE
+  #error "SD.h is not the library in ../libraries"
+#endif
+
 // Avoid conflicts with existing swap definitions
 #ifdef swap
   #undef swap
@@ -94,6 +105,37 @@
 #include "index_html_gz.h"
 #include "gallery_html_gz.h"
 
+// Set to 1 to run the task profiling workload at boot (see task_profiler.h)
+#define TASK_PROFILING 0
+#include "task_profiler.h"
+#include "task_profile.h"
+
+// Cooperative slicing for long storage/network operations
+#include "slice_executor.h"
+
+// Queued SD writes with completion callbacks
+#include "sd_async.h"
+
+// Fast SD mount from a saved volume snapshot
+#include "sd_mount_cache.h"
+
+// Performance/power profiles
+#include "power_manager.h"
+
+// Burst capture into PSRAM
+#include "burst_capture.h"
+
+// Time-lapse scheduling
+#include "timelapse.h"
+
+// Photo directory index, catalog and packed container
+#include "photo_catalog.h"
+#include "photo_pack.h"
+#include "photo_index.h"
+
+// Thumbnails made at save time
+#include "thumbnail.h"
+
 // CONFIGURATION
 
 /**
@@ -141,8 +183,59 @@ namespace Config {
   constexpr uint16_t FRAME_HEIGHT  = 240;    // Camera frame height
   constexpr uint32_t FRAME_BYTES   = FRAME_WIDTH * FRAME_HEIGHT * 2; ///< RGB565
   constexpr uint32_t DEBOUNCE_MS   = 200;    // Button debounce time in ms
+  
+  // SD durability: SD_SYNC_WRITE, SD_SYNC_CLOSE or SD_SYNC_DEFERRED
+  constexpr uint8_t  SYNC_POLICY    = SD_SYNC_CLOSE;
+  constexpr uint32_t SYNC_PERIOD_MS = 2000;  // Deferred metadata and FSINFO flush period
+  
+  // SD SPI clock ceiling for SD.rampClock(); 40 MHz is the most the
+  // GPIO-matrix SPI pins manage, the card's own limit applies below it
+  constexpr uint32_t SD_CLOCK_LIMIT = 40000000;
+}
+
+static_assert(BurstConfig::SLOT_BYTES >= Config::MAX_JPEG_SIZE,
+              "Burst ring slots must hold a full-size JPEG");
+
+/**
+ * @brief FreeRTOS task layout
+ *
+ * The slice executor runs below everything else so background storage work
+ * only uses time the camera and web tasks leave idle.
+ */
+namespace TaskConfig {
+  // Stack sizes (bytes) - check against task_profile.h after changes
+  constexpr uint32_t CAMERA_STACK_SIZE  = 8192;
+  constexpr uint32_t WEB_STACK_SIZE     = 8192;  // Arduino loopTask
+  constexpr uint32_t STORAGE_STACK_SIZE = 8192;  // Thumbnail encoding (fmt2jpg)
+
+  // Priorities (0 = lowest, configMAX_PRIORITIES-1 = highest)
+  constexpr UBaseType_t CAMERA_PRIORITY  = 1;
+  constexpr UBaseType_t STORAGE_PRIORITY = tskIDLE_PRIORITY;
+
+  // Core assignment
+  constexpr BaseType_t CAMERA_CORE  = 0;  // Camera + LCD on Core 0
+  constexpr BaseType_t STORAGE_CORE = 1;  // Background jobs next to the web server
 }
 
+// Refuse to build with stacks smaller than the profiled peaks. An unmeasured
+// peak (0) passes; the profiling build reminds that its report is needed.
+#if TASK_PROFILING && !TASK_PROFILE_MEASURED
+#pragma message("task_profile.h holds no measured stack peaks: copy this run's [PROFILE] report into it")
+#endif
+static_assert(ProfileConfig::stackFits(TaskConfig::CAMERA_STACK_SIZE,
+                                       TaskProfile::CAMERA_STACK_PEAK),
+              "CAMERA_STACK_SIZE is below the measured peak in task_profile.h");
+static_assert(ProfileConfig::stackFits(TaskConfig::WEB_STACK_SIZE,
+                                       TaskProfile::WEB_STACK_PEAK),
+              "WEB_STACK_SIZE is below the measured peak in task_profile.h");
+static_assert(ProfileConfig::stackFits(TaskConfig::STORAGE_STACK_SIZE,
+                                       TaskProfile::STORAGE_STACK_PEAK),
+              "STORAGE_STACK_SIZE is below the measured peak in task_profile.h");
+
+#ifdef SET_LOOP_TASK_STACK_SIZE
+SET_LOOP_TASK_STACK_SIZE(TaskConfig::WEB_STACK_SIZE);
+#endif
+
 // GLOBAL VARIABLES
 
 /**
@@ -164,7 +257,9 @@ enum class AppMode {
 
 enum class CaptureMode {
   INSTANT,    // Immediate photo capture
-  COUNTDOWN   // 3-second countdown before capture
+  COUNTDOWN,  // 3-second countdown before capture
+  BURST,      // Back-to-back frames into PSRAM, saved in background
+  TIMELAPSE   // Interval capture with low-power sleep between shots
 };
 
 /**
@@ -174,8 +269,10 @@ struct AppState {
   AppMode currentMode = AppMode::CAMERA;
   CaptureMode captureMode = CaptureMode::INSTANT;
   bool sdCardAvailable = false;
+  uint32_t sdReadyUs = 0;       // initSDCard() time, mount to photos counted
   uint32_t photoCounter = 1;
   uint32_t totalPhotos = 0;
+  uint32_t lastPhotoNumber = 0; // Highest number handed out (see nextPhotoNumber())
   int currentGalleryIndex = 0;
   String lastStatus = "Idle";
   
@@ -188,6 +285,16 @@ struct AppState {
   // Web interface triggers
   volatile bool webCaptureRequested = false;
   volatile bool webCountdownRequested = false;
+  volatile uint16_t webBurstRequested = 0;  // Frames requested via web (0 = none)
+  volatile bool webTimelapseStart = false;
+  volatile bool webTimelapseStop = false;
+  volatile uint32_t webTimelapseInterval = 0;
+  volatile uint32_t webTimelapseCount = 0;
+  
+  // Burst progress (burstTotal = 0 when no burst is running)
+  volatile uint16_t burstShot = 0;
+  volatile uint16_t burstTotal = 0;
+  BurstStats lastBurst;
   
   // Photo saving flag (prevents camera task from capturing while saving)
   volatile bool isSaving = false;
@@ -200,6 +307,39 @@ ArduCAM camera(OV2640, Pin::CAM_CS);
 WebServer webServer(80);
 TaskHandle_t cameraTaskHandle = NULL;
 
+/**
+ * @brief Current time-lapse session and its output file
+ */
+TimelapseSession timelapse;
+File timelapseFile;
+
+/**
+ * @brief Background build of the SD free-cluster bitmap (after mount)
+ */
+FreeBitmapJob freeBitmapJob;
+
+/**
+ * @brief Periodic metadata flush for SD_SYNC_DEFERRED
+ */
+SdSyncJob sdSyncJob;
+
+/**
+ * @brief SD metadata writes since the sync policy was last selected
+ * 
+ * Counter values are the library totals when the policy was selected, so
+ * /sync reports writes per saved photo under the current policy.
+ */
+struct SyncAccounting {
+  uint32_t photos = 0;          // Photos saved under the policy
+  uint32_t fatWrites = 0;
+  uint32_t mirrorWrites = 0;
+  uint32_t dirWrites = 0;
+  uint32_t entryUpdates = 0;
+  uint32_t syncs = 0;
+  uint32_t deferredSyncs = 0;
+};
+SyncAccounting syncAccounting;
+
 // FUNCTION DECLARATIONS
 
 // Hardware initialization
@@ -217,6 +357,16 @@ void showMessage(const char* message, uint16_t color = WHITE);
 
 // Camera operations
 bool captureJpegToBuffer();
+bool captureJpeg(uint8_t* dest, uint32_t maxLen, uint32_t& outLen);
+void runBurst(uint16_t frames);
+bool isSensorStandby();
+void setSensorStandby(bool standby);
+void wakeSensorForCapture();
+
+// Time-lapse
+void startTimelapse(uint32_t intervalMs, uint32_t count);
+void stopTimelapse();
+void serviceTimelapse();
 bool decodeJpegToRGB565();
 void streamFrameToLCD(const uint8_t* frameData);
 void handleCaptureInstant();
@@ -228,8 +378,25 @@ void deleteCurrentPhoto();
 
 // Photo management
 bool savePhoto();
+bool writePhotoFile(const uint8_t* data, uint32_t length,
+                    const uint8_t* thumb = NULL, size_t thumbLen = 0);
+bool writePhotoPacked(const uint8_t* data, uint32_t length,
+                      const uint8_t* thumb = NULL, size_t thumbLen = 0);
+File openPhotoFile(uint32_t number, uint32_t length);
+bool closePhotoFile(File& file, uint32_t number, uint32_t written, uint32_t length,
+                    const uint8_t* thumb = NULL, size_t thumbLen = 0);
+bool selectSyncPolicy(uint8_t policy);
+void selectSdClock();
+bool startBurstPhoto(AsyncWriteRequest& req);
+void finishBurstPhoto(AsyncWriteRequest& req, bool ok);
+size_t readPackedSliced(uint32_t number, uint8_t* dest, size_t length);
 String getPhotoPath(int index);
+uint32_t photoNumberAt(int index);
+uint32_t nextPhotoNumber();
 int countPhotosInSD();
+void onPhotoScanDone(int count);
+size_t readFileSliced(File& file, uint32_t number, uint8_t* dest, size_t length);
+void logReadRate(const char* tag, uint32_t bytes, uint32_t us);
 
 // LED control
 void setLED(bool red, bool green, bool blue);
@@ -241,6 +408,7 @@ void IRAM_ATTR button2ISR();
 
 // RTOS tasks
 void cameraTask(void* parameter);
+void profilerTask(void* parameter);
 
 // Web handlers
 void handleRoot();
@@ -252,7 +420,12 @@ void handleStatus();
 void handleStream();
 void handlePhotoList();
 void handlePhoto();
+void handleThumb();
 void handleDeletePhoto();
+void handlePower();
+void handleBurst();
+void handleTimelapse();
+void handleSync();
 
 // JPEG decoder callback
 bool tjpgOutputCallback(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bitmap);
@@ -296,9 +469,23 @@ void setup() {
   SPI.begin(Pin::SPI_SCK, Pin::SPI_MISO, Pin::SPI_MOSI);
   Serial.println("[INIT] Communication buses initialized");
   
+  // Start background executor (also creates the SD card lock)
+  SliceExecutor::begin(TaskConfig::STORAGE_STACK_SIZE,
+                       TaskConfig::STORAGE_PRIORITY,
+                       TaskConfig::STORAGE_CORE);
+  AsyncWriter::begin();
+  
   // Initialize SD card
   initSDCard();
   
+  // Reserve PSRAM frame ring for burst mode
+  BurstRing::begin();
+  
+  // Free-cluster bitmap goes to PSRAM after the ring has taken its share
+  if (state.sdCardAvailable) {
+    SliceExecutor::submit(&freeBitmapJob);
+  }
+  
   // Initialize camera
   initCamera();
   
@@ -323,6 +510,11 @@ void setup() {
   // Connect to WiFi (non-blocking, continues even if fails)
   initWiFi();
   
+  // Apply default power profile (CPU clock, WiFi power save, LCD)
+  PowerManager::begin();
+  Serial.print("[INIT] Power profile: ");
+  Serial.println(PowerManager::settings().name);
+  
   // Setup web server routes (only if WiFi connected)
   if (WiFi.status() == WL_CONNECTED) {
     Serial.println("[INFO] Setting up web server...");
@@ -335,7 +527,12 @@ void setup() {
     webServer.on("/stream", handleStream);
     webServer.on("/photos", handlePhotoList);
     webServer.on("/photo", handlePhoto);
+    webServer.on("/thumb", handleThumb);
     webServer.on("/delete", handleDeletePhoto);
+    webServer.on("/power", handlePower);
+    webServer.on("/burst", handleBurst);
+    webServer.on("/timelapse", handleTimelapse);
+    webServer.on("/sync", handleSync);
     webServer.begin();
     Serial.println("[INIT] Web server started");
     
@@ -417,13 +614,25 @@ void setup() {
   xTaskCreatePinnedToCore(
     cameraTask,           // Task function
     "CameraTask",         // Task name
-    8192,                 // Stack size
-    NULL,                 // Parameters
-    1,                    // Priority
-    &cameraTaskHandle,    // Task handle
-    0                     // Core 0
+    TaskConfig::CAMERA_STACK_SIZE,  // Stack size
+    NULL,                           // Parameters
+    TaskConfig::CAMERA_PRIORITY,    // Priority
+    &cameraTaskHandle,              // Task handle
+    TaskConfig::CAMERA_CORE         // Core 0
   );
   
+  if (ProfileConfig::ENABLED) {
+    TaskProfiler::registerTask(ProfiledTask::CAMERA, "CAMERA", cameraTaskHandle,
+                               TaskConfig::CAMERA_STACK_SIZE);
+    TaskProfiler::registerTask(ProfiledTask::WEB, "WEB", xTaskGetCurrentTaskHandle(),
+                               TaskConfig::WEB_STACK_SIZE);
+    TaskProfiler::registerTask(ProfiledTask::STORAGE, "STORAGE", SliceExecutor::handle(),
+                               TaskConfig::STORAGE_STACK_SIZE);
+    xTaskCreatePinnedToCore(profilerTask, "ProfilerTask", ProfileConfig::STACK_SIZE,
+                            NULL, TaskConfig::STORAGE_PRIORITY + 1, NULL,
+                            TaskConfig::STORAGE_CORE);
+  }
+  
   Serial.println("[OK] System ready!\n");
   
   if (WiFi.status() == WL_CONNECTED) {
@@ -451,7 +660,39 @@ void setup() {
 void loop() {
   // Only process web requests if WiFi is connected
   if (WiFi.status() == WL_CONNECTED) {
+    uint32_t workStart = micros();
     webServer.handleClient();
+    TaskProfiler::addBusy(ProfiledTask::WEB, micros() - workStart);
+  }
+  PowerManager::update();
+  
+  // Deferred sync policy: flush held-back metadata on a timer. The FSINFO
+  // free count hint is written from here too, under every policy, rather
+  // than on each close. Both checks only read flags, so they run without
+  // the StorageGuard.
+  static uint32_t lastSyncMs = 0;
+  if (state.sdCardAvailable && millis() - lastSyncMs >= Config::SYNC_PERIOD_MS) {
+    lastSyncMs = millis();
+    if ((SD.syncPolicy() == SD_SYNC_DEFERRED && SD.syncPending()) || SD.fsInfoPending()) {
+      SliceExecutor::submit(&sdSyncJob);
+    }
+  }
+  
+  // Keep the fast-mount snapshot current while the card is idle
+  static uint32_t lastSnapshotMs = 0;
+  if (state.sdCardAvailable && !state.isSaving && !SD.syncPending() &&
+      AsyncWriter::queued() == 0 &&
+      millis() - lastSnapshotMs >= MountCacheConfig::SAVE_PERIOD_MS) {
+    lastSnapshotMs = millis();
+    MountCache::refresh();
+  }
+  
+  // Make thumbnails for burst frames and photos saved before thumbnails
+  static uint32_t lastBackfillMs = 0;
+  if (state.sdCardAvailable && !state.isSaving && AsyncWriter::queued() == 0 &&
+      millis() - lastBackfillMs >= ThumbConfig::BACKFILL_PERIOD_MS) {
+    lastBackfillMs = millis();
+    ThumbStore::backfill();
   }
   delay(1);
 }
@@ -508,7 +749,26 @@ void cameraTask(void* parameter) {
   uint32_t countdownLastBlink = 0;
   bool countdownInProgress = false;
   
+  // Power profile state (frame cadence)
+  uint32_t lastFrameTime = 0;
+  
   for (;;) {
+    uint32_t workStart = micros();
+    
+    // Time-lapse owns the camera task while it runs
+    if (state.webTimelapseStart) {
+      state.webTimelapseStart = false;
+      if (state.currentMode == AppMode::CAMERA && !timelapse.active()) {
+        startTimelapse(state.webTimelapseInterval, state.webTimelapseCount);
+      }
+    }
+    if (timelapse.active()) {
+      serviceTimelapse();
+      TaskProfiler::addBusy(ProfiledTask::CAMERA, micros() - workStart);
+      continue;
+    }
+    state.webTimelapseStop = false;
+    
     // Process web capture requests (only in camera mode)
     if (state.webCaptureRequested) {
       state.webCaptureRequested = false;
@@ -517,6 +777,15 @@ void cameraTask(void* parameter) {
       }
     }
     
+    // Web burst requests (only in camera mode)
+    if (state.webBurstRequested) {
+      uint16_t frames = state.webBurstRequested;
+      state.webBurstRequested = 0;
+      if (state.currentMode == AppMode::CAMERA) {
+        runBurst(frames);
+      }
+    }
+    
     // Web countdown requests trigger the inline countdown (only in camera mode)
     if (state.webCountdownRequested) {
       state.webCountdownRequested = false;
@@ -536,9 +805,10 @@ void cameraTask(void* parameter) {
       state.button2Pressed = false;
       
       if (state.currentMode == AppMode::CAMERA) {
-        // Toggle capture mode
-        state.captureMode = (state.captureMode == CaptureMode::INSTANT) 
-                          ? CaptureMode::COUNTDOWN 
+        // Cycle capture mode: instant -> countdown -> burst
+        state.captureMode = (state.captureMode == CaptureMode::INSTANT)   ? CaptureMode::COUNTDOWN
+                          : (state.captureMode == CaptureMode::COUNTDOWN) ? CaptureMode::BURST
+                          : (state.captureMode == CaptureMode::BURST)     ? CaptureMode::TIMELAPSE
                           : CaptureMode::INSTANT;
         // No need to call renderModeIndicator() - the UI updates automatically in drawUIOntoFrame()
         delay(200); // Brief delay for debouncing
@@ -559,6 +829,10 @@ void cameraTask(void* parameter) {
         // Capture photo
         if (state.captureMode == CaptureMode::INSTANT) {
           handleCaptureInstant();
+        } else if (state.captureMode == CaptureMode::BURST) {
+          runBurst(BurstConfig::DEFAULT_FRAMES);
+        } else if (state.captureMode == CaptureMode::TIMELAPSE) {
+          startTimelapse(TimelapseConfig::DEFAULT_INTERVAL_MS, 0);
         } else {
           // Start countdown (non-blocking)
           countdownInProgress = true;
@@ -664,8 +938,34 @@ void cameraTask(void* parameter) {
       button2PressStart = 0;
     }
     
+    // Sensor standby when the power profile asks for it (camera task owns SPI)
+    bool wantStandby = PowerManager::wantSensorStandby() &&
+                       state.currentMode == AppMode::CAMERA && !countdownInProgress;
+    if (wantStandby != isSensorStandby()) {
+      setSensorStandby(wantStandby);
+      Serial.println(wantStandby ? "[POWER] Sensor standby" : "[POWER] Sensor awake");
+      if (!wantStandby) delay(PowerConfig::SENSOR_SETTLE_MS);
+    }
+    
+    // No preview while the sensor is in standby
+    if (state.currentMode == AppMode::CAMERA && isSensorStandby()) {
+      TaskProfiler::addBusy(ProfiledTask::CAMERA, micros() - workStart);
+      vTaskDelay(50);
+      continue;
+    }
+    
+    // Frame cadence of the active power profile (0 = as fast as possible)
+    if (state.currentMode == AppMode::CAMERA &&
+        millis() - lastFrameTime < PowerManager::settings().frameIntervalMs) {
+      TaskProfiler::addBusy(ProfiledTask::CAMERA, micros() - workStart);
+      vTaskDelay(1);
+      continue;
+    }
+    
     // Camera mode: stream live preview
     if (state.currentMode == AppMode::CAMERA) {
+      lastFrameTime = millis();
+      
       // Skip frame capture if we're currently saving a photo
       if (state.isSaving) {
         if (frameCount % 30 == 0) {
@@ -689,6 +989,8 @@ void cameraTask(void* parameter) {
         continue;
       }
       
+      PowerManager::counters.framesCaptured++;
+      
       if (frameCount % 30 == 0) {
         Serial.println("[TASK] JPEG captured, decoding...");
       }
@@ -722,10 +1024,63 @@ void cameraTask(void* parameter) {
       frameCount++;
     }
     
+    TaskProfiler::addBusy(ProfiledTask::CAMERA, micros() - workStart);
     vTaskDelay(1);
   }
 }
 
+// PROFILING
+
+/**
+ * @brief Standard profiling workload (TASK_PROFILING builds only)
+ * 
+ * Drives the firmware through live preview, instant captures, a background
+ * gallery rescan and gallery browsing while sampling stack high-water
+ * marks, then prints the profile report. Web load (e.g. repeated /photo
+ * downloads) has to be generated by a client during the run.
+ * 
+ * @param parameter Task parameter (unused)
+ */
+void profilerTask(void* parameter) {
+  Serial.println("[PROFILE] Workload starting (fetch /photo and /stream now for web load)");
+  TaskProfiler::startWindow();
+  
+  // Phase 1: live preview
+  Serial.println("[PROFILE] Phase 1: live preview");
+  TaskProfiler::sampleFor(10000);
+  
+  // Phase 2: instant captures
+  Serial.println("[PROFILE] Phase 2: captures");
+  state.captureMode = CaptureMode::INSTANT;
+  for (int i = 0; i < 3; i++) {
+    state.webCaptureRequested = true;
+    TaskProfiler::sampleFor(3000);
+  }
+  
+  // Phase 3: background rescan of /photos
+  Serial.println("[PROFILE] Phase 3: gallery rescan");
+  loadGalleryPhotoList();
+  TaskProfiler::sampleFor(3000);
+  
+  // Phase 4: gallery browsing (next photo via button 2)
+  if (state.totalPhotos > 0) {
+    Serial.println("[PROFILE] Phase 4: gallery browsing");
+    state.currentMode = AppMode::GALLERY;
+    for (int i = 0; i < 5; i++) {
+      state.button2Pressed = true;
+      TaskProfiler::sampleFor(1500);
+    }
+    state.currentMode = AppMode::CAMERA;
+  }
+  
+  // Phase 5: back to preview so the web client can finish
+  Serial.println("[PROFILE] Phase 5: live preview");
+  TaskProfiler::sampleFor(5000);
+  
+  TaskProfiler::printReport();
+  vTaskDelete(NULL);
+}
+
 // HARDWARE INITIALIZATION
 
 /**
@@ -749,27 +1104,53 @@ void initLED() {
  */
 void initSDCard() {
   digitalWrite(Pin::CAM_CS, HIGH); // Deselect camera
+  uint32_t readyStart = micros();
   
-  if (!SD.begin(Pin::SD_CS)) {
-    Serial.println("[WARN] SD card initialization failed!");
-    state.sdCardAvailable = false;
-    return;
+  {
+    StorageGuard guard;
+    
+    if (!MountCache::mount(Pin::SD_CS)) {
+      Serial.println("[WARN] SD card initialization failed!");
+      state.sdCardAvailable = false;
+      return;
+    }
+    
+    state.sdCardAvailable = true;
+    Serial.printf("[OK] SD card mounted in %lu us%s\n",
+                  (unsigned long)MountCache::lastMountUs(),
+                  SD.mountedFast() ? " from saved snapshot" : "");
+    selectSyncPolicy(Config::SYNC_POLICY);
+    selectSdClock();
+    if (SD.allocationUnit()) {
+      Serial.printf("[OK] SD allocation unit %lu KB%s\n",
+                    (unsigned long)(SD.allocationUnit() / 2),
+                    SD.auAligned() ? ", large files aligned to it" : "");
+    }
+    
+    // Create photos directory if it doesn't exist
+    if (!SD.exists("/photos")) {
+      SD.mkdir("/photos");
+      Serial.println("[INFO] Created /photos directory");
+    }
   }
   
-  state.sdCardAvailable = true;
-  Serial.println("[OK] SD card mounted");
-  
-  // Create photos directory if it doesn't exist
-  if (!SD.exists("/photos")) {
-    SD.mkdir("/photos");
-    Serial.println("[INFO] Created /photos directory");
+  // Count existing photos: replay the catalog, or scan /photos (which
+  // also rebuilds the catalog) when it is missing or damaged
+  bool fromCatalog = false;
+  if (state.sdCardAvailable) {
+    StorageGuard guard;
+    if (PackConfig::ENABLED || SD.exists(PackConfig::FILE_PATH)) {
+      PhotoPack::begin();
+    }
+    fromCatalog = PhotoCatalog::load();
+    ThumbStore::begin();
   }
-  
-  // Count existing photos
-  state.totalPhotos = countPhotosInSD();
+  state.totalPhotos = fromCatalog ? PhotoCatalog::count() : countPhotosInSD();
+  state.sdReadyUs = micros() - readyStart;
   Serial.print("[INFO] Found ");
   Serial.print(state.totalPhotos);
   Serial.println(" existing photos");
+  Serial.printf("[OK] SD ready in %lu ms\n", (unsigned long)(state.sdReadyUs / 1000));
 }
 
 /**
@@ -1076,20 +1457,33 @@ void drawUIOntoFrame(uint8_t* frameData) {
   uint16_t sdColor = state.sdCardAvailable ? GREEN : RED;
   drawString(8, 70, "SD", sdColor);
   
-  // Photo count
+  // Photo count (burst progress while a burst is running)
   char countStr[16];
-  snprintf(countStr, sizeof(countStr), "%d", state.totalPhotos);
-  drawString(8, 130, countStr, CYAN);
+  if (state.burstTotal > 0) {
+    snprintf(countStr, sizeof(countStr), "B%u %u", state.burstShot, state.burstTotal);
+    drawString(8, 130, countStr, YELLOW);
+  } else {
+    snprintf(countStr, sizeof(countStr), "%d", state.totalPhotos);
+    drawString(8, 130, countStr, CYAN);
+  }
   
   // MODE INDICATOR (RIGHT SIDE OF FRAME → BOTTOM OF LCD) 
   fillRect(295, 0, 320, 240, BLACK);
   
   // Mode text (will appear horizontal at bottom of LCD)
-  const char* modeText = (state.captureMode == CaptureMode::INSTANT) ? "INSTANT" : "COUNTDOWN";
-  uint16_t modeColor = (state.captureMode == CaptureMode::INSTANT) ? CYAN : YELLOW;
+  const char* modeText = (state.captureMode == CaptureMode::INSTANT)   ? "INSTANT"
+                       : (state.captureMode == CaptureMode::BURST)     ? "BURST"
+                       : (state.captureMode == CaptureMode::TIMELAPSE) ? "TIMELAPSE"
+                       : "COUNTDOWN";
+  uint16_t modeColor = (state.captureMode == CaptureMode::INSTANT)   ? CYAN
+                     : (state.captureMode == CaptureMode::BURST)     ? MAGENTA
+                     : (state.captureMode == CaptureMode::TIMELAPSE) ? GREEN
+                     : YELLOW;
   
   // Center the text
-  int textStartY = (state.captureMode == CaptureMode::INSTANT) ? 75 : 50;
+  int textStartY = (state.captureMode == CaptureMode::INSTANT) ? 75
+                 : (state.captureMode == CaptureMode::BURST)   ? 90
+                 : 50;
   drawString(303, textStartY, modeText, modeColor);
 }
 
@@ -1237,6 +1631,22 @@ void showMessage(const char* message, uint16_t color) {
  * @return true if capture successful, false otherwise
  */
 bool captureJpegToBuffer() {
+  uint32_t len = 0;
+  bool ok = captureJpeg(buffers.jpeg, Config::MAX_JPEG_SIZE, len);
+  buffers.jpegLen = len;
+  return ok;
+}
+
+/**
+ * @brief Capture one JPEG frame into an arbitrary buffer
+ * 
+ * @param dest Destination buffer (internal RAM or PSRAM)
+ * @param maxLen Size of dest in bytes
+ * @param outLen Set to the JPEG length (0 on FIFO errors)
+ * @return true if a valid JPEG was read
+ */
+bool captureJpeg(uint8_t* dest, uint32_t maxLen, uint32_t& outLen) {
+  outLen = 0;
   digitalWrite(Pin::SD_CS, HIGH); // Deselect SD card
   
   // Start capture
@@ -1262,7 +1672,7 @@ bool captureJpegToBuffer() {
   uint32_t len = camera.read_fifo_length();
   SPI.endTransaction();
   
-  if (len == 0 || len > Config::MAX_JPEG_SIZE) {
+  if (len == 0 || len > maxLen) {
     Serial.println("[ERROR] Invalid JPEG length");
     return false;
   }
@@ -1272,15 +1682,15 @@ bool captureJpegToBuffer() {
   camera.CS_LOW();
   camera.set_fifo_burst();
   for (uint32_t i = 0; i < len; i++) {
-    buffers.jpeg[i] = SPI.transfer(0x00);
+    dest[i] = SPI.transfer(0x00);
   }
   camera.CS_HIGH();
   SPI.endTransaction();
   
-  buffers.jpegLen = len;
+  outLen = len;
   
   // Validate JPEG header
-  if (buffers.jpeg[0] != 0xFF || buffers.jpeg[1] != 0xD8) {
+  if (dest[0] != 0xFF || dest[1] != 0xD8) {
     Serial.println("[ERROR] Invalid JPEG header");
     return false;
   }
@@ -1349,6 +1759,8 @@ void streamFrameToLCD(const uint8_t* frameData) {
   
   // IMPORTANT: Small delay to ensure DMA completes before Paint operations
   delayMicroseconds(100);
+  
+  PowerManager::counters.framesDisplayed++;
 }
 
 /**
@@ -1386,14 +1798,47 @@ void handleCaptureInstant() {
 
 // GALLERY OPERATIONS
 
+/**
+ * @brief Background rescan of /photos (runs on the slice executor)
+ */
+PhotoIndexJob photoScanJob(onPhotoScanDone);
+
+/**
+ * @brief Background compaction of the photo pack after deletes
+ */
+PackCompactJob packCompactJob;
+
 /**
  * @brief Load list of photos from SD card
  * 
- * Updates state.totalPhotos count.
+ * The count kept by save/delete is used immediately. Without a catalog a
+ * rescan is queued on the slice executor so a large directory never blocks
+ * the camera task; it updates state.totalPhotos when the scan completes.
  */
 void loadGalleryPhotoList() {
-  state.totalPhotos = countPhotosInSD();
   state.currentGalleryIndex = 0;
+  if (state.sdCardAvailable && !PhotoCatalog::isReady()) {
+    SliceExecutor::submit(&photoScanJob);
+  }
+}
+
+/**
+ * @brief Completion callback for the background photo rescan
+ * 
+ * The rebuilt catalog has no thumbnail links; the next backfill restores
+ * them from the thumbnail store.
+ * 
+ * @param count Number of photos found
+ */
+void onPhotoScanDone(int count) {
+  state.totalPhotos = count;
+  if (state.currentGalleryIndex >= count) {
+    state.currentGalleryIndex = count > 0 ? count - 1 : 0;
+  }
+  Serial.print("[GALLERY] Rescan complete: ");
+  Serial.print(count);
+  Serial.println(" photos");
+  ThumbStore::relink();
 }
 
 /**
@@ -1412,40 +1857,53 @@ void displayGalleryPhoto(int index) {
     return;
   }
   
-  String photoPath = getPhotoPath(index);
-  
-  if (!SD.exists(photoPath)) {
-    // File missing - red blinks
-    ledBlink(true, false, false, 2);
-    Serial.println("[ERROR] Photo not found!");
-    delay(1000);
-    return;
-  }
-  
-  // Read JPEG file
-  File file = SD.open(photoPath, FILE_READ);
-  if (!file) {
-    // Cannot open - red blinks
-    ledBlink(true, false, false, 2);
-    Serial.println("[ERROR] Cannot open file!");
-    delay(1000);
-    return;
+  // Read JPEG file (SD lock held only for the read; released before feedback)
+  const char* error = NULL;
+  int errorBlinks = 2;
+  {
+    StorageGuard guard;
+    
+    uint32_t number = photoNumberAt(index);
+    uint32_t packedLength = PhotoPack::length(number);
+    uint32_t openStart = micros();
+    File file = packedLength ? File() : PhotoIndex::open(number);
+    Serial.printf("[GALLERY] Open photo_%lu.jpg in %lu us\n", (unsigned long)number,
+                  (unsigned long)(micros() - openStart));
+    if (packedLength > Config::MAX_JPEG_SIZE) {
+      error = "[ERROR] File too large!";
+      errorBlinks = 3;
+    } else if (packedLength) {
+      if (readPackedSliced(number, buffers.jpeg, packedLength) != packedLength) {
+        error = "[ERROR] Read failed!";
+      } else {
+        buffers.jpegLen = packedLength;
+      }
+    } else if (!file) {
+      error = "[ERROR] Photo not found!";       // File missing
+    } else if (file.size() > Config::MAX_JPEG_SIZE) {
+      error = "[ERROR] File too large!";        // File too large
+      errorBlinks = 3;
+      file.close();
+    } else {
+      size_t fileSize = file.size();
+      size_t got = readFileSliced(file, number, buffers.jpeg, fileSize);
+      file.close();
+      if (got != fileSize) {
+        error = "[ERROR] Read failed!";
+      } else {
+        buffers.jpegLen = fileSize;
+      }
+    }
   }
   
-  size_t fileSize = file.size();
-  if (fileSize > Config::MAX_JPEG_SIZE) {
-    // File too large - red blinks
-    ledBlink(true, false, false, 3);
-    Serial.println("[ERROR] File too large!");
-    file.close();
+  if (error) {
+    // Red blinks
+    ledBlink(true, false, false, errorBlinks);
+    Serial.println(error);
     delay(1000);
     return;
   }
   
-  file.read(buffers.jpeg, fileSize);
-  file.close();
-  buffers.jpegLen = fileSize;
-  
   // Decode and display
   if (decodeJpegToRGB565()) {
     // Draw gallery UI directly onto frame buffer (no Paint functions!)
@@ -1461,6 +1919,44 @@ void displayGalleryPhoto(int index) {
   }
 }
 
+/**
+ * @brief SD.removeFiles() filter for photos numbered N in [from, to]
+ */
+uint8_t matchPhotoRange(const char* name, void* context) {
+  const uint32_t* range = (const uint32_t*)context;
+  uint32_t number = PhotoIndex::parseNumber(name);
+  return number != 0 && number >= range[0] && number <= range[1];
+}
+
+/**
+ * @brief Delete photos numbered from..to in one pass
+ * 
+ * Deleting one photo at a time rewrites the directory block and the FAT
+ * blocks of every photo. SD.removeFiles() writes each of them about once,
+ * packed photos are tombstoned with a single flush and the catalog takes
+ * one checkpoint instead of a journal record per photo. Caller must hold
+ * the StorageGuard.
+ * 
+ * @param from First photo number
+ * @param to Last photo number (PhotoIndexConfig::MAX_NUMBER for all)
+ * @return Photos deleted, or -1 if deleting failed part way
+ */
+int32_t deletePhotoRange(uint32_t from, uint32_t to) {
+  uint32_t range[2] = { from, to };
+  int32_t files = SD.removeFiles(PhotoIndexConfig::DIR, matchPhotoRange, range);
+  if (files != 0) PhotoIndex::noteDirChange();
+  int32_t packed = PhotoPack::removeRange(from, to);
+  
+  // Some photos may be gone even after an error; forget the whole range
+  PhotoIndex::removeRange(from, to);
+  PhotoCatalog::removeRange(from, to);
+  if (PhotoPack::needsCompaction()) {
+    SliceExecutor::submit(&packCompactJob);
+  }
+  if (files < 0 || packed < 0) return -1;
+  return files + packed;
+}
+
 /**
  * @brief Delete currently displayed photo
  */
@@ -1469,9 +1965,22 @@ void deleteCurrentPhoto() {
     return;
   }
   
-  String photoPath = getPhotoPath(state.currentGalleryIndex);
+  bool removed;
+  {
+    StorageGuard guard;
+    uint32_t number = photoNumberAt(state.currentGalleryIndex);
+    removed = PhotoPack::contains(number) ? PhotoPack::remove(number)
+                                          : PhotoIndex::removeFile(number);
+    if (removed) {
+      PhotoIndex::remove(number);
+      PhotoCatalog::remove(number);
+    }
+    if (PhotoPack::needsCompaction()) {
+      SliceExecutor::submit(&packCompactJob);
+    }
+  }
   
-  if (SD.remove(photoPath)) {
+  if (removed) {
     state.totalPhotos--;
     showMessage("Deleted!", GREEN);
     
@@ -1506,6 +2015,7 @@ bool savePhoto() {
   state.isSaving = true;
   Serial.println("[SAVE] Set isSaving=true, waiting for camera task to pause...");
   delay(50); // Give camera task time to finish current frame
+  wakeSensorForCapture();
   
   // Capture a fresh frame specifically for saving
   Serial.println("[SAVE] Capturing fresh frame...");
@@ -1518,52 +2028,570 @@ bool savePhoto() {
   
   digitalWrite(Pin::CAM_CS, HIGH); // Deselect camera
   
+  // Thumbnail before taking the card: decoding takes longer than the write
+  uint8_t* thumb;
+  size_t thumbLen;
+  uint32_t thumbStart = micros();
+  if (ThumbStore::make(buffers.jpeg, buffers.jpegLen, &thumb, &thumbLen)) {
+    Serial.printf("[SAVE] Thumbnail %u bytes in %lu us\n", (unsigned)thumbLen,
+                  (unsigned long)(micros() - thumbStart));
+  }
+  
+  bool success;
+  {
+    StorageGuard guard;
+    success = writePhotoFile(buffers.jpeg, buffers.jpegLen, thumb, thumbLen);
+  }
+  free(thumb);
+  
+  // Resume camera task
+  Serial.println("[SAVE] Setting isSaving=false to resume camera task...");
+  state.isSaving = false;
+  Serial.println("[SAVE] Save complete, camera task should resume now");
+  
+  return success;
+}
+
+/**
+ * @brief Write a JPEG as the next sequential photo file
+ * 
+ * Used by instant capture; burst frames take the same open/close steps
+ * through the async writer. Caller must hold the StorageGuard.
+ * 
+ * @param data JPEG data
+ * @param length JPEG length in bytes
+ * @param thumb Thumbnail from ThumbStore::make(), or NULL
+ * @param thumbLen Thumbnail length in bytes
+ * @return true if the whole file was written
+ */
+bool writePhotoFile(const uint8_t* data, uint32_t length,
+                    const uint8_t* thumb, size_t thumbLen) {
+  if (PackConfig::ENABLED && PhotoPack::isOpen()) {
+    return writePhotoPacked(data, length, thumb, thumbLen);
+  }
+  
+  uint32_t number = nextPhotoNumber();
+  
+  // FAT traffic of this save, reported with the write time
+  uint32_t fatWrites = SD.fatWrites();
+  uint32_t fatMirrorWrites = SD.fatMirrorWrites();
+  
+  File file = openPhotoFile(number, length);
+  if (!file) {
+    state.lastPhotoNumber--;
+    return false;
+  }
+  
+  Serial.print("[SAVE] Writing ");
+  Serial.print(length);
+  Serial.println(" bytes...");
+  
+  uint32_t writeStart = micros();
+  size_t written = file.write(data, length);
+  bool ok = closePhotoFile(file, number, written, length, thumb, thumbLen);
+  uint32_t writeUs = micros() - writeStart;
+  
+  Serial.printf("[SAVE] Wrote %u bytes in %lu us (FAT writes %lu, mirror %lu)\n",
+                (unsigned)written, (unsigned long)writeUs,
+                (unsigned long)(SD.fatWrites() - fatWrites),
+                (unsigned long)(SD.fatMirrorWrites() - fatMirrorWrites));
+  
+  if (!ok) {
+    return false;
+  }
+  
+  state.totalPhotos++;
+  Serial.printf("[INFO] Photo saved: photo_%lu.jpg\n", (unsigned long)number);
+  return true;
+}
+
+/**
+ * @brief Create photo N's file with room for its data
+ * 
+ * Generated names follow the photo count (not photoCounter) so numbering
+ * stays sequential: P0000001.JPG, P0000002.JPG, etc. (8.3 names, exported
+ * as photo_N.jpg). Caller must hold the StorageGuard.
+ * 
+ * @param number Photo number N
+ * @param length JPEG length in bytes
+ * @return Open file, or a closed one if it could not be created
+ */
+File openPhotoFile(uint32_t number, uint32_t length) {
   // Ensure photos directory exists
   if (!SD.exists("/photos")) {
     SD.mkdir("/photos");
   }
   
-  // Generate filename based on total photos count (not photoCounter)
-  // This ensures sequential numbering: photo_1.jpg, photo_2.jpg, etc.
   char filename[32];
-  snprintf(filename, sizeof(filename), "/photos/photo_%d.jpg", state.totalPhotos + 1);
+  PhotoIndex::photoPath(number, filename, sizeof(filename));
   
   Serial.print("[SAVE] Opening file: ");
   Serial.println(filename);
   
-  // Write file
   File file = SD.open(filename, FILE_WRITE);
   if (!file) {
     Serial.println("[ERROR] Cannot create file");
-    state.isSaving = false;
+    return file;
+  }
+  PhotoIndex::noteDirChange();
+  
+  // Reserve one contiguous extent so the write streams without FAT
+  // updates; the unused tail of the last cluster is freed on close
+  if (!file.preAllocate(length)) {
+    Serial.println("[SAVE] Preallocation failed, growing file instead");
+  }
+  return file;
+}
+
+/**
+ * @brief Close a written photo and record it in the index and catalog
+ * 
+ * The thumbnail, if any, is stored before the catalog record that points
+ * at it. Caller must hold the StorageGuard and updates state.totalPhotos.
+ * 
+ * @param file Photo opened by openPhotoFile()
+ * @param number Photo number N
+ * @param written Bytes written
+ * @param length JPEG length in bytes
+ * @param thumb Thumbnail from ThumbStore::make(), or NULL for the backfill
+ * @param thumbLen Thumbnail length in bytes
+ * @return true if the whole photo was written
+ */
+bool closePhotoFile(File& file, uint32_t number, uint32_t written, uint32_t length,
+                    const uint8_t* thumb, size_t thumbLen) {
+  uint32_t firstCluster = file.firstCluster();
+  if (written == length) {
+    PhotoIndex::add(number, file);
+  }
+  file.close();
+  
+  PowerManager::counters.sdBytesWritten += written;
+  
+  if (written != length) {
     return false;
   }
   
-  Serial.print("[SAVE] Writing ");
-  Serial.print(buffers.jpegLen);
-  Serial.println(" bytes...");
+  // Catalog only once the photo is closed and on the card
+  uint32_t thumbOffset = ThumbStore::append(number, written, firstCluster, thumb, thumbLen);
+  if (thumbOffset) ThumbStore::noteSaved();
+  PhotoCatalog::add(number, written, firstCluster, thumbOffset);
+  PowerManager::counters.photosSaved++;
+  syncAccounting.photos++;
+  return true;
+}
+
+/**
+ * @brief Select the SD sync policy and restart its write accounting
+ * 
+ * Caller must hold the StorageGuard (leaving SD_SYNC_DEFERRED flushes).
+ * 
+ * @param policy SD_SYNC_WRITE, SD_SYNC_CLOSE or SD_SYNC_DEFERRED
+ * @return false if the policy is unknown or the flush failed
+ */
+bool selectSyncPolicy(uint8_t policy) {
+  if (!SD.setSyncPolicy(policy)) return false;
+  syncAccounting.photos = 0;
+  syncAccounting.fatWrites = SD.fatWrites();
+  syncAccounting.mirrorWrites = SD.fatMirrorWrites();
+  syncAccounting.dirWrites = SD.dirWrites();
+  syncAccounting.entryUpdates = SD.entryUpdates();
+  syncAccounting.syncs = SD.syncCount();
+  syncAccounting.deferredSyncs = SD.deferredSyncCount();
+  return true;
+}
+
+/**
+ * @brief Raise the SD SPI clock to the fastest speed the card reads reliably
+ * 
+ * The card is mounted at 4 MHz. The clock found for it is kept in NVS
+ * under a hash of its CID, so the next mount of the same card tries that
+ * clock first instead of stepping up to it; a card that no longer passes
+ * at its saved clock is ramped again and the result saved. After a fast
+ * mount (sd_mount_cache.h) the saved clock is resumed without the ramp's
+ * reference reads. Caller must hold the StorageGuard.
+ */
+void selectSdClock() {
+  uint32_t hash;
+  char key[12];
+  uint32_t saved = 0;
+  Preferences prefs;
+  
+  bool known = SD.cardHash(hash) && prefs.begin("sdclock", false);
+  if (known) {
+    snprintf(key, sizeof(key), "c%08lx", (unsigned long)hash);
+    saved = prefs.getUInt(key, 0);
+  }
   
-  size_t written = file.write(buffers.jpeg, buffers.jpegLen);
-  file.close();
+  // A card recognised by its mount snapshot goes straight to its clock
+  uint32_t clock = 0;
+  if (SD.mountedFast() && saved && saved <= Config::SD_CLOCK_LIMIT) {
+    clock = SD.resumeClock(saved);
+  }
+  if (clock == 0) clock = SD.rampClock(Config::SD_CLOCK_LIMIT, saved);
+  if (known) {
+    if (clock != saved) prefs.putUInt(key, clock);
+    prefs.end();
+  }
+  Serial.printf("[OK] SD clock %lu Hz%s%s\n", (unsigned long)clock,
+                SD.highSpeed() ? ", high speed mode" : "",
+                clock == saved ? ", saved for this card" : "");
+}
+
+/**
+ * @brief Save a photo into the packed container
+ * 
+ * Same bookkeeping as writePhotoFile(); the photo is exported as
+ * photo_N.jpg by the web server. Caller must hold the StorageGuard.
+ * 
+ * @param data JPEG data
+ * @param length JPEG length in bytes
+ * @param thumb Thumbnail from ThumbStore::make(), or NULL
+ * @param thumbLen Thumbnail length in bytes
+ * @return true if the photo was stored
+ */
+bool writePhotoPacked(const uint8_t* data, uint32_t length,
+                      const uint8_t* thumb, size_t thumbLen) {
+  uint32_t number = nextPhotoNumber();
+  
+  uint32_t writeStart = micros();
+  bool ok = PhotoPack::save(number, data, length);
+  uint32_t writeUs = micros() - writeStart;
+  
+  Serial.printf("[SAVE] Packed photo_%lu.jpg, %lu bytes in %lu us\n",
+                (unsigned long)number, (unsigned long)length, (unsigned long)writeUs);
+  if (!ok) {
+    Serial.println("[ERROR] Pack write failed");
+    state.lastPhotoNumber--;
+    return false;
+  }
   
-  Serial.print("[SAVE] Wrote ");
-  Serial.print(written);
-  Serial.println(" bytes");
+  PowerManager::counters.sdBytesWritten += length;
+  state.totalPhotos++;
+  uint32_t thumbOffset = ThumbStore::append(number, length, 0, thumb, thumbLen);
+  if (thumbOffset) ThumbStore::noteSaved();
+  PhotoCatalog::add(number, length, 0, thumbOffset);
+  PowerManager::counters.photosSaved++;
+  return true;
+}
+
+// BURST CAPTURE
+
+/**
+ * @brief Background writer that drains the burst ring to SD
+ */
+BurstFlush burstFlush(startBurstPhoto, finishBurstPhoto);
+
+/**
+ * @brief Open the next photo for a burst frame (async writer, guard held)
+ * 
+ * The number is taken from the count right away, so saves made while the
+ * frame is being written get the next one. In pack mode the frame is
+ * saved here in one go.
+ * 
+ * @return false if the photo could not be created
+ */
+bool startBurstPhoto(AsyncWriteRequest& req) {
+  if (PackConfig::ENABLED && PhotoPack::isOpen()) {
+    if (!writePhotoPacked(req.data, req.length)) return false;
+    req.written = req.length;
+    return true;
+  }
   
-  bool success = false;
-  if (written == buffers.jpegLen) {
-    state.totalPhotos++;
-    Serial.print("[INFO] Photo saved: ");
-    Serial.println(filename);
-    success = true;
+  req.number = nextPhotoNumber();
+  req.file = openPhotoFile(req.number, req.length);
+  if (!req.file) {
+    state.lastPhotoNumber--;
+    return false;
+  }
+  state.totalPhotos++;
+  return true;
+}
+
+/**
+ * @brief Close and record a burst photo once its write completes
+ */
+void finishBurstPhoto(AsyncWriteRequest& req, bool ok) {
+  if (!req.file) return;  // Packed by startBurstPhoto, or never created
+  
+  if (!closePhotoFile(req.file, req.number, req.written, req.length) || !ok) {
+    // Give the number back unless a later save has taken the next one
+    if (state.lastPhotoNumber == req.number) state.lastPhotoNumber--;
+    if (state.totalPhotos > 0) state.totalPhotos--;
+    Serial.printf("[BURST] photo_%lu.jpg failed after %lu of %lu bytes\n",
+                  (unsigned long)req.number, (unsigned long)req.written,
+                  (unsigned long)req.length);
+    return;
+  }
+  Serial.printf("[BURST] Saved photo_%lu.jpg, %lu bytes in %lu us\n",
+                (unsigned long)req.number, (unsigned long)req.length,
+                (unsigned long)(micros() - req.startUs));
+}
+
+/**
+ * @brief Capture a burst of frames into the PSRAM ring (camera task)
+ * 
+ * Frames are captured back-to-back at the sensor's rate and handed to the
+ * slice executor for saving while the burst continues. The burst stops
+ * early if the ring fills faster than the SD card drains it. The live
+ * count is drawn onto the last preview frame a few times per second.
+ * 
+ * @param frames Number of frames requested
+ */
+void runBurst(uint16_t frames) {
+  if (!state.sdCardAvailable || BurstRing::size() == 0) {
+    Serial.println("[BURST] Unavailable (no SD card or no PSRAM ring)");
+    ledBlink(true, false, false, 3);
+    return;
   }
   
-  // Resume camera task
-  Serial.println("[SAVE] Setting isSaving=false to resume camera task...");
-  state.isSaving = false;
-  Serial.println("[SAVE] Save complete, camera task should resume now");
+  wakeSensorForCapture();
+  
+  BurstStats stats;
+  stats.requested = frames;
+  state.burstTotal = frames;
+  state.burstShot = 0;
+  state.lastStatus = "Burst...";
+  setLED(true, false, false);
+  Serial.printf("[BURST] Starting %u frames (%lu/%u slots in use)\n",
+                frames, (unsigned long)BurstRing::used(), BurstRing::size());
+  
+  uint32_t start = millis();
+  uint32_t lastDisplay = 0;
+  
+  for (uint16_t i = 0; i < frames; i++) {
+    uint8_t* slot = BurstRing::reserve();
+    if (slot == NULL) {
+      stats.ringFull = true;
+      Serial.println("[BURST] Ring full - stopping early");
+      break;
+    }
+    
+    uint32_t len = 0;
+    if (!captureJpeg(slot, BurstConfig::SLOT_BYTES, len)) {
+      continue;
+    }
+    BurstRing::commit(len);
+    burstFlush.submitCommitted();
+    
+    stats.captured++;
+    state.burstShot = stats.captured;
+    PowerManager::counters.framesCaptured++;
+    
+    // Live count on the LCD (over the last preview frame)
+    if (millis() - lastDisplay >= BurstConfig::DISPLAY_EVERY_MS) {
+      lastDisplay = millis();
+      drawUIOntoFrame(buffers.frame);
+      streamFrameToLCD(buffers.frame);
+    }
+  }
   
-  return success;
+  stats.durationMs = millis() - start;
+  burstFlush.submitCommitted();  // Pick up frames the queue could not take
+  
+  state.lastBurst = stats;
+  state.burstTotal = 0;
+  PowerManager::noteActivity();
+  
+  uint32_t fps = stats.fpsX10();
+  Serial.printf("[BURST] Captured %u/%u in %lu ms (%lu.%lu fps), ring %u slots%s\n",
+                stats.captured, stats.requested, (unsigned long)stats.durationMs,
+                (unsigned long)(fps / 10), (unsigned long)(fps % 10),
+                BurstRing::size(), stats.ringFull ? ", ring full" : "");
+  
+  state.lastStatus = stats.captured == stats.requested ? "Saved!" : "Burst cut";
+  ledBlink(false, true, false, 2);
+  setLED(false, false, false);
+  state.lastStatus = "Idle";
+}
+
+// TIME-LAPSE
+
+/**
+ * @brief Sensor standby state (changed only from the camera task)
+ */
+static bool sensorStandbyState = false;
+
+bool isSensorStandby() {
+  return sensorStandbyState;
+}
+
+/**
+ * @brief Put the OV2640 into or out of standby via the ArduCHIP PWDN line
+ * 
+ * Registers are kept in standby, so no re-init is needed on wake; the
+ * first frame after wake may be badly exposed.
+ * 
+ * @param standby true to enter standby, false to wake
+ */
+void setSensorStandby(bool standby) {
+  if (standby == sensorStandbyState) return;
+  
+  SPI.beginTransaction(SPISettings(8000000, MSBFIRST, SPI_MODE0));
+  if (standby) {
+    camera.set_bit(ARDUCHIP_GPIO, GPIO_PWDN_MASK);
+  } else {
+    camera.clear_bit(ARDUCHIP_GPIO, GPIO_PWDN_MASK);
+  }
+  SPI.endTransaction();
+  
+  sensorStandbyState = standby;
+  PowerManager::setSensorStandby(standby);
+}
+
+/**
+ * @brief Make sure the sensor is out of standby before a capture
+ * 
+ * Capture requests are handled before the camera task re-evaluates the
+ * standby state, so a shot requested while idle in the battery profile
+ * would otherwise be taken with PWDN asserted.
+ */
+void wakeSensorForCapture() {
+  if (!isSensorStandby()) return;
+  
+  setSensorStandby(false);
+  Serial.println("[POWER] Sensor awake for capture");
+  delay(PowerConfig::SENSOR_SETTLE_MS);
+}
+
+/**
+ * @brief Start an interval capture session (camera task)
+ * 
+ * Frames are appended to one Motion-JPEG file per session
+ * (/tlapse/tl_NNN.mjp), which avoids a directory entry per frame. Between
+ * shots the sensor is in standby, the LCD panel sleeps and the battery
+ * power profile (80MHz CPU, WiFi max modem sleep) is forced.
+ * 
+ * @param intervalMs Time between shots
+ * @param count Number of shots (0 = until stopped)
+ */
+void startTimelapse(uint32_t intervalMs, uint32_t count) {
+  if (!state.sdCardAvailable) {
+    ledBlink(true, false, false, 3);
+    return;
+  }
+  
+  char path[32];
+  {
+    StorageGuard guard;
+    if (!SD.exists(TimelapseConfig::DIR)) {
+      SD.mkdir(TimelapseConfig::DIR);
+    }
+    int n = 1;
+    for (; n < 1000; n++) {
+      snprintf(path, sizeof(path), "%s/tl_%03d.mjp", TimelapseConfig::DIR, n);
+      if (!SD.exists(path)) break;
+    }
+    timelapseFile = n < 1000 ? SD.open(path, FILE_WRITE) : File();
+  }
+  
+  if (!timelapseFile) {
+    Serial.println("[TIMELAPSE] Cannot create output file");
+    ledBlink(true, false, false, 2);
+    return;
+  }
+  
+  timelapse.start(millis(), intervalMs, count);
+  state.lastStatus = "Timelapse";
+  Serial.printf("[TIMELAPSE] Started: %s, every %lu ms, %lu shots\n", path,
+                (unsigned long)timelapse.intervalMs(), (unsigned long)count);
+  ledBlink(false, true, false, 1);
+  
+  // Low-power state for everything but the shot itself
+  PowerManager::force(PowerProfile::BATTERY);
+  LCD_SetBacklight(0);
+  LCD_Sleep(1);
+}
+
+/**
+ * @brief End the session: close the file and restore sensor, LCD and power
+ */
+void stopTimelapse() {
+  timelapse.stop();
+  
+  {
+    StorageGuard guard;
+    timelapseFile.close();
+  }
+  
+  setSensorStandby(false);
+  LCD_Sleep(0);
+  PowerManager::release();
+  
+  StreamString report;
+  timelapse.stats.printJson(report);
+  Serial.print("[TIMELAPSE] Done: ");
+  Serial.println(report);
+  
+  state.lastStatus = "Idle";
+  ledBlink(false, true, false, 2);
+}
+
+/**
+ * @brief One pass of the time-lapse loop (camera task)
+ * 
+ * Sleeps until the wake time, wakes the sensor early enough to be ready
+ * (the lead adapts to measured wake latency), waits for the exact slot,
+ * captures and appends the frame, then returns the sensor to standby.
+ * Sleeps are capped so a stop request is noticed quickly.
+ */
+void serviceTimelapse() {
+  // Stop via button 1 or web
+  if (state.button1Pressed || state.webTimelapseStop) {
+    state.button1Pressed = false;
+    state.webTimelapseStop = false;
+    stopTimelapse();
+    return;
+  }
+  state.button2Pressed = false;  // Mode changes wait until the session ends
+  
+  uint32_t now = millis();
+  
+  // Wake the sensor ahead of the shot and drop the warm-up frame(s)
+  if (isSensorStandby() && (int32_t)(now - timelapse.wakeAt()) >= 0) {
+    uint32_t wakeStart = millis();
+    setSensorStandby(false);
+    for (uint8_t i = 0; i < TimelapseConfig::WARMUP_FRAMES; i++) {
+      captureJpegToBuffer();
+    }
+    timelapse.onWake(millis() - wakeStart);
+    now = millis();
+  }
+  
+  // Not due yet: sleep until the next wake or shot time
+  if ((int32_t)(timelapse.dueAt() - now) > 0) {
+    uint32_t target = isSensorStandby() ? timelapse.wakeAt() : timelapse.dueAt();
+    int32_t wait = (int32_t)(target - now);
+    if (wait > (int32_t)TimelapseConfig::MAX_SLEEP_SLICE_MS) {
+      wait = TimelapseConfig::MAX_SLEEP_SLICE_MS;
+    }
+    vTaskDelay(wait > 0 ? pdMS_TO_TICKS(wait) : 1);
+    return;
+  }
+  
+  // Shot
+  uint32_t shotStart = millis();
+  bool ok = captureJpegToBuffer();
+  uint32_t len = buffers.jpegLen;
+  
+  if (ok) {
+    StorageGuard guard;
+    size_t written = timelapseFile.write(buffers.jpeg, len);
+    timelapseFile.flush();
+    ok = (written == len);
+    PowerManager::counters.sdBytesWritten += written;
+  }
+  PowerManager::counters.framesCaptured++;
+  
+  timelapse.onShot(shotStart, millis(), ok, ok ? len : 0);
+  
+  if (!timelapse.active()) {
+    stopTimelapse();
+    return;
+  }
+  
+  if (timelapse.sleepBetweenShots()) {
+    setSensorStandby(true);
+  }
 }
 
 /**
@@ -1574,10 +2602,51 @@ bool savePhoto() {
  */
 String getPhotoPath(int index) {
   char filename[32];
-  snprintf(filename, sizeof(filename), "/photos/photo_%d.jpg", index + 1);
+  PhotoIndex::photoPath(photoNumberAt(index), filename, sizeof(filename));
   return String(filename);
 }
 
+/**
+ * @brief Photo number shown at a gallery position
+ * 
+ * Deletes leave gaps in the numbering, so positions map through the
+ * catalog (number order) when it is loaded. Caller must hold the
+ * StorageGuard.
+ * 
+ * @param index Photo index (0-based)
+ * @return Photo number N
+ */
+uint32_t photoNumberAt(int index) {
+  if (PhotoCatalog::isReady() && index >= 0 && (uint32_t)index < PhotoCatalog::count()) {
+    return PhotoCatalog::at(index).number;
+  }
+  return index + 1;
+}
+
+/**
+ * @brief Take the number for a new photo
+ * 
+ * The photo count is not a free number once a delete has left a gap, so
+ * the next number is one past the highest in the catalog, the index, or
+ * handed out to a save still being written. Numbering restarts at 1 when
+ * no photos are left. Caller must hold the StorageGuard.
+ * 
+ * @return Photo number N
+ */
+uint32_t nextPhotoNumber() {
+  uint32_t highest = state.totalPhotos == 0 ? 0 : state.lastPhotoNumber;
+  if (state.totalPhotos > 0 && PhotoCatalog::isReady() && PhotoCatalog::count() > 0) {
+    uint32_t last = PhotoCatalog::at(PhotoCatalog::count() - 1).number;
+    if (last > highest) highest = last;
+  }
+  if (state.totalPhotos > 0 && PhotoIndex::highestNumber() > highest) {
+    highest = PhotoIndex::highestNumber();
+  }
+  if (highest < state.totalPhotos) highest = state.totalPhotos;
+  state.lastPhotoNumber = highest + 1;
+  return state.lastPhotoNumber;
+}
+
 /**
  * @brief Count total photos in SD card
  * 
@@ -1586,24 +2655,102 @@ String getPhotoPath(int index) {
 int countPhotosInSD() {
   if (!state.sdCardAvailable) return 0;
   
-  int count = 0;
-  File root = SD.open("/photos");
-  if (!root) return 0;
+  StorageGuard guard;
+  SliceBudget budget(true);
   
-  File file = root.openNextFile();
-  while (file) {
-    if (!file.isDirectory()) {
-      String name = file.name();
-      if (name.endsWith(".jpg") || name.endsWith(".JPG")) {
-        count++;
-      }
+  // Builds the photo index in the same pass
+  PhotoIndexJob job;
+  while (!job.step(budget)) {
+    budget.yieldNow();
+  }
+  job.finish();
+  return job.result();
+}
+
+/**
+ * @brief Read a file into memory in chunks, yielding between slices
+ * 
+ * Caller must hold the StorageGuard; it is released while yielding, and
+ * the file is re-validated after each yield (PhotoIndex::revalidate()).
+ * 
+ * @param file Open photo (closed if it was deleted while yielding)
+ * @param number Photo number the file was opened as
+ * @param dest Destination buffer
+ * @param length Number of bytes to read
+ * @return Number of bytes actually read
+ */
+size_t readFileSliced(File& file, uint32_t number, uint8_t* dest, size_t length) {
+  SliceBudget budget(true);
+  size_t total = 0;
+  uint32_t readUs = 0;
+  uint32_t seen = PhotoIndex::dirChangeCount();
+  
+  // Large chunks let the SD layer read whole cluster runs in one transfer
+  while (total < length) {
+    size_t chunk = length - total;
+    if (chunk > SliceConfig::DIRECT_CHUNK_BYTES) chunk = SliceConfig::DIRECT_CHUNK_BYTES;
+    
+    uint32_t start = micros();
+    int n = file.read(dest + total, chunk);
+    readUs += micros() - start;
+    if (n <= 0) break;
+    total += n;
+    if (budget.yieldIfExpired() &&
+        !PhotoIndex::revalidate(file, number, NULL, total, seen)) {
+      break;
     }
-    file.close();
-    file = root.openNextFile();
   }
-  root.close();
   
-  return count;
+  PowerManager::counters.sdBytesRead += total;
+  logReadRate("[SD] Read", total, readUs);
+  return total;
+}
+
+/**
+ * @brief Read a packed photo into memory in chunks, yielding between slices
+ * 
+ * Caller must hold the StorageGuard; it is released while yielding.
+ * 
+ * @param number Photo number
+ * @param dest Destination buffer
+ * @param length Number of bytes to read
+ * @return Number of bytes actually read
+ */
+size_t readPackedSliced(uint32_t number, uint8_t* dest, size_t length) {
+  SliceBudget budget(true);
+  size_t total = 0;
+  uint32_t readUs = 0;
+  
+  while (total < length) {
+    size_t chunk = length - total;
+    if (chunk > SliceConfig::DIRECT_CHUNK_BYTES) chunk = SliceConfig::DIRECT_CHUNK_BYTES;
+    
+    uint32_t start = micros();
+    int n = PhotoPack::read(number, total, dest + total, chunk);
+    readUs += micros() - start;
+    if (n <= 0) break;
+    total += n;
+    budget.yieldIfExpired();
+  }
+  
+  PowerManager::counters.sdBytesRead += total;
+  logReadRate("[PACK] Read", total, readUs);
+  return total;
+}
+
+/**
+ * @brief Log sequential read throughput (SD time only, yields excluded)
+ * 
+ * @param tag Log prefix
+ * @param bytes Bytes read
+ * @param us Time spent in SD reads
+ */
+void logReadRate(const char* tag, uint32_t bytes, uint32_t us) {
+  if (us == 0) us = 1;
+  uint32_t mbX100 = (uint32_t)((uint64_t)bytes * 100 / us);   // bytes/us = MB/s
+  Serial.printf("%s %lu bytes in %lu us (%lu.%02lu MB/s)\n",
+                tag, (unsigned long)bytes, (unsigned long)us,
+                (unsigned long)(mbX100 / 100), (unsigned long)(mbX100 % 100));
 }
 
 // LED CONTROL
@@ -1652,6 +2799,7 @@ void IRAM_ATTR button1ISR() {
   if (now - state.lastButton1Time > Config::DEBOUNCE_MS) {
     state.button1Pressed = true;
     state.lastButton1Time = now;
+    PowerManager::noteActivity();
   }
 }
 
@@ -1665,6 +2813,7 @@ void IRAM_ATTR button2ISR() {
   if (now - state.lastButton2Time > Config::DEBOUNCE_MS) {
     state.button2Pressed = true;
     state.lastButton2Time = now;
+    PowerManager::noteActivity();
   }
 }
 
@@ -1676,6 +2825,9 @@ void IRAM_ATTR button2ISR() {
  * Serves compressed HTML for camera control page.
  */
 void handleRoot() {
+  PowerManager::counters.webRequests++;
+  PowerManager::counters.webBytesSent += index_html_gz_len;
+  PowerManager::noteActivity();
   webServer.sendHeader("Content-Encoding", "gzip");
   webServer.send_P(200, "text/html",
     (const char*)index_html_gz,
@@ -1689,6 +2841,9 @@ void handleRoot() {
  * Serves compressed HTML for photo gallery page.
  */
 void handleGallery() {
+  PowerManager::counters.webRequests++;
+  PowerManager::counters.webBytesSent += gallery_html_gz_len;
+  PowerManager::noteActivity();
   webServer.sendHeader("Content-Encoding", "gzip");
   webServer.send_P(200, "text/html",
     (const char*)gallery_html_gz,
@@ -1700,6 +2855,8 @@ void handleGallery() {
  * @brief Handle web capture request
  */
 void handleCapture() {
+  PowerManager::counters.webRequests++;
+  PowerManager::noteActivity();
   state.webCaptureRequested = true;
   webServer.send(200, "text/plain", "OK");
 }
@@ -1708,6 +2865,8 @@ void handleCapture() {
  * @brief Handle mode toggle request
  */
 void handleToggleMode() {
+  PowerManager::counters.webRequests++;
+  PowerManager::noteActivity();
   state.button2Pressed = true;
   webServer.send(200, "text/plain", "OK");
 }
@@ -1716,6 +2875,8 @@ void handleToggleMode() {
  * @brief Handle countdown start request
  */
 void handleCountdownStart() {
+  PowerManager::counters.webRequests++;
+  PowerManager::noteActivity();
   state.webCountdownRequested = true;
   webServer.send(200, "text/plain", "OK");
 }
@@ -1726,13 +2887,44 @@ void handleCountdownStart() {
  * Returns JSON with current system state.
  */
 void handleStatus() {
-  const char* mode = (state.captureMode == CaptureMode::INSTANT) 
-                     ? "Instant" : "Countdown";
+  // Polled by the web UI - counted, but not treated as user activity
+  PowerManager::counters.webRequests++;
+  
+  const char* mode = (state.captureMode == CaptureMode::INSTANT)   ? "Instant"
+                   : (state.captureMode == CaptureMode::BURST)     ? "Burst"
+                   : (state.captureMode == CaptureMode::TIMELAPSE) ? "Timelapse"
+                   : "Countdown";
   
   String json = "{";
   json += "\"mode\":\"" + String(mode) + "\",";
   json += "\"status\":\"" + state.lastStatus + "\",";
   json += "\"photos\":" + String(state.totalPhotos);
+  int64_t freeBytes = state.sdCardAvailable ? SD.freeBytes() : -1;
+  if (freeBytes >= 0) {
+    json += ",\"free_mb\":" + String((uint32_t)(freeBytes >> 20));
+  }
+  if (state.sdCardAvailable) {
+    json += ",\"sd_cache\":{\"hits\":" + String(SD.cacheHits());
+    json += ",\"misses\":" + String(SD.cacheMisses());
+    json += ",\"read_ahead\":" + String(SD.readAheadBlocks());
+    json += ",\"read_ahead_hits\":" + String(SD.readAheadHits());
+    json += ",\"path_hits\":" + String(SD.pathCacheHits());
+    json += ",\"path_misses\":" + String(SD.pathCacheMisses()) + "}";
+    json += ",\"sd_clock\":{\"hz\":" + String(SD.clock());
+    json += ",\"high_speed\":" + String(SD.highSpeed() ? "true" : "false");
+    json += ",\"errors\":" + String(SD.clockErrors()) + "}";
+    json += ",\"sd_write\":{\"au_kb\":" + String(SD.allocationUnit() / 2);
+    json += ",\"aligned_extents\":" + String(SD.alignedExtents());
+    json += ",\"latency_max_us\":" + String(SD.writeLatencyMax());
+    json += ",\"stalls\":" + String(SD.writeStalls()) + "}";
+    json += ",\"sd_mount\":{\"fast\":" + String(SD.mountedFast() ? "true" : "false");
+    json += ",\"mount_us\":" + String(MountCache::lastMountUs());
+    json += ",\"ready_ms\":" + String(state.sdReadyUs / 1000);
+    json += ",\"snapshots\":" + String(MountCache::saveCount()) + "}";
+    json += ",\"thumbs\":{\"saved\":" + String(ThumbStore::savedCount());
+    json += ",\"backfilled\":" + String(ThumbStore::backfillCount());
+    json += ",\"store_kb\":" + String(ThumbStore::storeSize() >> 10) + "}";
+  }
   json += "}";
   
   webServer.send(200, "application/json", json);
@@ -1744,11 +2936,16 @@ void handleStatus() {
  * Serves current JPEG frame for web streaming.
  */
 void handleStream() {
+  // A live web viewer keeps the device awake
+  PowerManager::counters.webRequests++;
+  PowerManager::noteActivity();
+  
   if (buffers.jpegLen == 0 || buffers.jpegLen > Config::MAX_JPEG_SIZE) {
     webServer.send(503, "text/plain", "No frame available");
     return;
   }
   
+  PowerManager::counters.webBytesSent += buffers.jpegLen;
   webServer.sendHeader("Cache-Control", "no-cache");
   webServer.send_P(200, "image/jpeg", 
     (const char*)buffers.jpeg, 
@@ -1759,30 +2956,67 @@ void handleStream() {
 /**
  * @brief Handle photo list request
  * 
- * Returns JSON array of photo filenames.
+ * Returns JSON array of photo export names (photo_N.jpg). Served from the
+ * photo catalog when it is loaded, with optional paging (?offset=&limit=)
+ * and the total count; otherwise the /photos directory is enumerated.
  */
 void handlePhotoList() {
+  PowerManager::counters.webRequests++;
+  PowerManager::noteActivity();
+  
   if (!state.sdCardAvailable) {
     webServer.send(200, "application/json", "{\"photos\":[]}");
     return;
   }
   
   String json = "{\"photos\":[";
-  File root = SD.open("/photos");
-  bool first = true;
-  
-  File file = root.openNextFile();
-  while (file) {
-    if (!file.isDirectory()) {
-      String name = file.name();
-      if (name.endsWith(".jpg") || name.endsWith(".JPG")) {
+  StorageGuard::lock();
+  if (PhotoCatalog::isReady()) {
+    uint32_t total = PhotoCatalog::count();
+    uint32_t offset = webServer.hasArg("offset") ? webServer.arg("offset").toInt() : 0;
+    uint32_t limit = webServer.hasArg("limit") ? webServer.arg("limit").toInt() : total;
+    char name[24];
+    for (uint32_t i = offset; i < total && i - offset < limit; i++) {
+      PhotoIndex::exportName(PhotoCatalog::at(i).number, name, sizeof(name));
+      if (i != offset) json += ",";
+      json += "\"" + String(name) + "\"";
+    }
+    StorageGuard::unlock();
+    json += "],\"total\":" + String(total) + "}";
+    webServer.send(200, "application/json", json);
+    return;
+  }
+  StorageGuard::unlock();
+  
+  {
+    StorageGuard guard;
+    SliceBudget budget(true);
+    
+    File root = SD.open("/photos");
+    bool first = true;
+    char name[24];
+    uint32_t seen = PhotoIndex::dirChangeCount();
+    
+    File file = root.openNextFile();
+    while (file) {
+      uint32_t number = file.isDirectory() ? 0 : PhotoIndex::parseNumber(file.name());
+      if (number != 0) {
+        PhotoIndex::exportName(number, name, sizeof(name));
         if (!first) json += ",";
-        json += "\"" + name + "\"";
+        json += "\"" + String(name) + "\"";
         first = false;
       }
+      file.close();
+      // A save or delete while unlocked moves entries under the walk: start over
+      if (budget.yieldIfExpired() && PhotoIndex::dirChangeCount() != seen) {
+        seen = PhotoIndex::dirChangeCount();
+        root.rewindDirectory();
+        json = "{\"photos\":[";
+        first = true;
+      }
+      file = root.openNextFile();
     }
-    file.close();
-    file = root.openNextFile();
+    root.close();
   }
   
   json += "]}";
@@ -1792,24 +3026,119 @@ void handlePhotoList() {
 /**
  * @brief Handle photo download request
  * 
- * Streams requested photo file to client.
+ * Streams requested photo file to client in chunks. The SD lock is held
+ * only while reading a chunk, never while the socket write blocks, and the
+ * loop yields once per slice budget. The file stays open across those
+ * gaps, so each chunk first re-validates it (PhotoIndex::revalidate()) in
+ * case the photo was deleted meanwhile.
  */
 void handlePhoto() {
+  PowerManager::counters.webRequests++;
+  PowerManager::noteActivity();
+  
   if (!webServer.hasArg("file")) {
     webServer.send(400, "text/plain", "Missing file parameter");
     return;
   }
   
   String path = "/photos/" + webServer.arg("file");
+  uint32_t number = PhotoIndex::parseNumber(webServer.arg("file").c_str());
+  
+  // Packed photos are exported under the same name as a separate file
+  StorageGuard::lock();
+  File file;
+  uint32_t seen = PhotoIndex::dirChangeCount();
+  uint32_t packedLength = PhotoPack::length(number);
+  if (packedLength) {
+    // Read from the pack below
+  } else if (number != 0) {
+    file = PhotoIndex::open(number);
+  } else if (SD.exists(path)) {
+    file = SD.open(path, FILE_READ);
+  }
+  StorageGuard::unlock();
   
-  if (!SD.exists(path)) {
+  if (!file && !packedLength) {
     webServer.send(404, "text/plain", "Photo not found");
     return;
   }
   
-  File file = SD.open(path, FILE_READ);
-  webServer.streamFile(file, "image/jpeg");
-  file.close();
+  static uint8_t chunk[SliceConfig::CHUNK_BYTES];
+  SliceBudget budget;
+  WiFiClient client = webServer.client();
+  uint32_t sent = 0;
+  uint32_t readUs = 0;
+  
+  webServer.setContentLength(packedLength ? packedLength : file.size());
+  webServer.send(200, "image/jpeg", "");
+  
+  for (;;) {
+    StorageGuard::lock();
+    if (file && !PhotoIndex::revalidate(file, number, path.c_str(), sent, seen)) {
+      StorageGuard::unlock();
+      Serial.println("[WEB] Photo deleted during download");
+      break;
+    }
+    uint32_t start = micros();
+    int n = packedLength ? PhotoPack::read(number, sent, chunk, sizeof(chunk))
+                         : file.read(chunk, sizeof(chunk));
+    readUs += micros() - start;
+    StorageGuard::unlock();
+    
+    if (n <= 0) break;
+    sent += n;
+    PowerManager::counters.sdBytesRead += n;
+    if (client.write(chunk, n) != (size_t)n) {
+      Serial.println("[WEB] Photo download aborted by client");
+      break;
+    }
+    PowerManager::counters.webBytesSent += n;
+    budget.yieldIfExpired();
+  }
+  
+  if (file) {
+    StorageGuard::lock();
+    file.close();
+    StorageGuard::unlock();
+  }
+  
+  logReadRate("[WEB] Photo read", sent, readUs);
+}
+
+/**
+ * @brief Handle thumbnail request (?file=photo_N.jpg)
+ * 
+ * Sends the photo's thumbnail from the thumbnail store, read in one go
+ * under the SD lock. A photo without one (not yet backfilled, or no
+ * catalog) gets the full photo instead.
+ */
+void handleThumb() {
+  if (!webServer.hasArg("file")) {
+    webServer.send(400, "text/plain", "Missing file parameter");
+    return;
+  }
+  
+  static uint8_t thumb[ThumbConfig::MAX_BYTES];
+  uint32_t number = PhotoIndex::parseNumber(webServer.arg("file").c_str());
+  uint32_t length = 0;
+  
+  StorageGuard::lock();
+  int32_t i = (number != 0 && PhotoCatalog::isReady()) ? PhotoCatalog::find(number) : -1;
+  if (i >= 0 && ThumbStore::linked(PhotoCatalog::at(i).thumbOffset)) {
+    length = ThumbStore::read(PhotoCatalog::at(i).thumbOffset, number, thumb, sizeof(thumb));
+  }
+  StorageGuard::unlock();
+  
+  if (length == 0) {
+    handlePhoto();
+    return;
+  }
+  
+  PowerManager::counters.webRequests++;
+  PowerManager::noteActivity();
+  PowerManager::counters.sdBytesRead += length;
+  PowerManager::counters.webBytesSent += length;
+  webServer.send_P(200, "image/jpeg", (const char*)thumb, length);
 }
 
 /**
@@ -1818,6 +3147,43 @@ void handlePhoto() {
  * Deletes specified photo from SD card.
  */
 void handleDeletePhoto() {
+  PowerManager::counters.webRequests++;
+  PowerManager::noteActivity();
+  
+  // Bulk delete: /delete?all=1 or /delete?from=N&to=M
+  if (webServer.hasArg("all") || webServer.hasArg("from")) {
+    uint32_t from = 1;
+    uint32_t to = PhotoIndexConfig::MAX_NUMBER;
+    if (webServer.hasArg("from")) {
+      from = webServer.arg("from").toInt();
+      to = webServer.hasArg("to") ? webServer.arg("to").toInt() : from;
+    }
+    if (from == 0 || to < from) {
+      webServer.send(400, "text/plain", "Bad photo range");
+      return;
+    }
+    
+    uint32_t startMs = millis();
+    int32_t deleted;
+    {
+      StorageGuard guard;
+      deleted = deletePhotoRange(from, to);
+    }
+    state.totalPhotos = PhotoCatalog::isReady() ? PhotoCatalog::count() : countPhotosInSD();
+    if (state.currentGalleryIndex >= state.totalPhotos) {
+      state.currentGalleryIndex = state.totalPhotos > 0 ? state.totalPhotos - 1 : 0;
+    }
+    Serial.printf("[WEB] Deleted %ld photos in %lu ms\n", (long)deleted,
+                  (unsigned long)(millis() - startMs));
+    
+    if (deleted < 0) {
+      webServer.send(500, "text/plain", "Delete failed");
+    } else {
+      webServer.send(200, "text/plain", "Deleted " + String(deleted) + " photos");
+    }
+    return;
+  }
+  
   if (!webServer.hasArg("file")) {
     webServer.send(400, "text/plain", "Missing file parameter");
     return;
@@ -1825,7 +3191,24 @@ void handleDeletePhoto() {
   
   String path = "/photos/" + webServer.arg("file");
   
-  if (SD.remove(path)) {
+  bool removed;
+  {
+    StorageGuard guard;
+    uint32_t number = PhotoIndex::parseNumber(webServer.arg("file").c_str());
+    removed = PhotoPack::contains(number) ? PhotoPack::remove(number)
+            : number != 0                 ? PhotoIndex::removeFile(number)
+                                          : SD.remove(path);
+    if (removed && number == 0) PhotoIndex::noteDirChange();
+    if (removed) {
+      PhotoIndex::remove(number);
+      PhotoCatalog::remove(number);
+    }
+    if (PhotoPack::needsCompaction()) {
+      SliceExecutor::submit(&packCompactJob);
+    }
+  }
+  
+  if (removed) {
     if (state.totalPhotos > 0) {
       state.totalPhotos--;
     }
@@ -1835,6 +3218,159 @@ void handleDeletePhoto() {
   }
 }
 
+/**
+ * @brief Handle power profile request
+ * 
+ * GET /power returns the activity counters as JSON.
+ * GET /power?profile=max|balanced|battery selects a profile first.
+ */
+void handlePower() {
+  PowerManager::counters.webRequests++;
+  
+  if (webServer.hasArg("profile")) {
+    if (!PowerManager::selectByName(webServer.arg("profile").c_str())) {
+      webServer.send(400, "text/plain", "Unknown profile (max, balanced, battery)");
+      return;
+    }
+    Serial.print("[POWER] Profile selected via web: ");
+    Serial.println(webServer.arg("profile"));
+  }
+  
+  StreamString json;
+  PowerManager::printJson(json);
+  webServer.send(200, "application/json", json);
+}
+
+/**
+ * @brief Handle sync policy request
+ * 
+ * GET /sync?policy=write|close|deferred selects the SD durability level.
+ * GET /sync returns the metadata writes made under the current policy and
+ * their average per saved photo as JSON. Under deferred, writes still held
+ * in the cache are counted once the periodic flush has run.
+ */
+void handleSync() {
+  PowerManager::counters.webRequests++;
+  static const char* const names[] = { "write", "close", "deferred" };
+  
+  if (webServer.hasArg("policy")) {
+    String want = webServer.arg("policy");
+    uint8_t policy = 0;
+    while (policy <= SD_SYNC_DEFERRED && want != names[policy]) policy++;
+    bool ok;
+    {
+      StorageGuard guard;
+      ok = policy <= SD_SYNC_DEFERRED && selectSyncPolicy(policy);
+    }
+    if (!ok) {
+      webServer.send(400, "text/plain", "Unknown policy (write, close, deferred)");
+      return;
+    }
+    Serial.print("[SD] Sync policy selected via web: ");
+    Serial.println(want);
+  }
+  
+  const SyncAccounting& base = syncAccounting;
+  uint32_t fat = SD.fatWrites() - base.fatWrites;
+  uint32_t mirror = SD.fatMirrorWrites() - base.mirrorWrites;
+  uint32_t dir = SD.dirWrites() - base.dirWrites;
+  uint32_t photos = base.photos;
+  
+  String json = "{\"policy\":\"" + String(names[SD.syncPolicy()]) + "\"";
+  json += ",\"photos\":" + String(photos);
+  json += ",\"fat_writes\":" + String(fat);
+  json += ",\"mirror_writes\":" + String(mirror);
+  json += ",\"dir_writes\":" + String(dir);
+  json += ",\"entry_updates\":" + String(SD.entryUpdates() - base.entryUpdates);
+  json += ",\"syncs\":" + String(SD.syncCount() - base.syncs);
+  json += ",\"deferred_syncs\":" + String(SD.deferredSyncCount() - base.deferredSyncs);
+  json += ",\"meta_writes_per_photo\":";
+  json += photos ? String((float)(fat + mirror + dir) / photos, 2) : String("null");
+  json += ",\"pending\":" + String(SD.syncPending() ? "true" : "false");
+  json += ",\"flush_failures\":" + String(sdSyncJob.failures) + "}";
+  webServer.send(200, "application/json", json);
+}
+
+/**
+ * @brief Handle burst request
+ * 
+ * GET /burst?n=<frames> starts a burst (camera mode only).
+ * GET /burst returns the last burst result and ring capacity as JSON.
+ */
+void handleBurst() {
+  PowerManager::counters.webRequests++;
+  
+  if (webServer.hasArg("n")) {
+    PowerManager::noteActivity();
+    long frames = webServer.arg("n").toInt();
+    if (frames <= 0) frames = BurstConfig::DEFAULT_FRAMES;
+    if (frames > 65535) frames = 65535;
+    state.webBurstRequested = (uint16_t)frames;
+    webServer.send(200, "text/plain", "OK");
+    return;
+  }
+  
+  const BurstStats& last = state.lastBurst;
+  uint32_t fps = last.fpsX10();
+  
+  String json = "{";
+  json += "\"ring_slots\":" + String(BurstRing::size()) + ",";
+  json += "\"slot_bytes\":" + String(BurstConfig::SLOT_BYTES) + ",";
+  json += "\"psram_free\":" + String(ESP.getFreePsram()) + ",";
+  json += "\"pending\":" + String(BurstRing::used()) + ",";
+  json += "\"flushed\":" + String(burstFlush.flushed) + ",";
+  json += "\"flush_failed\":" + String(burstFlush.failed) + ",";
+  json += "\"async_queued\":" + String(AsyncWriter::queued()) + ",";
+  json += "\"async_busy_yields\":" + String(AsyncWriter::busyYieldCount()) + ",";
+  json += "\"last_requested\":" + String(last.requested) + ",";
+  json += "\"last_captured\":" + String(last.captured) + ",";
+  json += "\"last_ms\":" + String(last.durationMs) + ",";
+  json += "\"last_fps\":" + String(fps / 10) + "." + String(fps % 10) + ",";
+  json += "\"last_ring_full\":" + String(last.ringFull ? "true" : "false");
+  json += "}";
+  
+  webServer.send(200, "application/json", json);
+}
+
+/**
+ * @brief Handle time-lapse request
+ * 
+ * GET /timelapse?interval=<ms>&count=<n> starts a session (count 0 = until
+ * stopped), /timelapse?stop=1 ends it, and /timelapse alone returns the
+ * current or last session's jitter and wake latency as JSON.
+ */
+void handleTimelapse() {
+  PowerManager::counters.webRequests++;
+  
+  if (webServer.hasArg("stop")) {
+    state.webTimelapseStop = true;
+    webServer.send(200, "text/plain", "OK");
+    return;
+  }
+  
+  if (webServer.hasArg("interval")) {
+    long interval = webServer.arg("interval").toInt();
+    long count = webServer.hasArg("count") ? webServer.arg("count").toInt() : 0;
+    if (interval <= 0) interval = TimelapseConfig::DEFAULT_INTERVAL_MS;
+    if (count < 0) count = 0;
+    state.webTimelapseInterval = interval;
+    state.webTimelapseCount = count;
+    state.webTimelapseStart = true;
+    webServer.send(200, "text/plain", "OK");
+    return;
+  }
+  
+  StreamString json;
+  json.print("{\"active\":");
+  json.print(timelapse.active() ? "true" : "false");
+  json.print(",\"interval_ms\":");
+  json.print(timelapse.intervalMs());
+  json.print(",\"stats\":");
+  timelapse.stats.printJson(json);
+  json.print("}");
+  webServer.send(200, "application/json", json);
+}
+
 // JPEG DECODER CALLBACK
 
 /**
@@ -0,0 +1,26 @@
+/**
+ * @file task_profile.h
+ * @brief Measured task stack peaks (generated by the task profiler)
+ *
+ * Values come from the "[PROFILE]" report printed when the firmware is
+ * built with TASK_PROFILING set to 1. A value of 0 means not yet measured.
+ * stitch_cam_v5.ino refuses to build if a TaskConfig stack size is smaller
+ * than the peak recorded here plus ProfileConfig::STACK_MARGIN_MIN.
+ *
+ * No board run has been recorded yet, so every peak is 0 and those checks
+ * are skipped; with TASK_PROFILE_MEASURED 0 a TASK_PROFILING build says so.
+ */
+
+#ifndef TASK_PROFILE_H
+#define TASK_PROFILE_H
+
+#include <stdint.h>
+
+#define TASK_PROFILE_MEASURED 0
+namespace TaskProfile {
+  constexpr uint32_t CAMERA_STACK_PEAK  = 0;
+  constexpr uint32_t WEB_STACK_PEAK     = 0;
+  constexpr uint32_t STORAGE_STACK_PEAK = 0;
+}
+
+#endif // TASK_PROFILE_H
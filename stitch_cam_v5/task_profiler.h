@@ -0,0 +1,209 @@
+/**
+ * @file task_profiler.h
+ * @brief Stack high-water and CPU time profiling for the FreeRTOS tasks
+ *
+ * Build with TASK_PROFILING set to 1 to run the standard workload at boot
+ * (see profilerTask() in stitch_cam_v5.ino). While it runs, every
+ * registered task's stack high-water mark is sampled and each task reports
+ * its busy time. The report ends with a task_profile.h body holding the
+ * measured peaks and a recommended TaskConfig block with safety margins.
+ */
+
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include <Arduino.h>
+
+#ifndef TASK_PROFILING
+#define TASK_PROFILING 0
+#endif
+
+//=============================================================================
+// PROFILER CONFIGURATION
+//=============================================================================
+namespace ProfileConfig {
+  constexpr bool     ENABLED          = TASK_PROFILING;
+  constexpr uint32_t SAMPLE_MS        = 50;    // High-water sampling period
+  constexpr uint32_t STACK_SIZE       = 4096;  // Profiler task stack
+
+  // Recommended stack = peak + max(peak * MARGIN_PCT%, MARGIN_MIN), rounded
+  constexpr uint32_t STACK_MARGIN_PCT = 25;
+  constexpr uint32_t STACK_MARGIN_MIN = 1024;
+  constexpr uint32_t STACK_ROUND      = 512;
+  constexpr uint32_t STACK_MIN        = 2048;
+
+  constexpr uint32_t stackMargin(uint32_t peak) {
+    return peak * STACK_MARGIN_PCT / 100 > STACK_MARGIN_MIN
+         ? peak * STACK_MARGIN_PCT / 100 : STACK_MARGIN_MIN;
+  }
+
+  constexpr uint32_t roundStack(uint32_t bytes) {
+    return (bytes + STACK_ROUND - 1) / STACK_ROUND * STACK_ROUND;
+  }
+
+  /**
+   * @brief Stack size to configure for a measured peak
+   * @param peak Measured peak stack use in bytes (0 = not measured)
+   */
+  constexpr uint32_t recommendedStack(uint32_t peak) {
+    return peak == 0 ? 0
+         : roundStack(peak + stackMargin(peak)) < STACK_MIN ? STACK_MIN
+         : roundStack(peak + stackMargin(peak));
+  }
+
+  /**
+   * @brief Build-time check: configured stack covers the measured peak
+   *        plus the minimum margin (always true while peak is unmeasured)
+   */
+  constexpr bool stackFits(uint32_t configured, uint32_t peak) {
+    return peak == 0 || configured >= peak + STACK_MARGIN_MIN;
+  }
+}
+
+//=============================================================================
+// TASK PROFILER
+//=============================================================================
+
+/**
+ * @brief Slots for the tasks the firmware creates
+ */
+enum class ProfiledTask : uint8_t {
+  CAMERA,
+  WEB,       // Arduino loopTask (web server)
+  STORAGE,   // Slice executor
+  COUNT
+};
+
+class TaskProfiler {
+public:
+  /**
+   * @brief Register a task for sampling
+   *
+   * @param slot Task slot
+   * @param name Name used in the report and the generated constants
+   * @param handle FreeRTOS task handle
+   * @param stackSize Configured stack size in bytes
+   */
+  static void registerTask(ProfiledTask slot, const char* name,
+                           TaskHandle_t handle, uint32_t stackSize) {
+    if (!ProfileConfig::ENABLED || handle == NULL) return;
+    Entry& e = entries[(uint8_t)slot];
+    e.name = name;
+    e.handle = handle;
+    e.stackSize = stackSize;
+    e.minFree = stackSize;
+    e.busyUs = 0;
+  }
+
+  /**
+   * @brief Account busy (non-blocked) time to a task
+   *
+   * Tasks call this around their work so CPU time is known even when the
+   * core is built without FreeRTOS run-time stats.
+   */
+  static inline void addBusy(ProfiledTask slot, uint32_t us) {
+    if (ProfileConfig::ENABLED) entries[(uint8_t)slot].busyUs += us;
+  }
+
+  /** @brief Sample stack high-water marks of all registered tasks */
+  static void sample() {
+    for (uint8_t i = 0; i < (uint8_t)ProfiledTask::COUNT; i++) {
+      Entry& e = entries[i];
+      if (e.handle == NULL) continue;
+      // ESP-IDF reports the high-water mark in bytes
+      uint32_t freeBytes = uxTaskGetStackHighWaterMark(e.handle);
+      if (freeBytes < e.minFree) e.minFree = freeBytes;
+    }
+  }
+
+  /** @brief Reset counters at the start of the workload window */
+  static void startWindow() {
+    windowStart = millis();
+    for (uint8_t i = 0; i < (uint8_t)ProfiledTask::COUNT; i++) {
+      entries[i].busyUs = 0;
+    }
+  }
+
+  /**
+   * @brief Sample repeatedly for a while (used between workload phases)
+   * @param ms Duration in milliseconds
+   */
+  static void sampleFor(uint32_t ms) {
+    uint32_t start = millis();
+    while (millis() - start < ms) {
+      sample();
+      vTaskDelay(pdMS_TO_TICKS(ProfileConfig::SAMPLE_MS));
+    }
+  }
+
+  /**
+   * @brief Peak stack use of a task in bytes (0 if not registered)
+   */
+  static uint32_t peakStack(ProfiledTask slot) {
+    const Entry& e = entries[(uint8_t)slot];
+    return e.handle == NULL ? 0 : e.stackSize - e.minFree;
+  }
+
+  /**
+   * @brief Print the profile and the generated task_profile.h body
+   */
+  static void printReport() {
+    uint32_t windowMs = millis() - windowStart;
+    if (windowMs == 0) windowMs = 1;
+
+    Serial.println("\n[PROFILE] ===== Task profile =====");
+    Serial.printf("[PROFILE] Workload window: %lu ms\n", (unsigned long)windowMs);
+    Serial.println("[PROFILE] Task          Stack   Peak    Free   CPU%");
+    for (uint8_t i = 0; i < (uint8_t)ProfiledTask::COUNT; i++) {
+      const Entry& e = entries[i];
+      if (e.handle == NULL) continue;
+      uint32_t cpuPermille = (uint32_t)(e.busyUs / windowMs);
+      Serial.printf("[PROFILE] %-12s %6lu %6lu %6lu  %2lu.%lu\n",
+                    e.name, (unsigned long)e.stackSize,
+                    (unsigned long)(e.stackSize - e.minFree),
+                    (unsigned long)e.minFree,
+                    (unsigned long)(cpuPermille / 10),
+                    (unsigned long)(cpuPermille % 10));
+    }
+
+    Serial.println("\n[PROFILE] ---- Measured peaks (replace the body of task_profile.h) ----");
+    Serial.println("#define TASK_PROFILE_MEASURED 1");
+    Serial.println("namespace TaskProfile {");
+    for (uint8_t i = 0; i < (uint8_t)ProfiledTask::COUNT; i++) {
+      const Entry& e = entries[i];
+      if (e.handle == NULL) continue;
+      Serial.printf("  constexpr uint32_t %s_STACK_PEAK = %lu;\n",
+                    e.name, (unsigned long)(e.stackSize - e.minFree));
+    }
+    Serial.println("}");
+
+    Serial.println("\n[PROFILE] ---- Recommended TaskConfig stack sizes ----");
+    for (uint8_t i = 0; i < (uint8_t)ProfiledTask::COUNT; i++) {
+      const Entry& e = entries[i];
+      if (e.handle == NULL) continue;
+      Serial.printf("  constexpr uint32_t %s_STACK_SIZE = %lu;  // now %lu\n",
+                    e.name,
+                    (unsigned long)ProfileConfig::recommendedStack(e.stackSize - e.minFree),
+                    (unsigned long)e.stackSize);
+    }
+    Serial.println("[PROFILE] =============================\n");
+  }
+
+private:
+  struct Entry {
+    const char* name = NULL;
+    TaskHandle_t handle = NULL;
+    uint32_t stackSize = 0;
+    uint32_t minFree = 0;
+    uint64_t busyUs = 0;
+  };
+
+  static Entry entries[(uint8_t)ProfiledTask::COUNT];
+  static uint32_t windowStart;
+};
+
+// Static member initialization
+TaskProfiler::Entry TaskProfiler::entries[(uint8_t)ProfiledTask::COUNT];
+uint32_t TaskProfiler::windowStart = 0;
+
+#endif // TASK_PROFILER_H
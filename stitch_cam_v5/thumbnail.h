@@ -0,0 +1,454 @@
+/**
+ * @file thumbnail.h
+ * @brief Photo thumbnails made at save time, kept in one store file
+ *
+ * The web gallery used to fetch every full-size photo to show its grid.
+ * Each photo now gets a small JPEG (80x60 for the 320x240 camera) when it
+ * is saved: the decoder scales by 1/2^k while it runs the IDCT, so the
+ * photo is never decoded at full size, and fmt2jpg encodes the result. A
+ * grid entry then costs a few KB of card reads instead of the whole photo.
+ *
+ * Thumbnails are appended to one file instead of a file each, so they
+ * cost no directory entries; the catalog record's thumbOffset points at
+ * the thumbnail's header:
+ *
+ *   [ThumbHeader 32 B]           file header, number 0
+ *   [ThumbHeader 32 B][JPEG ...] thumbnail of photo number
+ *   ...
+ *
+ * The header repeats the photo's size and first cluster, so after the
+ * catalog is rebuilt from a directory scan (which knows nothing of
+ * thumbnails) ThumbBackfillJob relinks each photo to its thumbnail, and
+ * never to that of an earlier photo with the same number. It then makes
+ * the thumbnails still missing: burst frames, and photos saved before
+ * this existed. Thumbnails of deleted photos stay in the file until the
+ * last photo is deleted and the file is emptied.
+ *
+ * make() only uses the heap and may run without the StorageGuard; every
+ * other call needs it.
+ */
+
+#ifndef THUMBNAIL_H
+#define THUMBNAIL_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <tjpgd.h>
+#include "img_converters.h"
+#include "slice_executor.h"
+#include "photo_catalog.h"
+#include "photo_pack.h"
+#include "photo_index.h"
+
+//=============================================================================
+// THUMBNAIL CONFIGURATION
+//=============================================================================
+namespace ThumbConfig {
+  const char* const  FILE_PATH          = "/thumbs.dat";
+  constexpr uint16_t WIDTH              = 80;          // Smallest thumbnail width
+  constexpr uint8_t  QUALITY            = 60;          // fmt2jpg quality (1-100)
+  constexpr uint32_t MAX_BYTES          = 8192;        // Larger thumbnails are dropped
+  constexpr uint32_t MAGIC              = 0x424D4854;  // "THMB"
+  constexpr uint32_t NONE               = 1;           // thumbOffset of a photo that cannot be decoded
+  constexpr uint32_t BACKFILL_PERIOD_MS = 10000;       // Backfill check while idle
+}
+
+//=============================================================================
+// FORMAT
+//=============================================================================
+
+struct ThumbHeader {
+  uint32_t magic;
+  uint32_t number;        // Photo number N, 0 in the file header
+  uint32_t photoSize;     // Catalog size and first cluster of the photo
+  uint32_t photoCluster;
+  uint32_t length;        // JPEG bytes after the header
+  uint32_t dataCrc;       // CRC-32 of the JPEG bytes
+  uint32_t reserved;
+  uint32_t crc;           // CRC-32 of the fields above
+};
+
+static_assert(sizeof(ThumbHeader) == 32, "thumbnail headers must be 32 bytes");
+
+//=============================================================================
+// BACKFILL JOB
+//=============================================================================
+
+/**
+ * @brief Relinks thumbnails after a catalog rebuild, then makes missing ones
+ *
+ * One photo is read per slice budget chunk; it is decoded with the
+ * StorageGuard released, and one thumbnail is made per step.
+ */
+class ThumbBackfillJob : public SliceJob {
+public:
+  bool step(SliceBudget& budget) override;
+  void finish() override;
+
+  volatile uint32_t made = 0;
+
+private:
+  enum Phase : uint8_t { PICK, READ, MAKE };
+
+  bool relinkStep(SliceBudget& budget);
+  void release();
+
+  Phase phase = PICK;
+  uint32_t lastNumber = 0;     // Photos up to this one were visited this run
+  uint32_t number = 0;
+  uint32_t size = 0;
+  uint32_t cluster = 0;
+  uint32_t got = 0;
+  uint8_t* photo = NULL;
+  File file;
+  bool packed = false;
+  uint32_t relinkOffset = 0;
+  uint32_t relinked = 0;
+  uint32_t runMade = 0;
+};
+
+//=============================================================================
+// THUMBNAIL STORE
+//=============================================================================
+
+class ThumbStore {
+public:
+  /**
+   * @brief Open the store, creating it if missing or damaged
+   */
+  static bool begin() {
+    file = SD.open(ThumbConfig::FILE_PATH, O_READ | O_WRITE | O_CREAT);
+    if (!file) return false;
+
+    ThumbHeader h;
+    if (readHeader(0, h) && h.number == 0) {
+      storeBytes = file.size();
+    } else if (!reset()) {
+      file.close();
+      return false;
+    }
+    Serial.printf("[THUMB] Store %lu KB\n", (unsigned long)(storeBytes >> 10));
+    return true;
+  }
+
+  static bool isOpen() { return (bool)file; }
+
+  /**
+   * @brief Make a thumbnail of a JPEG
+   *
+   * Decodes at the largest 1/2^k scale (k <= 3) that keeps the width at
+   * least WIDTH, then encodes at QUALITY. Needs no StorageGuard.
+   *
+   * @param jpeg Photo JPEG data
+   * @param length Photo length in bytes
+   * @param out Thumbnail JPEG, malloc'd; the caller frees it
+   * @param outLen Thumbnail length in bytes
+   * @return false if the photo could not be decoded or the thumbnail is
+   *         larger than MAX_BYTES
+   */
+  static bool make(const uint8_t* jpeg, uint32_t length, uint8_t** out, size_t* outLen) {
+    *out = NULL;
+    *outLen = 0;
+
+    Decode dec = {};
+    dec.data = jpeg;
+    dec.length = length;
+    void* work = malloc(TJPGD_WORKSPACE_SIZE);
+    if (work == NULL) return false;
+
+    JDEC jd;
+    jd.swap = 1;  // Big-endian RGB565, as fmt2jpg reads it
+    bool ok = jd_prepare(&jd, input, work, TJPGD_WORKSPACE_SIZE, &dec) == JDR_OK;
+    if (ok) {
+      uint8_t scale = 0;
+      while (scale < 3 && (jd.width >> (scale + 1)) >= ThumbConfig::WIDTH) scale++;
+      dec.width = jd.width >> scale;
+      dec.height = jd.height >> scale;
+      size_t bytes = (size_t)dec.width * dec.height * 2;
+      dec.pixels = bytes ? (uint16_t*)malloc(bytes) : NULL;
+      ok = dec.pixels != NULL &&
+           jd_decomp(&jd, output, scale) == JDR_OK &&
+           fmt2jpg((uint8_t*)dec.pixels, bytes, dec.width, dec.height,
+                   PIXFORMAT_RGB565, ThumbConfig::QUALITY, out, outLen);
+    }
+    free(dec.pixels);
+    free(work);
+
+    if (ok && *outLen > ThumbConfig::MAX_BYTES) {
+      free(*out);
+      *out = NULL;
+      *outLen = 0;
+      ok = false;
+    }
+    return ok;
+  }
+
+  /**
+   * @brief Append a thumbnail to the store
+   *
+   * @param number Photo number N
+   * @param photoSize Photo size as cataloged
+   * @param photoCluster Photo first cluster as cataloged (0 when packed)
+   * @param thumb Thumbnail JPEG from make(), or NULL
+   * @param length Thumbnail length in bytes
+   * @return thumbOffset for the catalog, 0 if nothing was stored
+   */
+  static uint32_t append(uint32_t number, uint32_t photoSize, uint32_t photoCluster,
+                         const uint8_t* thumb, size_t length) {
+    if (!file || thumb == NULL || length == 0) return 0;
+
+    ThumbHeader h = {};
+    h.magic = ThumbConfig::MAGIC;
+    h.number = number;
+    h.photoSize = photoSize;
+    h.photoCluster = photoCluster;
+    h.length = length;
+    h.dataCrc = crc32(thumb, length);
+    h.crc = crc32((const uint8_t*)&h, offsetof(ThumbHeader, crc));
+
+    uint32_t offset = storeBytes;
+    bool ok = file.seek(offset) &&
+              file.write((const uint8_t*)&h, sizeof(h)) == sizeof(h) &&
+              file.write(thumb, length) == length;
+    if (!ok) {
+      // Drop a partial record so the next one starts where this one did
+      file.truncate(offset);
+      return 0;
+    }
+    // Size on the card before a catalog record points past the old end
+    file.flush();
+    storeBytes = offset + sizeof(h) + length;
+    return offset;
+  }
+
+  /**
+   * @brief Read the thumbnail at thumbOffset if it belongs to photo number
+   *
+   * @return Thumbnail length, 0 if there is none or it is damaged
+   */
+  static uint32_t read(uint32_t offset, uint32_t number, uint8_t* dst, uint32_t max) {
+    ThumbHeader h;
+    if (!readHeader(offset, h) || h.number != number || h.length > max) return 0;
+    if (file.read(dst, h.length) != (int)h.length) return 0;
+    return crc32(dst, h.length) == h.dataCrc ? h.length : 0;
+  }
+
+  /** @brief true for a catalog thumbOffset that points into the store */
+  static bool linked(uint32_t thumbOffset) {
+    return thumbOffset >= sizeof(ThumbHeader);
+  }
+
+  /** @brief Relink thumbnails on the next backfill (catalog rebuilt) */
+  static void relink() { relinkPending = true; }
+
+  /** @brief Queue the backfill job (loop(), while the card is idle) */
+  static void backfill() { SliceExecutor::submit(&job); }
+
+  static uint32_t storeSize() { return storeBytes; }
+  static uint32_t backfillCount() { return job.made; }
+
+  /** @brief Thumbnails made at save time */
+  static uint32_t savedCount() { return saved; }
+  static void noteSaved() { saved++; }
+
+private:
+  friend class ThumbBackfillJob;
+
+  /** @brief Decoder input and output of one make() call */
+  struct Decode {
+    const uint8_t* data;
+    uint32_t length;
+    uint32_t pos;
+    uint16_t* pixels;
+    uint16_t width;
+    uint16_t height;
+  };
+
+  static size_t input(JDEC* jd, uint8_t* buf, size_t len) {
+    Decode* dec = (Decode*)jd->device;
+    if (len > dec->length - dec->pos) len = dec->length - dec->pos;
+    if (buf) memcpy(buf, dec->data + dec->pos, len);
+    dec->pos += len;
+    return len;
+  }
+
+  static int output(JDEC* jd, void* bitmap, JRECT* rect) {
+    Decode* dec = (Decode*)jd->device;
+    const uint16_t* src = (const uint16_t*)bitmap;
+    uint16_t w = rect->right - rect->left + 1;
+    for (uint16_t y = rect->top; y <= rect->bottom; y++, src += w) {
+      if (y >= dec->height) break;
+      for (uint16_t x = 0; x < w && rect->left + x < dec->width; x++) {
+        dec->pixels[y * dec->width + rect->left + x] = src[x];
+      }
+    }
+    return 1;
+  }
+
+  static bool readHeader(uint32_t offset, ThumbHeader& h) {
+    if (!file || !file.seek(offset) ||
+        file.read(&h, sizeof(h)) != sizeof(h)) return false;
+    return h.magic == ThumbConfig::MAGIC &&
+           h.crc == crc32((const uint8_t*)&h, offsetof(ThumbHeader, crc)) &&
+           offset + sizeof(h) + h.length <= file.size();
+  }
+
+  /** @brief Empty the store down to its file header */
+  static bool reset() {
+    ThumbHeader h = {};
+    h.magic = ThumbConfig::MAGIC;
+    h.crc = crc32((const uint8_t*)&h, offsetof(ThumbHeader, crc));
+    bool ok = file.truncate(0) && file.seek(0) &&
+              file.write((const uint8_t*)&h, sizeof(h)) == sizeof(h);
+    file.flush();
+    storeBytes = ok ? sizeof(h) : 0;
+    return ok;
+  }
+
+  static uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--) {
+      crc ^= *data++;
+      for (uint8_t b = 0; b < 8; b++) {
+        crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+      }
+    }
+    return ~crc;
+  }
+
+  static File file;
+  static uint32_t storeBytes;
+  static uint32_t saved;
+  static bool relinkPending;
+  static ThumbBackfillJob job;
+};
+
+//=============================================================================
+// BACKFILL JOB IMPLEMENTATION
+//=============================================================================
+
+inline bool ThumbBackfillJob::step(SliceBudget& budget) {
+  if (!ThumbStore::isOpen()) return true;
+  if (ThumbStore::relinkPending) return relinkStep(budget);
+
+  // Nothing left to show: start the store over
+  if (phase == PICK && PhotoCatalog::count() == 0 &&
+      ThumbStore::storeBytes > sizeof(ThumbHeader)) {
+    ThumbStore::reset();
+  }
+
+  while (!budget.expired()) {
+    if (phase == PICK) {
+      uint32_t i = 0;
+      uint32_t total = PhotoCatalog::count();
+      while (i < total && (PhotoCatalog::at(i).number <= lastNumber ||
+                           PhotoCatalog::at(i).thumbOffset != 0)) i++;
+      if (i == total) {
+        lastNumber = 0;
+        return true;
+      }
+      const CatalogRecord& rec = PhotoCatalog::at(i);
+      number = rec.number;
+      size = rec.size;
+      cluster = rec.firstCluster;
+      lastNumber = number;
+      got = 0;
+      packed = PhotoPack::length(number) != 0;
+      if (!packed) file = PhotoIndex::open(number);
+      photo = (packed || file) ? (uint8_t*)ps_malloc(size) : NULL;
+      if (photo == NULL) {
+        release();
+        continue;
+      }
+      phase = READ;
+    } else if (phase == READ) {
+      uint32_t want = size - got;
+      if (want > SliceConfig::DIRECT_CHUNK_BYTES) want = SliceConfig::DIRECT_CHUNK_BYTES;
+      int n = packed ? PhotoPack::read(number, got, photo + got, want)
+                     : file.read(photo + got, want);
+      if (n <= 0) {
+        release();
+        continue;
+      }
+      got += n;
+      if (got == size) {
+        if (file) file.close();
+        phase = MAKE;
+        return false;  // Decode in a step of its own
+      }
+    } else {
+      // The decoder does not touch the card; let other tasks have it
+      uint8_t* thumb;
+      size_t length;
+      StorageGuard::unlock();
+      bool ok = ThumbStore::make(photo, size, &thumb, &length);
+      StorageGuard::lock();
+
+      // Skip a photo deleted or replaced while the lock was released
+      int32_t i = PhotoCatalog::find(number);
+      if (i >= 0 && PhotoCatalog::at(i).size == size &&
+          PhotoCatalog::at(i).firstCluster == cluster &&
+          PhotoCatalog::at(i).thumbOffset == 0) {
+        uint32_t offset = ok ? ThumbStore::append(number, size, cluster, thumb, length)
+                             : ThumbConfig::NONE;
+        if (offset != 0 && PhotoCatalog::setThumb(number, offset) && ok) {
+          made++;
+          runMade++;
+        }
+      }
+      free(thumb);
+      release();
+      return false;
+    }
+  }
+  return false;
+}
+
+/** @brief Walk the store headers, linking each photo to its thumbnail */
+inline bool ThumbBackfillJob::relinkStep(SliceBudget& budget) {
+  if (relinkOffset == 0) relinkOffset = sizeof(ThumbHeader);
+  while (!budget.expired()) {
+    ThumbHeader h;
+    if (relinkOffset >= ThumbStore::storeBytes ||
+        !ThumbStore::readHeader(relinkOffset, h)) {
+      Serial.printf("[THUMB] Relinked %lu thumbnails\n", (unsigned long)relinked);
+      ThumbStore::relinkPending = false;
+      relinkOffset = 0;
+      relinked = 0;
+      return false;  // Backfill what is still missing
+    }
+    int32_t i = PhotoCatalog::find(h.number);
+    if (i >= 0 && PhotoCatalog::at(i).thumbOffset == 0 &&
+        PhotoCatalog::at(i).size == h.photoSize &&
+        PhotoCatalog::at(i).firstCluster == h.photoCluster &&
+        PhotoCatalog::setThumb(h.number, relinkOffset)) {
+      relinked++;
+    }
+    relinkOffset += sizeof(h) + h.length;
+  }
+  return false;
+}
+
+inline void ThumbBackfillJob::release() {
+  if (file) file.close();
+  free(photo);
+  photo = NULL;
+  phase = PICK;
+}
+
+inline void ThumbBackfillJob::finish() {
+  if (runMade) {
+    Serial.printf("[THUMB] Backfilled %lu thumbnails, store %lu KB\n",
+                  (unsigned long)runMade, (unsigned long)(ThumbStore::storeBytes >> 10));
+  }
+  runMade = 0;
+}
+
+// Static member initialization
+File ThumbStore::file;
+uint32_t ThumbStore::storeBytes = 0;
+uint32_t ThumbStore::saved = 0;
+bool ThumbStore::relinkPending = false;
+ThumbBackfillJob ThumbStore::job;
+
+#endif // THUMBNAIL_H
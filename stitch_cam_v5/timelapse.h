@@ -0,0 +1,174 @@
+/**
+ * @file timelapse.h
+ * @brief Interval capture schedule and timing statistics
+ *
+ * TimelapseSession only does the bookkeeping: when to wake the sensor,
+ * when the next shot is due, and how far each shot landed from its slot.
+ * The camera task (serviceTimelapse() in stitch_cam_v5.ino) drives the
+ * hardware: sensor standby, LCD sleep, capture and the SD append.
+ *
+ * Shots are scheduled on a fixed grid (start + k * interval), so capture
+ * time never accumulates drift; slots missed because a shot overran are
+ * skipped and counted.
+ */
+
+#ifndef TIMELAPSE_H
+#define TIMELAPSE_H
+
+#include <Arduino.h>
+
+//=============================================================================
+// TIME-LAPSE CONFIGURATION
+//=============================================================================
+namespace TimelapseConfig {
+  constexpr uint32_t DEFAULT_INTERVAL_MS = 5000;
+  constexpr uint32_t MIN_INTERVAL_MS     = 200;
+  constexpr uint32_t INITIAL_LEAD_MS     = 250;   // Wake lead before the first shot
+  constexpr uint32_t LEAD_MARGIN_MS      = 30;    // Added to the worst wake latency seen
+  constexpr uint32_t MAX_LEAD_MS         = 1000;
+  constexpr uint32_t MAX_SLEEP_SLICE_MS  = 100;   // Sleep granularity (stop button response)
+  constexpr uint8_t  WARMUP_FRAMES       = 1;     // Frames dropped after sensor wake
+  const char* const  DIR                 = "/tlapse";
+}
+
+//=============================================================================
+// STATISTICS
+//=============================================================================
+
+/**
+ * @brief Interval jitter and wake latency of a session
+ */
+struct TimelapseStats {
+  uint32_t shots = 0;
+  uint32_t skipped = 0;          // Slots missed because a shot overran
+  uint32_t failed = 0;           // Capture or SD errors
+  uint32_t bytes = 0;
+  int32_t  jitterMinMs = 0;      // Actual minus scheduled capture start
+  int32_t  jitterMaxMs = 0;
+  int64_t  jitterSumMs = 0;
+  uint32_t wakeCount = 0;
+  uint32_t wakeMaxMs = 0;        // Sensor wake to ready (warm-up dropped)
+  uint32_t wakeSumMs = 0;
+
+  void addJitter(int32_t ms) {
+    if (shots == 0 || ms < jitterMinMs) jitterMinMs = ms;
+    if (shots == 0 || ms > jitterMaxMs) jitterMaxMs = ms;
+    jitterSumMs += ms;
+  }
+
+  void addWake(uint32_t ms) {
+    wakeCount++;
+    wakeSumMs += ms;
+    if (ms > wakeMaxMs) wakeMaxMs = ms;
+  }
+
+  void printJson(Print& out) const {
+    out.printf("{\"shots\":%lu,\"skipped\":%lu,\"failed\":%lu,\"bytes\":%lu,",
+               (unsigned long)shots, (unsigned long)skipped,
+               (unsigned long)failed, (unsigned long)bytes);
+    out.printf("\"jitter_ms\":{\"min\":%ld,\"max\":%ld,\"avg\":%ld},",
+               (long)jitterMinMs, (long)jitterMaxMs,
+               (long)(shots ? jitterSumMs / (int64_t)shots : 0));
+    out.printf("\"wake_to_ready_ms\":{\"max\":%lu,\"avg\":%lu,\"count\":%lu}}",
+               (unsigned long)wakeMaxMs,
+               (unsigned long)(wakeCount ? wakeSumMs / wakeCount : 0),
+               (unsigned long)wakeCount);
+  }
+};
+
+//=============================================================================
+// SESSION SCHEDULE
+//=============================================================================
+
+class TimelapseSession {
+public:
+  /**
+   * @brief Start a session; the first shot is due one lead time from now
+   *
+   * @param now Current time (millis)
+   * @param intervalMs Time between shots
+   * @param count Number of shots (0 = until stopped)
+   */
+  void start(uint32_t now, uint32_t intervalMs, uint32_t count) {
+    if (intervalMs < TimelapseConfig::MIN_INTERVAL_MS) {
+      intervalMs = TimelapseConfig::MIN_INTERVAL_MS;
+    }
+    interval = intervalMs;
+    remaining = count;
+    unlimited = (count == 0);
+    leadMs = TimelapseConfig::INITIAL_LEAD_MS;
+    nextShot = now + leadMs;
+    stats = TimelapseStats();
+    running = true;
+  }
+
+  void stop() { running = false; }
+  bool active() const { return running; }
+
+  uint32_t intervalMs() const { return interval; }
+  uint32_t dueAt() const { return nextShot; }
+
+  /** @brief Time to wake the sensor so it is ready when the shot is due */
+  uint32_t wakeAt() const { return nextShot - leadMs; }
+
+  /**
+   * @brief true if sleeping between shots is worth it
+   *
+   * With short intervals the wake lead would eat the whole gap, so the
+   * sensor simply stays on.
+   */
+  bool sleepBetweenShots() const {
+    return interval > leadMs + TimelapseConfig::LEAD_MARGIN_MS;
+  }
+
+  /**
+   * @brief Record a wake-to-ready latency and adapt the wake lead to it
+   */
+  void onWake(uint32_t latencyMs) {
+    stats.addWake(latencyMs);
+    uint32_t lead = stats.wakeMaxMs + TimelapseConfig::LEAD_MARGIN_MS;
+    leadMs = lead < TimelapseConfig::MAX_LEAD_MS ? lead : TimelapseConfig::MAX_LEAD_MS;
+  }
+
+  /**
+   * @brief Record a shot and schedule the next one
+   *
+   * @param startedAt Capture start time (millis)
+   * @param finishedAt Time the frame was stored (millis)
+   * @param ok false if capture or write failed
+   * @param bytes Bytes appended
+   */
+  void onShot(uint32_t startedAt, uint32_t finishedAt, bool ok, uint32_t bytes) {
+    stats.addJitter((int32_t)(startedAt - nextShot));
+    stats.shots++;
+    if (ok) {
+      stats.bytes += bytes;
+    } else {
+      stats.failed++;
+    }
+
+    // Next slot on the fixed grid; skip slots that have already passed
+    nextShot += interval;
+    while ((int32_t)(finishedAt - nextShot) > 0) {
+      nextShot += interval;
+      stats.skipped++;
+    }
+
+    if (!unlimited) {
+      remaining--;
+      if (remaining == 0) running = false;
+    }
+  }
+
+  TimelapseStats stats;
+
+private:
+  bool running = false;
+  bool unlimited = true;
+  uint32_t interval = TimelapseConfig::DEFAULT_INTERVAL_MS;
+  uint32_t remaining = 0;
+  uint32_t nextShot = 0;
+  uint32_t leadMs = TimelapseConfig::INITIAL_LEAD_MS;
+};
+
+#endif // TIMELAPSE_H